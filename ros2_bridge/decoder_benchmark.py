@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Time the bridge's packet decoders on streams written by the tracker.
+
+Usage:
+    RealsenseBodyPoseWireBenchmark --dump packets
+    python3 decoder_benchmark.py packets
+
+Decodes every <format>_<people>.bin stream in the directory the way
+human_bridge_node.py does (json.loads, decode_binary, DeltaDecoder) and
+prints the cost per packet. The first packets of every stream are also
+decoded cut short at each length, to check truncation is reported cleanly.
+Runs without ROS: the ROS modules the node imports are stubbed.
+"""
+
+import glob
+import json
+import os
+import struct
+import sys
+import time
+import types
+
+# The node stays a single file to copy into a ROS package; give it the
+# modules it imports so its decoders load anywhere
+for name in ('rclpy', 'rclpy.node', 'visualization_msgs',
+             'visualization_msgs.msg', 'geometry_msgs', 'geometry_msgs.msg'):
+    sys.modules.setdefault(name, types.ModuleType(name))
+sys.modules['rclpy.node'].Node = object
+sys.modules['visualization_msgs.msg'].Marker = object
+sys.modules['visualization_msgs.msg'].MarkerArray = object
+sys.modules['geometry_msgs.msg'].Point = object
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import human_bridge_node as bridge  # noqa: E402
+
+RUNS = 5  # The fastest run is reported
+
+
+def read_stream(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    packets = []
+    offset = 0
+    while offset + 4 <= len(data):
+        size, = struct.unpack_from('<I', data, offset)
+        packets.append(data[offset + 4:offset + 4 + size])
+        offset += 4 + size
+    return packets
+
+
+def make_decoder(fmt):
+    if fmt == 'json':
+        return lambda packet: json.loads(packet.decode('utf-8'))
+    if fmt == 'binary':
+        return bridge.decode_binary
+    return bridge.DeltaDecoder().decode
+
+
+def time_stream(fmt, packets):
+    best = float('inf')
+    for _ in range(RUNS):
+        decode = make_decoder(fmt)
+        start = time.perf_counter()
+        for packet in packets:
+            decode(packet)
+        best = min(best, time.perf_counter() - start)
+    return best * 1e6 / max(len(packets), 1)
+
+
+def check_truncation(fmt, packets, limit=3):
+    """Return the first error other than ValueError / struct.error, or None.
+
+    The node also catches IndexError, as a last resort; the decoders are
+    meant to report every truncation as ValueError or struct.error.
+    """
+    decode = make_decoder(fmt)  # Holds the delta keyframes of the stream
+    for packet in packets[:limit]:
+        for size in range(len(packet)):
+            try:
+                decode(packet[:size])
+            except (ValueError, struct.error):
+                pass
+            except Exception as e:  # noqa: BLE001 - reported as a failure
+                return e
+        decode(packet)
+    return None
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 2
+    paths = sorted(glob.glob(os.path.join(sys.argv[1], '*.bin')),
+                   key=lambda p: (int(p.rsplit('_', 1)[1][:-4]), p))
+    if not paths:
+        print(f'No streams in {sys.argv[1]}')
+        return 2
+
+    failed = False
+    print(f'{"people":>7}  {"format":<8}{"packets":>9}{"decode us":>12}'
+          f'  truncation')
+    for path in paths:
+        fmt, people = os.path.basename(path)[:-4].rsplit('_', 1)
+        packets = read_stream(path)
+        error = check_truncation(fmt, packets)
+        failed = failed or error is not None
+        print(f'{people:>7}  {fmt:<8}{len(packets):>9}'
+              f'{time_stream(fmt, packets):>12.1f}'
+              f'  {"ok" if error is None else repr(error)}')
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -5,7 +5,191 @@ from visualization_msgs.msg import Marker, MarkerArray
 from geometry_msgs.msg import Point
 import socket
 import json
+import struct
 import threading
+import time
+from collections import deque
+
+# Binary packet (UdpSender --wire binary), see src/WireFormat.h
+WIRE_MAGIC = b'RBPS'
+WIRE_VERSION = 1
+WIRE_HEADER = struct.Struct('<4sBBBBIIq')
+WIRE_JOINT = struct.Struct('<hhhB')
+# Keyframe + delta stream (UdpSender --wire delta), see src/DeltaWireFormat.h
+DELTA_MAGIC = b'RBPD'
+DELTA_VERSION = 1
+DELTA_HEADER = struct.Struct('<4sBBBBIIqB3x')
+DELTA_PERSON = struct.Struct('<iBBB')
+DELTA_KEYFRAME = 0
+# MTU-sized fragment of a larger packet, see src/Fragmentation.h
+FRAG_MAGIC = b'RBPF'
+FRAG_VERSION = 1
+FRAG_HEADER = struct.Struct('<4sBBHHHII')
+FRAG_TIMEOUT_S = 0.1
+FRAG_MAX_PENDING = 8
+# COCO body joints (first 17 of every topology), same names as the JSON
+JOINT_NAMES = ['Nose', 'LEye', 'REye', 'LEar', 'REar', 'LShoulder',
+               'RShoulder', 'LElbow', 'RElbow', 'LWrist', 'RWrist', 'LHip',
+               'RHip', 'LKnee', 'RKnee', 'LAnkle', 'RAnkle']
+
+
+def joint_label(j):
+    return JOINT_NAMES[j] if j < len(JOINT_NAMES) else f'J{j}'
+
+
+def mask_bit(mask, j):
+    return (mask[j >> 3] >> (j & 7)) & 1
+
+
+def take(data, offset, size):
+    """Slice size bytes at offset; a packet cut short raises ValueError."""
+    if offset + size > len(data):
+        raise ValueError('truncated packet')
+    return data[offset:offset + size]
+
+
+def decode_binary(data):
+    """Decode a binary packet into the same structure as the JSON format."""
+    magic, version, joint_count, person_count, _flags, sequence, frame, \
+        timestamp_us = WIRE_HEADER.unpack_from(data, 0)
+    if magic != WIRE_MAGIC or version != WIRE_VERSION:
+        raise ValueError('not a version 1 skeleton packet')
+
+    mask_bytes = (joint_count + 7) // 8
+    offset = WIRE_HEADER.size
+    skeletons = []
+    for _ in range(person_count):
+        skel_id, confidence = struct.unpack_from('<iB', data, offset)
+        mask = take(data, offset + 5, mask_bytes)
+        offset += 5 + mask_bytes
+        joints = {}
+        for j in range(joint_count):
+            if not mask_bit(mask, j):
+                continue
+            x, y, z, conf = WIRE_JOINT.unpack_from(data, offset)
+            offset += WIRE_JOINT.size
+            joints[joint_label(j)] = {'x': x / 1000.0, 'y': y / 1000.0,
+                            'z': z / 1000.0, 'conf': conf / 255.0}
+        skeletons.append({'id': skel_id, 'confidence': confidence / 255.0,
+                          'joints': joints})
+    return {'skeletons': skeletons, 'sequence': sequence, 'frame': frame,
+            'timestamp': timestamp_us / 1000.0}
+
+
+class DeltaDecoder:
+    """Rebuild absolute joints from the keyframe + delta stream.
+
+    Keeps the last keyframe of every person in the previous packet; an
+    update whose keyframe was lost is skipped until the next keyframe.
+    """
+
+    def __init__(self):
+        self.keyframes = {}  # id -> (generation, {joint: [x, y, z, conf]})
+
+    def decode(self, data):
+        magic, version, joint_count, person_count, _flags, sequence, frame, \
+            timestamp_us, quantum = DELTA_HEADER.unpack_from(data, 0)
+        if magic != DELTA_MAGIC or version != DELTA_VERSION:
+            raise ValueError('not a version 1 delta packet')
+
+        mask_bytes = (joint_count + 7) // 8
+        offset = DELTA_HEADER.size
+        keyframes = {}
+        skeletons = []
+        for _ in range(person_count):
+            skel_id, kind, generation, confidence = \
+                DELTA_PERSON.unpack_from(data, offset)
+            offset += DELTA_PERSON.size
+            if kind == DELTA_KEYFRAME:
+                mask = take(data, offset, mask_bytes)
+                offset += mask_bytes
+                key = {}
+                for j in range(joint_count):
+                    if mask_bit(mask, j):
+                        x, y, z, conf = WIRE_JOINT.unpack_from(data, offset)
+                        offset += WIRE_JOINT.size
+                        key[j] = [x / 1000.0, y / 1000.0, z / 1000.0,
+                                  conf / 255.0]
+                points = key
+            else:
+                ox, oy, oz = struct.unpack_from('<hhh', data, offset)
+                present = take(data, offset + 6, mask_bytes)
+                mask = take(data, offset + 6 + mask_bytes, mask_bytes)
+                offset += 6 + 2 * mask_bytes
+                held = self.keyframes.get(skel_id)
+                key = held[1] if held and held[0] == generation else None
+                points = {}
+                for j in range(joint_count):
+                    dx = dy = dz = 0
+                    if mask_bit(mask, j):
+                        dx, dy, dz = struct.unpack_from('<bbb', data, offset)
+                        offset += 3
+                    if not mask_bit(present, j) or key is None:
+                        continue
+                    if j not in key:
+                        key = None
+                        continue
+                    x, y, z, conf = key[j]
+                    points[j] = [x + (ox + dx * quantum) / 1000.0,
+                                 y + (oy + dy * quantum) / 1000.0,
+                                 z + (oz + dz * quantum) / 1000.0, conf]
+                if key is None:
+                    continue
+            keyframes[skel_id] = (generation, key)
+            joints = {joint_label(j): {'x': p[0], 'y': p[1], 'z': p[2],
+                                      'conf': p[3]}
+                      for j, p in points.items()}
+            skeletons.append({'id': skel_id, 'confidence': confidence / 255.0,
+                              'joints': joints})
+        self.keyframes = keyframes  # People absent from the packet are gone
+        return {'skeletons': skeletons, 'sequence': sequence, 'frame': frame,
+                'timestamp': timestamp_us / 1000.0}
+
+
+class FragmentReassembler:
+    """Rebuild packets the sender split into fragments.
+
+    Whole datagrams pass straight through. A packet missing a fragment is
+    dropped after FRAG_TIMEOUT_S, or when too many are in progress.
+    """
+
+    def __init__(self):
+        self.pending = {}  # message id -> [first seen, total, parts]
+        self.delivered = deque(maxlen=FRAG_MAX_PENDING)  # Late duplicates
+        self.expired = 0
+
+    def add(self, datagram, now):
+        """Return the complete packet, or None while fragments are missing."""
+        if datagram[:4] != FRAG_MAGIC:
+            return datagram
+        for message_id in [m for m, p in self.pending.items()
+                           if now - p[0] > FRAG_TIMEOUT_S]:
+            del self.pending[message_id]
+            self.expired += 1
+
+        magic, version, _, index, count, _, message_id, total = \
+            FRAG_HEADER.unpack_from(datagram, 0)
+        if (version != FRAG_VERSION or index >= count
+                or message_id in self.delivered):
+            return None
+        entry = self.pending.get(message_id)
+        if entry is None:
+            if len(self.pending) >= FRAG_MAX_PENDING:
+                oldest = min(self.pending, key=lambda m: self.pending[m][0])
+                del self.pending[oldest]
+                self.expired += 1
+            entry = self.pending[message_id] = [now, total, [None] * count]
+        parts = entry[2]
+        if entry[1] != total or len(parts) != count:
+            return None
+        parts[index] = datagram[FRAG_HEADER.size:]
+        if any(part is None for part in parts):
+            return None
+        del self.pending[message_id]
+        self.delivered.append(message_id)
+        packet = b''.join(parts)
+        return packet if len(packet) == total else None
+
 
 class HumanBridgeNode(Node):
     def __init__(self):
@@ -19,6 +203,8 @@ class HumanBridgeNode(Node):
         # Start UDP listener in a separate thread
         self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
         self.sock.bind(('0.0.0.0', self.port))
+        self.reassembler = FragmentReassembler()
+        self.delta = DeltaDecoder()
         self.running = True
         self.thread = threading.Thread(target=self.udp_listener)
         self.thread.daemon = True
@@ -27,18 +213,29 @@ class HumanBridgeNode(Node):
     def udp_listener(self):
         while self.running and rclpy.ok():
             try:
-                data, addr = self.sock.recvfrom(4096)
-                json_str = data.decode('utf-8')
-                self.process_data(json_str)
+                data, addr = self.sock.recvfrom(65535)
+                packet = self.reassembler.add(data, time.monotonic())
+                if packet is not None:
+                    self.process_data(packet)
             except Exception as e:
                 self.get_logger().error(f'UDP Error: {e}')
 
-    def process_data(self, json_str):
+    def process_data(self, payload):
         try:
-            data = json.loads(json_str)
+            if payload[:4] == WIRE_MAGIC:
+                data = decode_binary(payload)
+            elif payload[:4] == DELTA_MAGIC:
+                data = self.delta.decode(payload)
+            else:
+                data = json.loads(payload.decode('utf-8'))
             skeletons = data.get('skeletons', [])
             
             marker_array = MarkerArray()
+
+            # Clear the last frame's markers, so people who left disappear
+            clear = Marker()
+            clear.action = Marker.DELETEALL
+            marker_array.markers.append(clear)
             
             for skel in skeletons:
                 skel_id = skel['id']
@@ -86,7 +283,7 @@ class HumanBridgeNode(Node):
             self.publisher_.publish(marker_array)
             # self.get_logger().info(f'Published {len(marker_array.markers)} joints')
 
-        except json.JSONDecodeError:
+        except (ValueError, IndexError, struct.error):  # Includes JSON / UTF-8 errors
             pass
 
     def destroy_node(self):
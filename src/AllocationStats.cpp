@@ -0,0 +1,265 @@
+// Allocation Stats Implementation
+
+#include "AllocationStats.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+const int kZoneCount = static_cast<int>(AllocZone::COUNT);
+
+#ifdef RBP_ALLOC_STATS
+struct ZoneCounters {
+  std::atomic<uint64_t> entries{0};
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> frees{0};
+};
+
+// Constant-initialized, so usable by allocations made during static init
+ZoneCounters g_zones[kZoneCount];
+thread_local AllocZone t_zone = AllocZone::NONE;
+#endif
+
+void formatBytes(std::ostringstream &ss, double bytes) {
+  char buffer[32];
+  if (bytes >= 1024.0 * 1024.0) {
+    std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+  } else if (bytes >= 1024.0) {
+    std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+  } else {
+    std::snprintf(buffer, sizeof(buffer), "%.0f B", bytes);
+  }
+  ss << buffer;
+}
+
+} // namespace
+
+#ifdef RBP_ALLOC_STATS
+
+AllocationZone::AllocationZone(AllocZone zone) : previous_(t_zone) {
+  t_zone = zone;
+  g_zones[static_cast<int>(zone)].entries.fetch_add(1,
+                                                    std::memory_order_relaxed);
+}
+
+AllocationZone::~AllocationZone() { t_zone = previous_; }
+
+AllocationCounters allocationCounters(AllocZone zone) {
+  const ZoneCounters &z = g_zones[static_cast<int>(zone)];
+  AllocationCounters counters;
+  counters.entries = z.entries.load(std::memory_order_relaxed);
+  counters.allocations = z.allocations.load(std::memory_order_relaxed);
+  counters.bytes = z.bytes.load(std::memory_order_relaxed);
+  counters.frees = z.frees.load(std::memory_order_relaxed);
+  return counters;
+}
+
+#else
+
+AllocationCounters allocationCounters(AllocZone) {
+  return AllocationCounters();
+}
+
+#endif
+
+std::string AllocationReport::summary() {
+  if (!kAllocationStatsEnabled) {
+    return "Heap allocations: not tracked (configure with "
+           "-DRBP_ALLOC_STATS=ON)";
+  }
+
+  std::ostringstream ss;
+  ss << "Heap per frame         allocs     frees  bytes";
+  for (int z = 0; z < kZoneCount; z++) {
+    const AllocZone zone = static_cast<AllocZone>(z);
+    const AllocationCounters now = allocationCounters(zone);
+    const AllocationCounters &before = last_[z];
+    const uint64_t entries = now.entries - before.entries;
+    const uint64_t allocations = now.allocations - before.allocations;
+    const uint64_t frees = now.frees - before.frees;
+    const uint64_t bytes = now.bytes - before.bytes;
+    last_[z] = now;
+
+    char line[80];
+    if (zone == AllocZone::NONE) {
+      if (allocations == 0 && frees == 0) {
+        continue;
+      }
+      std::snprintf(line, sizeof(line), "\n  %-18s %9llu %9llu  ",
+                    "other (total)",
+                    static_cast<unsigned long long>(allocations),
+                    static_cast<unsigned long long>(frees));
+      ss << line;
+      formatBytes(ss, static_cast<double>(bytes));
+      continue;
+    }
+    if (entries == 0) {
+      continue;
+    }
+    const double n = static_cast<double>(entries);
+    std::snprintf(line, sizeof(line), "\n  %-18s %9.1f %9.1f  ", zoneName(zone),
+                  allocations / n, frees / n);
+    ss << line;
+    formatBytes(ss, bytes / n);
+    ss << "  (n=" << entries << ")";
+  }
+  return ss.str();
+}
+
+const char *AllocationReport::zoneName(AllocZone zone) {
+  switch (zone) {
+  case AllocZone::CAPTURE:
+    return "capture";
+  case AllocZone::ESTIMATE:
+    return "estimate";
+  case AllocZone::PROJECT:
+    return "project";
+  case AllocZone::TRACK:
+    return "track";
+  case AllocZone::SEND:
+    return "send";
+  case AllocZone::RECORD:
+    return "record";
+  case AllocZone::DRAW:
+    return "draw";
+  default:
+    return "other";
+  }
+}
+
+} // namespace RealsenseBodyPose
+
+#ifdef RBP_ALLOC_STATS
+
+// ============================================
+// Counting replacements of the global allocation functions
+// ============================================
+
+namespace {
+
+using RealsenseBodyPose::g_zones;
+using RealsenseBodyPose::t_zone;
+
+void countAllocation(size_t size) {
+  auto &zone = g_zones[static_cast<int>(t_zone)];
+  zone.allocations.fetch_add(1, std::memory_order_relaxed);
+  zone.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void countFree(void *ptr) {
+  if (ptr) {
+    g_zones[static_cast<int>(t_zone)].frees.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+}
+
+void *countedMalloc(size_t size) {
+  countAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void *countedAlignedMalloc(size_t size, std::align_val_t alignment) {
+  countAllocation(size);
+  size_t align = static_cast<size_t>(alignment);
+  if (size == 0) {
+    size = 1;
+  }
+#ifdef _WIN32
+  return _aligned_malloc(size, align);
+#else
+  if (align < sizeof(void *)) {
+    align = sizeof(void *);
+  }
+  void *ptr = nullptr;
+  return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void countedFree(void *ptr) {
+  countFree(ptr);
+  std::free(ptr);
+}
+
+void countedAlignedFree(void *ptr) {
+  countFree(ptr);
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void *throwIfNull(void *ptr) {
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+void *operator new(size_t size) { return throwIfNull(countedMalloc(size)); }
+void *operator new[](size_t size) { return throwIfNull(countedMalloc(size)); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return countedMalloc(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return countedMalloc(size);
+}
+void *operator new(size_t size, std::align_val_t alignment) {
+  return throwIfNull(countedAlignedMalloc(size, alignment));
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+  return throwIfNull(countedAlignedMalloc(size, alignment));
+}
+void *operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  return countedAlignedMalloc(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  return countedAlignedMalloc(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  countedFree(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  countedFree(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  countedAlignedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  countedAlignedFree(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  countedAlignedFree(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  countedAlignedFree(ptr);
+}
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  countedAlignedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  countedAlignedFree(ptr);
+}
+
+#endif // RBP_ALLOC_STATS
@@ -0,0 +1,96 @@
+// Opt-in heap allocation counters attributed to pipeline stages
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Pipeline stage that heap allocations are charged to
+ *
+ * NONE collects everything that happens outside an AllocationZone.
+ */
+enum class AllocZone {
+  NONE,
+  CAPTURE,  // FrameSource::captureFrames
+  ESTIMATE, // PoseEstimator::estimate
+  PROJECT,  // SkeletonProjector::project
+  TRACK,    // PoseTracker::update
+  SEND,     // UdpSender::send
+  RECORD,   // DataRecorder::record
+  DRAW,     // Visualizer::draw
+  COUNT
+};
+
+#ifdef RBP_ALLOC_STATS
+const bool kAllocationStatsEnabled = true;
+#else
+const bool kAllocationStatsEnabled = false;
+#endif
+
+/**
+ * @brief Cumulative counters of one zone since start-up
+ */
+struct AllocationCounters {
+  uint64_t entries = 0;     // Times the zone was entered
+  uint64_t allocations = 0; // operator new calls
+  uint64_t bytes = 0;       // Bytes requested from operator new
+  uint64_t frees = 0;       // operator delete calls
+};
+
+/**
+ * @brief Read the counters of one zone
+ *
+ * All zero unless built with RBP_ALLOC_STATS.
+ */
+AllocationCounters allocationCounters(AllocZone zone);
+
+/**
+ * @brief Charge heap allocations on this thread to a stage while in scope
+ *
+ * With RBP_ALLOC_STATS defined the global operator new / delete are
+ * replaced by counting versions and the current zone is tracked per
+ * thread, so stages running concurrently on different threads are kept
+ * apart. Zones nest: the previous zone is restored on destruction.
+ * Without the define this is an empty object and costs nothing.
+ */
+class AllocationZone {
+public:
+#ifdef RBP_ALLOC_STATS
+  explicit AllocationZone(AllocZone zone);
+  ~AllocationZone();
+#else
+  explicit AllocationZone(AllocZone) {}
+#endif
+
+  AllocationZone(const AllocationZone &) = delete;
+  AllocationZone &operator=(const AllocationZone &) = delete;
+
+#ifdef RBP_ALLOC_STATS
+private:
+  AllocZone previous_;
+#endif
+};
+
+/**
+ * @brief Formats per-stage allocation rates for the periodic stats log
+ */
+class AllocationReport {
+public:
+  /**
+   * @brief Allocations and bytes per zone entry since the previous call
+   *
+   * Every stage enters its zone once per frame, so the averages are per
+   * frame. Allocations outside any zone are reported as totals.
+   */
+  std::string summary();
+
+private:
+  AllocationCounters last_[static_cast<int>(AllocZone::COUNT)];
+
+  static const char *zoneName(AllocZone zone);
+};
+
+} // namespace RealsenseBodyPose
@@ -1,16 +1,25 @@
 #include "DataRecorder.h"
+#include <cstdio>
 #include <ctime>
-#include <direct.h> // For _mkdir on Windows
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
+#ifdef _WIN32
+#include <direct.h> // For _mkdir on Windows
+#else
+#include <sys/stat.h>
+#endif
 
 namespace RealsenseBodyPose {
 
 DataRecorder::DataRecorder() : isRecording_(false), frameCount_(0) {
   // Ensure recordings directory exists
+#ifdef _WIN32
   _mkdir("recordings");
+#else
+  mkdir("recordings", 0755);
+#endif
 }
 
 DataRecorder::~DataRecorder() { stop(); }
@@ -33,14 +42,15 @@ bool DataRecorder::start() {
   }
 
   // Write CSV Header
-  file_ << "Timestamp,FrameIndex,PersonID,Confidence,";
-  // 17 Keypoints * (X, Y, Z, Conf)
-  for (int i = 0; i < 17; i++) {
+  file_ << "Timestamp,FrameIndex,FrameNumber,SensorTimestampMs,"
+           "CaptureLatencyMs,PersonID,Confidence,";
+  // kNumJoints Keypoints * (X, Y, Z, Conf)
+  for (int i = 0; i < kNumJoints; i++) {
     file_ << "J" << i << "_X,"
           << "J" << i << "_Y,"
           << "J" << i << "_Z,"
           << "J" << i << "_Conf";
-    if (i < 16)
+    if (i < kNumJoints - 1)
       file_ << ",";
   }
   file_ << "\n";
@@ -65,7 +75,8 @@ void DataRecorder::stop() {
 
 bool DataRecorder::isRecording() const { return isRecording_; }
 
-void DataRecorder::record(const std::vector<Skeleton> &skeletons) {
+void DataRecorder::record(const SkeletonBatch &skeletons,
+                          const FrameInfo *info) {
   std::lock_guard<std::mutex> lock(mutex_);
 
   if (!isRecording_ || !file_.is_open()) {
@@ -77,19 +88,26 @@ void DataRecorder::record(const std::vector<Skeleton> &skeletons) {
                        now.time_since_epoch())
                        .count();
 
-  for (size_t i = 0; i < skeletons.size(); i++) {
-    const auto &skel = skeletons[i];
+  // Lineage columns: empty when the caller has no frame info
+  char lineage[96] = ",,";
+  if (info) {
+    std::snprintf(lineage, sizeof(lineage), "%llu,%.3f,%.3f", info->frameNumber,
+                  info->sensorTimestampMs,
+                  (monotonicNowNs() - info->captureNs) / 1e6);
+  }
+
+  for (int i = 0; i < skeletons.size(); i++) {
+    const SkeletonView skel = skeletons[i];
 
-    file_ << timestamp << "," << frameCount_ << "," << i
-          << "," // Person ID (just index for now)
-          << std::fixed << std::setprecision(4) << skel.overallConfidence
-          << ",";
+    file_ << timestamp << "," << frameCount_ << "," << lineage << ","
+          << skel.publicId() << "," // Person ID (track ID, or index)
+          << std::fixed << std::setprecision(4) << skel.confidence() << ",";
 
     // Write 3D keypoints
-    for (size_t k = 0; k < skel.keypoints3D.size(); k++) {
-      const auto &kp = skel.keypoints3D[k];
+    for (int k = 0; k < kNumJoints; k++) {
+      const Keypoint3D kp = skel.keypoint3D(k);
       file_ << kp.x << "," << kp.y << "," << kp.z << "," << kp.confidence;
-      if (k < skel.keypoints3D.size() - 1)
+      if (k < kNumJoints - 1)
         file_ << ",";
     }
     file_ << "\n";
@@ -102,7 +120,11 @@ std::string DataRecorder::getTimestampString() const {
   auto now = std::chrono::system_clock::now();
   std::time_t now_c = std::chrono::system_clock::to_time_t(now);
   std::tm now_tm;
+#ifdef _WIN32
   localtime_s(&now_tm, &now_c);
+#else
+  localtime_r(&now_c, &now_tm);
+#endif
 
   std::stringstream ss;
   ss << std::put_time(&now_tm, "%Y%m%d_%H%M%S");
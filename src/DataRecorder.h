@@ -1,6 +1,8 @@
 #pragma once
 
+#include "SkeletonBatch.h"
 #include "Utils.h"
+#include <atomic>
 #include <fstream>
 #include <mutex>
 #include <string>
@@ -32,15 +34,17 @@ public:
   void stop();
 
   /**
-   * @brief Check if currently recording
+   * @brief Check if currently recording (safe to call from any thread)
    */
   bool isRecording() const;
 
   /**
    * @brief Record a frame of skeletal data
    * @param skeletons Vector of detected skeletons
+   * @param info Frame lineage (frame number, device timestamp, capture time)
    */
-  void record(const std::vector<Skeleton> &skeletons);
+  void record(const SkeletonBatch &skeletons,
+              const FrameInfo *info = nullptr);
 
   /**
    * @brief Get current file path
@@ -49,7 +53,7 @@ public:
 
 private:
   std::ofstream file_;
-  bool isRecording_;
+  std::atomic<bool> isRecording_;
   std::string currentFilePath_;
   std::mutex mutex_;
   long long frameCount_;
@@ -0,0 +1,452 @@
+// Delta Wire Format Implementation
+
+#include "DeltaWireFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+inline uint8_t *put16(uint8_t *p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  return p + 2;
+}
+
+inline uint8_t *put32(uint8_t *p, uint32_t v) {
+  p = put16(p, static_cast<uint16_t>(v));
+  return put16(p, static_cast<uint16_t>(v >> 16));
+}
+
+inline uint8_t *put64(uint8_t *p, uint64_t v) {
+  p = put32(p, static_cast<uint32_t>(v));
+  return put32(p, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint16_t get16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t *p) {
+  return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+inline uint64_t get64(const uint8_t *p) {
+  return get32(p) | (static_cast<uint64_t>(get32(p + 4)) << 32);
+}
+
+// Meters -> millimetres, saturated to int16 (as WireFormat.cpp)
+inline int16_t quantizeMm(float meters) {
+  float mm = std::round(meters * 1000.0f);
+  return static_cast<int16_t>(std::min(32767.0f, std::max(-32768.0f, mm)));
+}
+
+inline uint8_t quantizeUnit(float value) {
+  float scaled = std::round(value * 255.0f);
+  return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, scaled)));
+}
+
+// Rounded division that is symmetric around zero
+inline int divRound(int value, int quantum) {
+  return value >= 0 ? (value + quantum / 2) / quantum
+                    : -((-value + quantum / 2) / quantum);
+}
+
+} // namespace
+
+DeltaWireEncoder::DeltaWireEncoder(const Config &config)
+    : m_config(config), m_lastCount(0), m_lastSentNs(0), m_started(false) {
+  m_config.keyframeInterval = std::max(m_config.keyframeInterval, 1);
+  m_config.quantumMm = std::min(std::max(m_config.quantumMm, 1), 255);
+}
+
+void DeltaWireEncoder::reset() {
+  for (Track &track : m_tracks) {
+    track.used = false;
+  }
+  m_lastCount = 0;
+  m_started = false;
+}
+
+DeltaWireEncoder::Track *DeltaWireEncoder::findTrack(int32_t id) {
+  for (Track &track : m_tracks) {
+    if (track.used && track.id == id) {
+      return &track;
+    }
+  }
+  return nullptr;
+}
+
+size_t DeltaWireEncoder::encode(const SkeletonBatch &skeletons,
+                                uint32_t sequence, const FrameInfo *info,
+                                int64_t nowNs, uint8_t *out, size_t capacity,
+                                const JointMask<kNumJoints> *joints) {
+  const uint64_t frame = ++m_stats.frames;
+  if (capacity < kDeltaWireHeaderBytes) {
+    return 0;
+  }
+  uint8_t *const end = out + capacity;
+  const int quantum = m_config.quantumMm;
+
+  uint8_t *p = put32(out, kDeltaWireMagic);
+  *p++ = kDeltaWireVersion;
+  *p++ = static_cast<uint8_t>(kNumJoints);
+  *p++ = static_cast<uint8_t>(skeletons.size());
+  uint8_t *const flags = p++;
+  *flags = 0;
+  p = put32(p, sequence);
+  p = put32(p, info ? static_cast<uint32_t>(info->frameNumber) : 0);
+  p = put64(p, info ? static_cast<uint64_t>(static_cast<int64_t>(
+                          std::llround(info->sensorTimestampMs * 1000.0)))
+                    : 0);
+  *p++ = static_cast<uint8_t>(quantum);
+  *p++ = 0;
+  *p++ = 0;
+  *p++ = 0;
+
+  // A new set of people must reach the receiver, which drops anyone absent
+  bool changed = !m_started || skeletons.size() != m_lastCount;
+  size_t keyframes = 0, updates = 0;
+
+  for (int i = 0; i < skeletons.size(); i++) {
+    const SkeletonView skel = skeletons[i];
+    const int32_t id = skel.publicId();
+    if (static_cast<size_t>(end - p) <
+        kDeltaPersonHeaderBytes + kDeltaOffsetBytes + kWireMaskBytes) {
+      reset(); // Tracks were updated for a packet that is not sent
+      return 0;
+    }
+    changed = changed || m_lastIds[i] != id;
+
+    // Joints sent this frame, in millimetres
+    JointMask<kNumJoints> mask;
+    int16_t mm[kNumJoints][3];
+    for (int j = 0; j < kNumJoints; j++) {
+      if (!skel.hasKeypoint3D(j) || (joints && !joints->test(j))) {
+        continue;
+      }
+      const Keypoint3D k3d = skel.keypoint3D(j);
+      if (!k3d.isValid()) {
+        continue;
+      }
+      mask.set(j);
+      mm[j][0] = quantizeMm(k3d.x);
+      mm[j][1] = quantizeMm(k3d.y);
+      mm[j][2] = quantizeMm(k3d.z);
+    }
+
+    // A track missing from the last frame was dropped by the receiver.
+    // Joints may drop out of an update, but a new one needs a keyframe
+    Track *track = findTrack(id);
+    JointMask<kNumJoints> known = mask;
+    if (track) {
+      known &= track->mask;
+    }
+    bool keyframe = !track || track->lastFrame + 1 != frame ||
+                    track->sinceKeyframe + 1 >= m_config.keyframeInterval ||
+                    !(known == mask);
+
+    // Whole-person offset from the keyframe (mean joint displacement), so a
+    // walking person needs small residuals; held while it moves less than
+    // epsilon
+    int offset[3] = {0, 0, 0};
+    if (!keyframe) {
+      int sum[3] = {0, 0, 0};
+      int count = 0;
+      for (int j = 0; j < kNumJoints; j++) {
+        if (mask.test(j)) {
+          for (int a = 0; a < 3; a++) {
+            sum[a] += mm[j][a] - track->key[j][a];
+          }
+          count++;
+        }
+      }
+      bool moved = false;
+      for (int a = 0; a < 3; a++) {
+        offset[a] = count > 0 ? divRound(sum[a], count) : 0;
+        moved = moved ||
+                std::abs(offset[a] - track->offset[a]) > m_config.epsilonMm;
+      }
+      for (int a = 0; a < 3; a++) {
+        offset[a] = moved ? offset[a] : track->offset[a];
+        keyframe = keyframe || offset[a] < -32768 || offset[a] > 32767;
+      }
+    }
+
+    // Residuals in quanta. A joint within epsilon of keyframe + offset is
+    // sent as zero, one within epsilon of its last value keeps it, so noise
+    // on a still joint changes nothing
+    int8_t delta[kNumJoints][3];
+    for (int j = 0; j < kNumJoints && !keyframe; j++) {
+      if (!mask.test(j)) {
+        continue;
+      }
+      int base[3];
+      bool nearBase = true, nearSent = true;
+      for (int a = 0; a < 3; a++) {
+        base[a] = track->key[j][a] + offset[a];
+        nearBase = nearBase &&
+                   std::abs(mm[j][a] - base[a]) <= m_config.epsilonMm;
+        nearSent = nearSent && std::abs(mm[j][a] - track->sent[j][a]) <=
+                                   m_config.epsilonMm;
+      }
+      for (int a = 0; a < 3; a++) {
+        const int value = nearBase   ? base[a]
+                          : nearSent ? track->sent[j][a]
+                                     : mm[j][a];
+        const int d = divRound(value - base[a], quantum);
+        if (d < -127 || d > 127) {
+          keyframe = true; // Moved too far from the keyframe
+          break;
+        }
+        delta[j][a] = static_cast<int8_t>(d);
+      }
+    }
+
+    p = put32(p, static_cast<uint32_t>(id));
+    if (keyframe) {
+      if (!track) {
+        // Reuse a free entry, else the one unseen the longest
+        track = &m_tracks[0];
+        for (Track &candidate : m_tracks) {
+          if (!candidate.used) {
+            track = &candidate;
+            break;
+          }
+          if (candidate.lastFrame < track->lastFrame) {
+            track = &candidate;
+          }
+        }
+        track->used = true;
+        track->id = id;
+      }
+      track->generation++;
+      track->sinceKeyframe = 0;
+      track->mask = track->present = mask;
+      track->offset[0] = track->offset[1] = track->offset[2] = 0;
+
+      *p++ = kDeltaKeyframe;
+      *p++ = track->generation;
+      *p++ = quantizeUnit(skel.confidence());
+      uint8_t *jointMask = p;
+      std::memset(jointMask, 0, kWireMaskBytes);
+      p += kWireMaskBytes;
+      for (int j = 0; j < kNumJoints; j++) {
+        if (!mask.test(j)) {
+          continue;
+        }
+        if (static_cast<size_t>(end - p) < kWireJointBytes) {
+          reset();
+          return 0;
+        }
+        jointMask[j >> 3] |= static_cast<uint8_t>(1u << (j & 7));
+        for (int a = 0; a < 3; a++) {
+          track->key[j][a] = track->sent[j][a] = mm[j][a];
+          p = put16(p, static_cast<uint16_t>(mm[j][a]));
+        }
+        *p++ = quantizeUnit(skel.keypoint3D(j).confidence);
+      }
+      changed = true;
+      keyframes++;
+    } else {
+      track->sinceKeyframe++;
+      *p++ = kDeltaUpdate;
+      *p++ = track->generation;
+      *p++ = quantizeUnit(skel.confidence());
+      for (int a = 0; a < 3; a++) {
+        changed = changed || offset[a] != track->offset[a];
+        track->offset[a] = static_cast<int16_t>(offset[a]);
+        p = put16(p, static_cast<uint16_t>(offset[a]));
+      }
+      uint8_t *presentMask = p;
+      std::memset(presentMask, 0, kWireMaskBytes);
+      p += kWireMaskBytes;
+      for (int j = 0; j < kNumJoints; j++) {
+        if (mask.test(j)) {
+          presentMask[j >> 3] |= static_cast<uint8_t>(1u << (j & 7));
+        }
+      }
+      changed = changed || !(track->present == mask);
+      track->present = mask;
+
+      uint8_t *jointMask = p;
+      std::memset(jointMask, 0, kWireMaskBytes);
+      p += kWireMaskBytes;
+      for (int j = 0; j < kNumJoints; j++) {
+        if (!mask.test(j)) {
+          continue;
+        }
+        for (int a = 0; a < 3; a++) {
+          const int16_t sent = static_cast<int16_t>(
+              track->key[j][a] + offset[a] + delta[j][a] * quantum);
+          changed = changed || sent != track->sent[j][a];
+          track->sent[j][a] = sent;
+        }
+        if (delta[j][0] == 0 && delta[j][1] == 0 && delta[j][2] == 0) {
+          continue; // At keyframe + offset
+        }
+        if (static_cast<size_t>(end - p) < kDeltaJointBytes) {
+          reset();
+          return 0;
+        }
+        jointMask[j >> 3] |= static_cast<uint8_t>(1u << (j & 7));
+        for (int a = 0; a < 3; a++) {
+          *p++ = static_cast<uint8_t>(delta[j][a]);
+        }
+      }
+      updates++;
+    }
+    track->lastFrame = frame;
+    m_lastIds[i] = id;
+  }
+  m_lastCount = skeletons.size();
+
+  // Nothing new: stay silent until the heartbeat is due
+  const int64_t heartbeatNs =
+      static_cast<int64_t>(m_config.heartbeatMs) * 1000000;
+  if (!changed) {
+    if (nowNs - m_lastSentNs < heartbeatNs) {
+      m_stats.suppressed++;
+      return 0;
+    }
+    *flags |= kDeltaFlagHeartbeat;
+    m_stats.heartbeats++;
+  }
+
+  m_started = true;
+  m_lastSentNs = nowNs;
+  const size_t size = static_cast<size_t>(p - out);
+  m_stats.packets++;
+  m_stats.keyframes += keyframes;
+  m_stats.updates += updates;
+  m_stats.bytes += size;
+  return size;
+}
+
+bool DeltaWireDecoder::decode(const uint8_t *data, size_t size,
+                              WirePacket &packet) {
+  if (size < kDeltaWireHeaderBytes || get32(data) != kDeltaWireMagic ||
+      data[4] != kDeltaWireVersion) {
+    return false;
+  }
+
+  packet.version = data[4];
+  packet.jointCount = data[5];
+  const int personCount = data[6];
+  packet.sequence = get32(data + 8);
+  packet.frameNumber = get32(data + 12);
+  packet.timestampUs = static_cast<int64_t>(get64(data + 16));
+  const int quantum = data[24];
+  packet.people.clear();
+
+  const size_t maskBytes = (packet.jointCount + 7) / 8;
+  const uint8_t *p = data + kDeltaWireHeaderBytes;
+  const uint8_t *const end = data + size;
+  std::vector<Track> tracks;
+
+  for (int i = 0; i < personCount; i++) {
+    if (static_cast<size_t>(end - p) < 7) {
+      return false;
+    }
+    const int32_t id = static_cast<int32_t>(get32(p));
+    const uint8_t kind = p[4];
+    const uint8_t generation = p[5];
+    WirePerson person;
+    person.id = id;
+    person.confidence = p[6] / 255.0f;
+    p += 7;
+
+    if (kind == kDeltaKeyframe) {
+      if (static_cast<size_t>(end - p) < maskBytes) {
+        return false;
+      }
+      const uint8_t *mask = p;
+      p += maskBytes;
+      for (int j = 0; j < packet.jointCount; j++) {
+        if (!((mask[j >> 3] >> (j & 7)) & 1u)) {
+          continue;
+        }
+        if (static_cast<size_t>(end - p) < kWireJointBytes) {
+          return false;
+        }
+        WireJoint joint;
+        joint.joint = j;
+        joint.x = static_cast<int16_t>(get16(p)) / 1000.0f;
+        joint.y = static_cast<int16_t>(get16(p + 2)) / 1000.0f;
+        joint.z = static_cast<int16_t>(get16(p + 4)) / 1000.0f;
+        joint.confidence = p[6] / 255.0f;
+        person.joints.push_back(joint);
+        p += kWireJointBytes;
+      }
+      tracks.push_back({id, generation, person.joints});
+      packet.people.push_back(person);
+      continue;
+    }
+
+    // Update: offset, present joints, residuals against the keyframe
+    if (static_cast<size_t>(end - p) < kDeltaOffsetBytes + 2 * maskBytes) {
+      return false;
+    }
+    float offset[3];
+    for (int a = 0; a < 3; a++) {
+      offset[a] = static_cast<int16_t>(get16(p + 2 * a)) / 1000.0f;
+    }
+    const uint8_t *present = p + kDeltaOffsetBytes;
+    const uint8_t *mask = present + maskBytes;
+    p += kDeltaOffsetBytes + 2 * maskBytes;
+
+    const Track *key = nullptr;
+    for (const Track &track : m_tracks) {
+      if (track.id == id && track.generation == generation) {
+        key = &track;
+      }
+    }
+    bool synced = key != nullptr;
+    size_t next = 0; // Keyframe joint matched to bit j
+    for (int j = 0; j < packet.jointCount; j++) {
+      const bool isPresent = (present[j >> 3] >> (j & 7)) & 1u;
+      const bool moved = (mask[j >> 3] >> (j & 7)) & 1u;
+      if (moved && static_cast<size_t>(end - p) < kDeltaJointBytes) {
+        return false;
+      }
+      if (!isPresent || !synced) {
+        p += moved ? kDeltaJointBytes : 0;
+        continue;
+      }
+      while (next < key->joints.size() && key->joints[next].joint < j) {
+        next++;
+      }
+      if (next == key->joints.size() || key->joints[next].joint != j) {
+        synced = false; // Not in the keyframe we hold
+        p += moved ? kDeltaJointBytes : 0;
+        continue;
+      }
+      WireJoint joint = key->joints[next];
+      joint.x += offset[0];
+      joint.y += offset[1];
+      joint.z += offset[2];
+      if (moved) {
+        joint.x += static_cast<int8_t>(p[0]) * quantum / 1000.0f;
+        joint.y += static_cast<int8_t>(p[1]) * quantum / 1000.0f;
+        joint.z += static_cast<int8_t>(p[2]) * quantum / 1000.0f;
+        p += kDeltaJointBytes;
+      }
+      person.joints.push_back(joint);
+    }
+    if (!synced) {
+      m_unsynced++;
+      continue;
+    }
+    tracks.push_back(*key);
+    packet.people.push_back(person);
+  }
+
+  // People absent from the packet are gone
+  m_tracks.swap(tracks);
+  return true;
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,188 @@
+// Keyframe + delta skeleton stream (stateful binary packets)
+
+#pragma once
+
+#include "SkeletonBatch.h"
+#include "WireFormat.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/*
+ * A stream of packets in which each tracked person is sent as a keyframe
+ * (absolute joints, as in WireFormat.h) and then as deltas from that
+ * keyframe. Deltas are always taken from the keyframe, never from the
+ * previous packet, so losing a delta costs nothing and losing a keyframe
+ * costs at most keyframeInterval frames for that person.
+ *
+ * All fields little-endian, no padding:
+ *
+ *   Header (28 bytes)
+ *     uint32  magic          'R' 'B' 'P' 'D'
+ *     uint8   version        kDeltaWireVersion
+ *     uint8   jointCount     Joints per person in this topology
+ *     uint8   personCount
+ *     uint8   flags          kDeltaFlagHeartbeat: nothing changed, sent to
+ *                            show the stream is alive
+ *     uint32  sequence       As in WireFormat.h
+ *     uint32  frameNumber    Low 32 bits of FrameInfo::frameNumber
+ *     int64   timestampUs    Device timestamp (FrameInfo::sensorTimestampMs)
+ *     uint8   quantumMm      Delta unit in millimetres
+ *     uint8   reserved[3]    0
+ *
+ *   Per person
+ *     int32   id             Track id, or index in the frame when untracked
+ *     uint8   kind           kDeltaKeyframe or kDeltaUpdate
+ *     uint8   generation     Keyframe counter for this id, wraps
+ *     uint8   confidence     Detection score * 255
+ *     Keyframe:
+ *       uint8 mask[(jointCount + 7) / 8]
+ *                            Joints with a 3D point; per set bit (7 bytes)
+ *       int16 x, y, z        Millimetres, camera frame
+ *       uint8 confidence     Keypoint confidence * 255
+ *     Update:
+ *       int16 ox, oy, oz     Offset of the whole person from the keyframe,
+ *                            millimetres
+ *       uint8 present[(jointCount + 7) / 8]
+ *                            Joints with a 3D point, a subset of the
+ *                            keyframe's
+ *       uint8 mask[(jointCount + 7) / 8]
+ *                            Joints not at keyframe + offset; per set bit
+ *       int8  dx, dy, dz     Residual in quantumMm units
+ *
+ * A joint present in an update is at its keyframe position + offset +
+ * residual (zero when its mask bit is clear). Receivers apply an update
+ * only when they hold the keyframe with the same generation, and drop
+ * people that are not in the packet.
+ */
+const uint32_t kDeltaWireMagic = 0x44504252; // "RBPD" on the wire
+const uint8_t kDeltaWireVersion = 1;
+const size_t kDeltaWireHeaderBytes = 28;
+const size_t kDeltaPersonHeaderBytes = 7 + kWireMaskBytes;
+const size_t kDeltaOffsetBytes = 6;
+const size_t kDeltaJointBytes = 3;
+
+const uint8_t kDeltaFlagHeartbeat = 0x01;
+const uint8_t kDeltaKeyframe = 0;
+const uint8_t kDeltaUpdate = 1;
+
+// Largest packet a full batch can produce (every person a keyframe)
+const size_t kDeltaMaxPacketBytes =
+    kDeltaWireHeaderBytes +
+    kMaxPeople * (kDeltaPersonHeaderBytes + kNumJoints * kWireJointBytes);
+
+/**
+ * @brief Sender side of the delta stream
+ *
+ * Keeps what the receiver was last sent for every recently seen track in a
+ * fixed table, so encoding never allocates. A person gets a keyframe when
+ * first seen, every keyframeInterval frames, when a joint missing from its
+ * keyframe becomes valid, or when a residual no longer fits in int8. A
+ * joint within epsilonMm of where the receiver already has it is not moved,
+ * so sensor noise on a still person produces no change; when no person
+ * changed and the people are the same, the frame is not sent at all until
+ * heartbeatMs has passed.
+ *
+ * One instance per stream: every receiver of its packets must see the same
+ * sequence of frames (a rate-limited subscriber needs its own encoder).
+ */
+class DeltaWireEncoder {
+public:
+  struct Config {
+    int keyframeInterval = 60; // Frames between keyframes of a person
+    float epsilonMm = 5.0f;    // Joint moves smaller than this are not sent
+    int quantumMm = 2;         // Delta resolution, 1..255
+    int heartbeatMs = 200;     // Longest silence while nothing changes
+    Config() {}
+  };
+
+  /**
+   * @brief Counters since construction
+   */
+  struct Stats {
+    size_t frames = 0;     // encode() calls
+    size_t packets = 0;    // Packets produced (including heartbeats)
+    size_t heartbeats = 0; // Packets sent only to show the stream is alive
+    size_t suppressed = 0; // Frames with nothing new, not sent
+    size_t keyframes = 0;  // Person keyframes
+    size_t updates = 0;    // Person delta records
+    size_t bytes = 0;      // Total packet bytes
+  };
+
+  explicit DeltaWireEncoder(const Config &config = Config());
+
+  /**
+   * @brief Encode a frame against the stream state
+   * @param nowNs Monotonic time of the frame, for the heartbeat
+   * @param joints Only send joints in this subset, or nullptr for all
+   * @return Bytes written, or 0 if the frame is suppressed (nothing changed)
+   *         or does not fit (kDeltaMaxPacketBytes always suffices)
+   */
+  size_t encode(const SkeletonBatch &skeletons, uint32_t sequence,
+                const FrameInfo *info, int64_t nowNs, uint8_t *out,
+                size_t capacity, const JointMask<kNumJoints> *joints = nullptr);
+
+  // Forget every track, so the next frame is all keyframes
+  void reset();
+
+  const Stats &stats() const { return m_stats; }
+
+private:
+  // What the receiver holds for one track
+  struct Track {
+    bool used = false;
+    int32_t id = 0;
+    uint8_t generation = 0;
+    int sinceKeyframe = 0;
+    uint64_t lastFrame = 0; // m_stats.frames when last seen
+    JointMask<kNumJoints> mask;    // Joints in the keyframe
+    JointMask<kNumJoints> present; // Joints in the last record
+    int16_t key[kNumJoints][3];  // Keyframe position, mm
+    int16_t sent[kNumJoints][3]; // Position the receiver holds, mm
+    int16_t offset[3];           // Whole-person offset last sent, mm
+  };
+
+  Track *findTrack(int32_t id);
+
+  Config m_config;
+  Track m_tracks[2 * kMaxPeople];
+  int32_t m_lastIds[kMaxPeople]; // People in the last frame
+  int m_lastCount;
+  int64_t m_lastSentNs;
+  bool m_started;
+  Stats m_stats;
+};
+
+/**
+ * @brief Reference receiver for DeltaWireEncoder
+ *
+ * Not used on the hot path; documents the format for receivers, rebuilds
+ * absolute joints for tests and the report tool.
+ */
+class DeltaWireDecoder {
+public:
+  /**
+   * @brief Apply one packet
+   * @param packet The people known after this packet (updates without
+   *        their keyframe are left out)
+   * @return false if the data is truncated or not a version 1 packet
+   */
+  bool decode(const uint8_t *data, size_t size, WirePacket &packet);
+
+  // People dropped because their keyframe was missing
+  size_t unsynced() const { return m_unsynced; }
+
+private:
+  struct Track {
+    int32_t id;
+    uint8_t generation;
+    std::vector<WireJoint> joints; // Keyframe, valid joints in order
+  };
+
+  std::vector<Track> m_tracks;
+  size_t m_unsynced = 0;
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,128 @@
+// Deprojection Table Implementation
+
+#include "DeprojectionTable.h"
+#include <algorithm>
+#include <librealsense2/rsutil.h>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Brown-Conrady family with every coefficient zero reduces to a pinhole
+bool isPinhole(const rs2_intrinsics &intrinsics) {
+  if (intrinsics.model == RS2_DISTORTION_NONE) {
+    return true;
+  }
+  if (intrinsics.model != RS2_DISTORTION_BROWN_CONRADY &&
+      intrinsics.model != RS2_DISTORTION_INVERSE_BROWN_CONRADY &&
+      intrinsics.model != RS2_DISTORTION_MODIFIED_BROWN_CONRADY) {
+    return false;
+  }
+  for (float coeff : intrinsics.coeffs) {
+    if (coeff != 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+DeprojectionTable::DeprojectionTable()
+    : intrinsics_(), pinhole_(true), gridW_(0), gridH_(0), tilesX_(0),
+      tilesY_(0), builtTiles_(0) {}
+
+DeprojectionTable::DeprojectionTable(const rs2_intrinsics &intrinsics)
+    : DeprojectionTable() {
+  reset(intrinsics);
+}
+
+void DeprojectionTable::reset(const rs2_intrinsics &intrinsics) {
+  intrinsics_ = intrinsics;
+  pinhole_ = isPinhole(intrinsics);
+  builtTiles_ = 0;
+  tiles_.clear();
+
+  if (pinhole_ || intrinsics.width <= 0 || intrinsics.height <= 0) {
+    gridW_ = gridH_ = tilesX_ = tilesY_ = 0;
+    return;
+  }
+
+  gridW_ = intrinsics.width + 1;
+  gridH_ = intrinsics.height + 1;
+  tilesX_ = (gridW_ + kTileSize - 1) / kTileSize;
+  tilesY_ = (gridH_ + kTileSize - 1) / kTileSize;
+  tiles_.resize(static_cast<size_t>(tilesX_) * tilesY_);
+}
+
+void DeprojectionTable::directRay(const float pixel[2], float ray[2]) const {
+  if (pinhole_) {
+    ray[0] = (pixel[0] - intrinsics_.ppx) / intrinsics_.fx;
+    ray[1] = (pixel[1] - intrinsics_.ppy) / intrinsics_.fy;
+    return;
+  }
+  float point[3];
+  rs2_deproject_pixel_to_point(point, &intrinsics_, pixel, 1.0f);
+  ray[0] = point[0];
+  ray[1] = point[1];
+}
+
+void DeprojectionTable::buildTile(int tx, int ty) {
+  const int x0 = tx * kTileSize;
+  const int y0 = ty * kTileSize;
+  const int x1 = std::min(x0 + kTileSize, gridW_);
+  const int y1 = std::min(y0 + kTileSize, gridH_);
+
+  std::unique_ptr<float[]> &tile =
+      tiles_[static_cast<size_t>(ty) * tilesX_ + tx];
+  tile.reset(new float[kTileSize * kTileSize * 2]);
+  for (int gy = y0; gy < y1; gy++) {
+    float *row = tile.get() + (gy - y0) * kTileSize * 2;
+    for (int gx = x0; gx < x1; gx++) {
+      float pixel[2] = {static_cast<float>(gx), static_cast<float>(gy)};
+      directRay(pixel, row + (gx - x0) * 2);
+    }
+  }
+  builtTiles_++;
+}
+
+const float *DeprojectionTable::rayAt(int gx, int gy) {
+  const int tx = gx / kTileSize;
+  const int ty = gy / kTileSize;
+  const float *tile = tiles_[static_cast<size_t>(ty) * tilesX_ + tx].get();
+  if (!tile) {
+    buildTile(tx, ty);
+    tile = tiles_[static_cast<size_t>(ty) * tilesX_ + tx].get();
+  }
+  return tile + ((gy - ty * kTileSize) * kTileSize + gx - tx * kTileSize) * 2;
+}
+
+void DeprojectionTable::ray(const float pixel[2], float ray[2]) {
+  const float u = pixel[0];
+  const float v = pixel[1];
+
+  // Written so NaN coordinates also take the direct path
+  if (tiles_.empty() || !(u >= 0.0f && v >= 0.0f && u < gridW_ - 1 &&
+                   v < gridH_ - 1)) {
+    directRay(pixel, ray);
+    return;
+  }
+
+  const int x0 = static_cast<int>(u);
+  const int y0 = static_cast<int>(v);
+  const float fx = u - x0;
+  const float fy = v - y0;
+
+  const float *r00 = rayAt(x0, y0);
+  const float *r10 = rayAt(x0 + 1, y0);
+  const float *r01 = rayAt(x0, y0 + 1);
+  const float *r11 = rayAt(x0 + 1, y0 + 1);
+
+  for (int c = 0; c < 2; c++) {
+    float top = r00[c] + (r10[c] - r00[c]) * fx;
+    float bottom = r01[c] + (r11[c] - r01[c]) * fx;
+    ray[c] = top + (bottom - top) * fy;
+  }
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,85 @@
+// Cached per-pixel deprojection rays for a camera's intrinsics
+
+#pragma once
+
+#include <librealsense2/rs.hpp>
+#include <memory>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Lookup table of normalized rays (x/z, y/z) for every pixel
+ *
+ * rs2_deproject_pixel_to_point() evaluates the distortion model on every
+ * call, iteratively for the inverse models. The ray through a pixel does
+ * not depend on depth, so it is computed once per pixel position and
+ * deprojection becomes a bilinear lookup plus two multiplies. Rays are
+ * stored on the integer pixel grid (including the far image edge) in
+ * square tiles, each allocated and computed the first time a keypoint lands
+ * in it, so start-up costs nothing and only the regions people occupy use
+ * memory (a tile is 32 x 32 rays, 8 KB; a whole 1280x720 image ~7 MB).
+ *
+ * Pinhole intrinsics skip the table: no distortion, or a Brown-Conrady
+ * model with all-zero coefficients (as D4xx depth streams report), where
+ * the closed form (pixel - pp) / f is exact and cheaper than a lookup.
+ * Points outside the image fall back to the direct librealsense
+ * computation. Not thread-safe (tiles are built on first use).
+ */
+class DeprojectionTable {
+public:
+  static const int kTileSize = 32; // Grid points per tile side
+
+  DeprojectionTable();
+  explicit DeprojectionTable(const rs2_intrinsics &intrinsics);
+
+  /**
+   * @brief Switch to new intrinsics, discarding all cached tiles
+   */
+  void reset(const rs2_intrinsics &intrinsics);
+
+  /**
+   * @brief Normalized ray through a sub-pixel position
+   * @param pixel Pixel coordinates (same convention as rs2)
+   * @param ray Output (x/z, y/z)
+   */
+  void ray(const float pixel[2], float ray[2]);
+
+  /**
+   * @brief Drop-in replacement for rs2_deproject_pixel_to_point()
+   */
+  void deproject(float point[3], const float pixel[2], float depth) {
+    float r[2];
+    ray(pixel, r);
+    point[0] = r[0] * depth;
+    point[1] = r[1] * depth;
+    point[2] = depth;
+  }
+
+  /**
+   * @brief Number of tiles computed so far
+   */
+  size_t builtTiles() const { return builtTiles_; }
+
+private:
+  rs2_intrinsics intrinsics_;
+  bool pinhole_; // No distortion: compute rays on the fly
+
+  int gridW_; // width + 1 grid points
+  int gridH_; // height + 1 grid points
+  int tilesX_;
+  int tilesY_;
+  // Per tile, kTileSize^2 grid points x 2 floats; null until first used
+  std::vector<std::unique_ptr<float[]>> tiles_;
+  size_t builtTiles_;
+
+  /**
+   * @brief Ray at integer grid point (gx, gy), building its tile if needed
+   */
+  const float *rayAt(int gx, int gy);
+
+  void buildTile(int tx, int ty);
+  void directRay(const float pixel[2], float ray[2]) const;
+};
+
+} // namespace RealsenseBodyPose
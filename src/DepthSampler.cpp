@@ -0,0 +1,57 @@
+// Depth Sampler Implementation
+
+#include "DepthSampler.h"
+#include <algorithm>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+const int kMaxWindow =
+    (2 * kMaxDepthSampleRadius + 1) * (2 * kMaxDepthSampleRadius + 1);
+
+} // namespace
+
+uint16_t sampleMedianDepth(const cv::Mat &depthImage, int x, int y,
+                           int radius) {
+  // Bounds checking
+  if (x < 0 || x >= depthImage.cols || y < 0 || y >= depthImage.rows) {
+    return 0;
+  }
+
+  radius = std::min(std::max(radius, 0), kMaxDepthSampleRadius);
+  const int x0 = std::max(x - radius, 0);
+  const int x1 = std::min(x + radius, depthImage.cols - 1);
+  const int y0 = std::max(y - radius, 0);
+  const int y1 = std::min(y + radius, depthImage.rows - 1);
+
+  // Every sample is written, but the slot only advances for valid depth
+  uint16_t values[kMaxWindow];
+  int count = 0;
+  for (int sy = y0; sy <= y1; sy++) {
+    const uint16_t *row = depthImage.ptr<uint16_t>(sy);
+    for (int sx = x0; sx <= x1; sx++) {
+      uint16_t depth = row[sx];
+      values[count] = depth;
+      count += depth != 0;
+    }
+  }
+
+  if (count == 0) {
+    return 0;
+  }
+
+  // Return median depth for robustness
+  std::nth_element(values, values + count / 2, values + count);
+  return values[count / 2];
+}
+
+void sampleMedianDepths(const cv::Mat &depthImage, const DepthQuery *queries,
+                        size_t count, uint16_t *depths) {
+  for (size_t i = 0; i < count; i++) {
+    depths[i] = sampleMedianDepth(depthImage, queries[i].x, queries[i].y,
+                                  queries[i].radius);
+  }
+}
+
+} // namespace RealsenseBodyPose
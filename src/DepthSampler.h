@@ -0,0 +1,50 @@
+// Allocation-free median depth sampling around keypoints
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+namespace RealsenseBodyPose {
+
+// Largest supported window is (2 * radius + 1)^2 pixels
+const int kMaxDepthSampleRadius = 7;
+
+/**
+ * @brief One depth lookup: window center and radius in depth pixels
+ */
+struct DepthQuery {
+  int x;
+  int y;
+  int radius;
+};
+
+/**
+ * @brief Median of the valid (non-zero) depths in a square window
+ *
+ * Reads each window row as one contiguous span clipped to the image, packs
+ * valid values into stack storage without branching, and selects the
+ * median with nth_element. The result equals sorting the valid samples and
+ * taking element n/2.
+ *
+ * @param depthImage Depth image (CV_16UC1)
+ * @param x Window center x
+ * @param y Window center y
+ * @param radius Window radius, clamped to [0, kMaxDepthSampleRadius]
+ * @return Median depth (depth units), or 0 if the center is outside the
+ * image or the window has no valid depth
+ */
+uint16_t sampleMedianDepth(const cv::Mat &depthImage, int x, int y,
+                           int radius);
+
+/**
+ * @brief Sample many windows in one call
+ * @param depthImage Depth image (CV_16UC1)
+ * @param queries Window centers and radii
+ * @param count Number of queries
+ * @param depths Output, one median per query
+ */
+void sampleMedianDepths(const cv::Mat &depthImage, const DepthQuery *queries,
+                        size_t count, uint16_t *depths);
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,205 @@
+// Fragmentation Implementation
+
+#include "Fragmentation.h"
+#include <algorithm>
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+inline void put16(char *p, uint16_t v) {
+  p[0] = static_cast<char>(v);
+  p[1] = static_cast<char>(v >> 8);
+}
+
+inline void put32(char *p, uint32_t v) {
+  put16(p, static_cast<uint16_t>(v));
+  put16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+inline uint16_t get16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t *p) {
+  return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+} // namespace
+
+PacketFragmenter::PacketFragmenter(size_t mtu, size_t maxPacketBytes)
+    : m_maxDatagram(maxDatagramBytes(mtu)), m_maxPacket(maxPacketBytes),
+      m_whole(nullptr), m_wholeSize(0), m_count(0), m_chunk(0), m_total(0) {
+  const size_t payload = m_maxDatagram - kFragmentHeaderBytes;
+  const size_t maxFragments = (maxPacketBytes + payload - 1) / payload;
+  m_buffer.resize(maxFragments * m_maxDatagram);
+}
+
+int PacketFragmenter::split(const char *data, size_t size,
+                            uint32_t messageId) {
+  m_whole = nullptr;
+  m_count = 0;
+  if (size <= m_maxDatagram) {
+    m_whole = data;
+    m_wholeSize = size;
+    m_count = 1;
+    return m_count;
+  }
+  if (size > m_maxPacket) {
+    return 0;
+  }
+
+  // Even split, so no runt trailing fragment
+  const size_t payload = m_maxDatagram - kFragmentHeaderBytes;
+  const size_t count = (size + payload - 1) / payload;
+  if (count > 0xFFFF) {
+    return 0;
+  }
+  m_chunk = (size + count - 1) / count;
+  m_total = size;
+
+  for (size_t i = 0; i < count; i++) {
+    char *out = m_buffer.data() + i * m_maxDatagram;
+    const size_t offset = i * m_chunk;
+    const size_t length = std::min(m_chunk, size - offset);
+    put32(out, kFragmentMagic);
+    out[4] = static_cast<char>(kFragmentVersion);
+    out[5] = 0;
+    put16(out + 6, static_cast<uint16_t>(i));
+    put16(out + 8, static_cast<uint16_t>(count));
+    put16(out + 10, 0);
+    put32(out + 12, messageId);
+    put32(out + 16, static_cast<uint32_t>(size));
+    std::memcpy(out + kFragmentHeaderBytes, data + offset, length);
+  }
+  m_count = static_cast<int>(count);
+  return m_count;
+}
+
+const char *PacketFragmenter::datagram(int i) const {
+  return m_whole ? m_whole : m_buffer.data() + i * m_maxDatagram;
+}
+
+size_t PacketFragmenter::datagramSize(int i) const {
+  if (m_whole) {
+    return m_wholeSize;
+  }
+  const size_t offset = i * m_chunk;
+  return kFragmentHeaderBytes + std::min(m_chunk, m_total - offset);
+}
+
+int PacketFragmenter::maxCount() const {
+  return std::max(static_cast<int>(m_buffer.size() / m_maxDatagram), 1);
+}
+
+PacketReassembler::PacketReassembler(const Config &config)
+    : m_config(config), m_pending(std::max<size_t>(config.maxPending, 1)),
+      m_ready(nullptr), m_readySize(0) {}
+
+bool PacketReassembler::add(const uint8_t *datagram, size_t size,
+                            int64_t nowNs) {
+  m_ready = nullptr;
+  m_readySize = 0;
+  expire(nowNs);
+
+  if (size < kFragmentHeaderBytes || get32(datagram) != kFragmentMagic) {
+    m_stats.whole++;
+    m_ready = datagram;
+    m_readySize = size;
+    return true;
+  }
+
+  const uint16_t index = get16(datagram + 6);
+  const uint16_t count = get16(datagram + 8);
+  const uint32_t messageId = get32(datagram + 12);
+  const uint32_t total = get32(datagram + 16);
+  if (datagram[4] != kFragmentVersion || count == 0 || index >= count ||
+      total == 0 || total > m_config.maxPacketBytes || count > total) {
+    m_stats.invalid++;
+    return false;
+  }
+  const size_t chunk = (total + count - 1) / count;
+  const size_t offset = index * chunk;
+  if (offset >= total ||
+      size - kFragmentHeaderBytes != std::min(chunk, total - offset)) {
+    m_stats.invalid++;
+    return false;
+  }
+
+  // Find the packet in progress, or start one (evicting the oldest)
+  Pending *slot = nullptr;
+  Pending *oldest = nullptr;
+  Pending *idle = nullptr;
+  for (Pending &pending : m_pending) {
+    if ((pending.active || pending.done) && pending.messageId == messageId) {
+      slot = &pending;
+      break;
+    }
+    if (!pending.active) {
+      // Keep recently delivered packets around longest, to catch their
+      // late duplicates
+      if (!idle || (idle->done && (!pending.done ||
+                                   pending.firstNs < idle->firstNs))) {
+        idle = &pending;
+      }
+    } else if (!oldest || pending.firstNs < oldest->firstNs) {
+      oldest = &pending;
+    }
+  }
+  if (slot && slot->done) {
+    m_stats.duplicates++; // Late copy of a packet already delivered
+    return false;
+  }
+  if (slot && (slot->count != count || slot->totalBytes != total)) {
+    m_stats.invalid++;
+    return false;
+  }
+  if (!slot) {
+    if (!idle) {
+      m_stats.expired++;
+      oldest->active = false;
+      idle = oldest;
+    }
+    slot = idle;
+    slot->active = true;
+    slot->done = false;
+    slot->messageId = messageId;
+    slot->count = count;
+    slot->received = 0;
+    slot->totalBytes = total;
+    slot->firstNs = nowNs;
+    slot->packet.resize(total); // Grows to the largest packet seen, once
+    slot->have.assign(count, 0);
+  }
+
+  if (slot->have[index]) {
+    m_stats.duplicates++;
+    return false;
+  }
+  slot->have[index] = 1;
+  std::memcpy(slot->packet.data() + offset, datagram + kFragmentHeaderBytes,
+              size - kFragmentHeaderBytes);
+  if (++slot->received < slot->count) {
+    return false;
+  }
+
+  slot->active = false;
+  slot->done = true;
+  m_stats.completed++;
+  m_ready = slot->packet.data();
+  m_readySize = slot->totalBytes;
+  return true;
+}
+
+void PacketReassembler::expire(int64_t nowNs) {
+  const int64_t timeoutNs = static_cast<int64_t>(m_config.timeoutMs) * 1000000;
+  for (Pending &pending : m_pending) {
+    if (pending.active && nowNs - pending.firstNs > timeoutNs) {
+      pending.active = false;
+      m_stats.expired++;
+    }
+  }
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,158 @@
+// MTU-sized fragmentation and reassembly of UDP packets
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/*
+ * A packet (binary or delta; UdpSender sends JSON whole) that fits in one
+ * datagram is sent unchanged, so small frames look exactly as before. A
+ * larger one is split evenly into numbered fragments, each a 20-byte header
+ * plus a slice of the packet, little-endian:
+ *
+ *   uint32  magic          'R' 'B' 'P' 'F'
+ *   uint8   version        kFragmentVersion
+ *   uint8   reserved       0
+ *   uint16  index          0 .. count - 1
+ *   uint16  count          Fragments in this packet
+ *   uint16  reserved       0
+ *   uint32  messageId      Same for every fragment of a packet
+ *   uint32  totalBytes     Size of the reassembled packet
+ *   ...     payload        Bytes [index * chunk, ...) of the packet, where
+ *                          chunk = ceil(totalBytes / count)
+ *
+ * Receivers tell fragments from whole packets by the magic (JSON starts with
+ * '{', binary packets with "RBPS", delta packets with "RBPD").
+ */
+const uint32_t kFragmentMagic = 0x46504252; // "RBPF" on the wire
+const uint8_t kFragmentVersion = 1;
+const size_t kFragmentHeaderBytes = 20;
+
+// IPv4 (20) + UDP (8) headers taken out of the MTU
+const size_t kUdpIpOverheadBytes = 28;
+const size_t kDefaultMtu = 1500;
+
+/**
+ * @brief Largest UDP payload that avoids IP fragmentation at this MTU
+ */
+inline size_t maxDatagramBytes(size_t mtu) {
+  return mtu > kUdpIpOverheadBytes + kFragmentHeaderBytes
+             ? mtu - kUdpIpOverheadBytes
+             : kFragmentHeaderBytes + 1;
+}
+
+/**
+ * @brief Splits packets into datagrams no larger than the MTU allows
+ *
+ * Fragments are written into an internal buffer sized for the largest
+ * packet at construction, so splitting does not allocate.
+ */
+class PacketFragmenter {
+public:
+  /**
+   * @brief Constructor
+   * @param mtu Link MTU in bytes
+   * @param maxPacketBytes Largest packet split() will be given
+   */
+  PacketFragmenter(size_t mtu, size_t maxPacketBytes);
+
+  /**
+   * @brief Prepare the datagrams for one packet
+   * @param messageId Id stamped on the fragments (unused if the packet fits
+   *        in one datagram)
+   * @return Number of datagrams, 0 if the packet is larger than
+   *         maxPacketBytes
+   */
+  int split(const char *data, size_t size, uint32_t messageId);
+
+  // Datagram i of the last split(); the packet itself when it was not split
+  const char *datagram(int i) const;
+  size_t datagramSize(int i) const;
+
+  size_t maxDatagram() const { return m_maxDatagram; }
+
+  // Most datagrams split() can produce
+  int maxCount() const;
+
+private:
+  size_t m_maxDatagram;
+  size_t m_maxPacket;
+  std::vector<char> m_buffer; // Fragment i at i * m_maxDatagram
+
+  const char *m_whole; // Unsplit packet, when it fit
+  size_t m_wholeSize;
+  int m_count;
+  size_t m_chunk;
+  size_t m_total;
+};
+
+/**
+ * @brief Rebuilds fragmented packets on the receiving side
+ *
+ * Fragments may arrive in any order and duplicated. A packet missing a
+ * fragment is dropped once it is older than the timeout, or when the table
+ * of packets in progress is full. Whole (unfragmented) datagrams pass
+ * straight through. Assumes one sender per instance, since message ids are
+ * per sender.
+ */
+class PacketReassembler {
+public:
+  struct Config {
+    int timeoutMs = 100;           // Drop incomplete packets after this
+    size_t maxPending = 8;         // Packets reassembled concurrently
+    size_t maxPacketBytes = 65536; // Larger totals are rejected
+    Config() {}
+  };
+
+  struct Stats {
+    size_t whole = 0;      // Unfragmented datagrams passed through
+    size_t completed = 0;  // Packets reassembled
+    size_t expired = 0;    // Incomplete packets dropped
+    size_t duplicates = 0; // Fragments received twice
+    size_t invalid = 0;    // Malformed or inconsistent fragments
+  };
+
+  explicit PacketReassembler(const Config &config = Config());
+
+  /**
+   * @brief Feed one received datagram
+   * @param nowNs Monotonic receive time, for the timeout
+   * @return true when a whole packet is ready in data() / size()
+   */
+  bool add(const uint8_t *datagram, size_t size, int64_t nowNs);
+
+  // The packet completed by the last add() that returned true; valid until
+  // the next add()
+  const uint8_t *data() const { return m_ready; }
+  size_t size() const { return m_readySize; }
+
+  // Drop incomplete packets older than the timeout
+  void expire(int64_t nowNs);
+
+  const Stats &stats() const { return m_stats; }
+
+private:
+  struct Pending {
+    bool active = false;
+    bool done = false; // Delivered; remembered to spot late duplicates
+    uint32_t messageId = 0;
+    uint16_t count = 0;
+    uint16_t received = 0;
+    uint32_t totalBytes = 0;
+    int64_t firstNs = 0;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> have; // One flag per fragment
+  };
+
+  Config m_config;
+  std::vector<Pending> m_pending;
+  Stats m_stats;
+  const uint8_t *m_ready;
+  size_t m_readySize;
+};
+
+} // namespace RealsenseBodyPose
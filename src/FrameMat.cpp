@@ -0,0 +1,126 @@
+// Zero-copy cv::Mat views over RealSense frames
+
+#include "FrameMat.h"
+#include <new>
+
+namespace RealsenseBodyPose {
+
+// The UMatData is constructed in place for each view and destroyed when the
+// view is released; the storage stays with the holder
+struct RsFrameAllocator::Holder {
+  alignas(cv::UMatData) unsigned char data[sizeof(cv::UMatData)];
+  rs2::frame frame;
+  Holder *next = nullptr;
+};
+
+RsFrameAllocator *RsFrameAllocator::instance() {
+  static RsFrameAllocator allocator;
+  return &allocator;
+}
+
+RsFrameAllocator::Holder *RsFrameAllocator::acquire() const {
+  {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (free_) {
+      Holder *holder = free_;
+      free_ = holder->next;
+      return holder;
+    }
+  }
+  return new Holder(); // Warm-up: more views alive than ever before
+}
+
+void RsFrameAllocator::release(Holder *holder) const {
+  std::lock_guard<std::mutex> lock(poolMutex_);
+  holder->next = free_;
+  free_ = holder;
+}
+
+cv::UMatData *RsFrameAllocator::wrap(const rs2::frame &frame,
+                                     size_t totalSize) const {
+  Holder *holder = acquire();
+  holder->frame = frame;
+  cv::UMatData *u = new (holder->data) cv::UMatData(this);
+  u->data = u->origdata =
+      static_cast<uchar *>(const_cast<void *>(frame.get_data()));
+  u->size = totalSize;
+  u->refcount = 1; // Owned by the Mat header returned from wrapFrame()
+  u->userdata = holder;
+  return u;
+}
+
+cv::UMatData *RsFrameAllocator::allocate(int dims, const int *sizes, int type,
+                                         void *data, size_t *step,
+                                         cv::AccessFlag flags,
+                                         cv::UMatUsageFlags usageFlags) const {
+  return cv::Mat::getDefaultAllocator()->allocate(dims, sizes, type, data,
+                                                  step, flags, usageFlags);
+}
+
+bool RsFrameAllocator::allocate(cv::UMatData *data, cv::AccessFlag accessflags,
+                                cv::UMatUsageFlags usageFlags) const {
+  return data != nullptr;
+}
+
+void RsFrameAllocator::deallocate(cv::UMatData *u) const {
+  if (!u) {
+    return;
+  }
+
+  CV_Assert(u->urefcount == 0);
+  CV_Assert(u->refcount == 0);
+
+  // Dropping the handle hands the buffer back to the librealsense frame pool
+  Holder *holder = static_cast<Holder *>(u->userdata);
+  holder->frame = rs2::frame();
+  u->~UMatData();
+  release(holder);
+}
+
+cv::Mat wrapFrame(const rs2::video_frame &frame, int type) {
+  if (!frame || !frame.get_data()) {
+    return cv::Mat();
+  }
+
+  const int width = frame.get_width();
+  const int height = frame.get_height();
+  const size_t step = static_cast<size_t>(frame.get_stride_in_bytes());
+
+  cv::Mat mat(height, width, type, const_cast<void *>(frame.get_data()), step);
+  mat.u = RsFrameAllocator::instance()->wrap(frame, step * height);
+  return mat;
+}
+
+bool isFrameView(const cv::Mat &mat) {
+  return mat.u && mat.u->currAllocator == RsFrameAllocator::instance();
+}
+
+size_t exportFrame(const rs2::video_frame &frame, int type, bool zeroCopy,
+                   cv::Mat &out) {
+  const cv::Mat view = wrapFrame(frame, type);
+  if (view.empty()) {
+    out.release();
+    return 0;
+  }
+
+  // Recordings may carry RGB8 color; the pipeline works in BGR
+  const bool swapRB = frame.get_profile().format() == RS2_FORMAT_RGB8;
+  if (zeroCopy && !swapRB) {
+    out = view;
+    return 0;
+  }
+
+  // create() would otherwise reuse a frame buffer, or one another stage
+  // still reads
+  if (isFrameView(out) || (out.u && out.u->refcount > 1)) {
+    out.release();
+  }
+  if (swapRB) {
+    cv::cvtColor(view, out, cv::COLOR_RGB2BGR);
+  } else {
+    view.copyTo(out);
+  }
+  return out.total() * out.elemSize();
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,97 @@
+// Zero-copy cv::Mat views over RealSense frames
+
+#pragma once
+
+#include <librealsense2/rs.hpp>
+#include <opencv2/opencv.hpp>
+#include <mutex>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief cv::MatAllocator that keeps an rs2::frame alive for the lifetime of
+ * the cv::Mat headers referencing its pixels.
+ *
+ * The frame handle is stored in UMatData::userdata. OpenCV's reference count
+ * on the UMatData decides when the frame is released back to librealsense, so
+ * a wrapped Mat can be copied, passed between stages and outlive the
+ * frameset it came from without any pixel copy.
+ *
+ * The UMatData and the frame handle live together in a holder that goes back
+ * to a free list when the last Mat lets go, so once as many views as the
+ * pipeline keeps alive have been wrapped, wrapping a frame does not touch the
+ * heap. The free list only grows, to the most views ever alive at once.
+ */
+class RsFrameAllocator : public cv::MatAllocator {
+public:
+  /**
+   * @brief Process-wide allocator instance
+   */
+  static RsFrameAllocator *instance();
+
+  /**
+   * @brief Build a UMatData that owns a reference to the frame
+   * @param frame Frame whose buffer backs the Mat
+   * @param totalSize Size of the pixel buffer in bytes
+   */
+  cv::UMatData *wrap(const rs2::frame &frame, size_t totalSize) const;
+
+  // Wrapped frames are never allocated through this allocator; any Mat that
+  // needs fresh storage (create() with a different size) gets it from the
+  // default OpenCV allocator instead.
+  cv::UMatData *allocate(int dims, const int *sizes, int type, void *data,
+                         size_t *step, cv::AccessFlag flags,
+                         cv::UMatUsageFlags usageFlags) const override;
+  bool allocate(cv::UMatData *data, cv::AccessFlag accessflags,
+                cv::UMatUsageFlags usageFlags) const override;
+  void deallocate(cv::UMatData *data) const override;
+
+private:
+  struct Holder;
+
+  Holder *acquire() const;
+  void release(Holder *holder) const;
+
+  // Views are wrapped on the capture thread and released on any thread
+  mutable std::mutex poolMutex_;
+  mutable Holder *free_ = nullptr;
+};
+
+/**
+ * @brief Wrap a video frame as a cv::Mat without copying pixel data
+ *
+ * The returned Mat shares the frame buffer and holds a reference on the
+ * frame; the buffer is returned to librealsense once the last Mat header
+ * referencing it is released.
+ *
+ * @param frame Video or depth frame
+ * @param type OpenCV type matching the frame format (e.g. CV_8UC3, CV_16UC1)
+ * @return Mat view of the frame, or an empty Mat if the frame is invalid
+ */
+cv::Mat wrapFrame(const rs2::video_frame &frame, int type);
+
+/**
+ * @brief True if the Mat is a view over a librealsense frame buffer
+ */
+bool isFrameView(const cv::Mat &mat);
+
+/**
+ * @brief Hand a frame to the pipeline as a Mat
+ *
+ * With zeroCopy the Mat is a view over the frame (see wrapFrame), which
+ * consumers must treat as read-only: the buffer belongs to librealsense.
+ * Otherwise, or when the frame needs converting (RGB8 color becomes BGR),
+ * the pixels are written into an owned buffer. An owned buffer already in
+ * out and not shared is reused, so the copy does not allocate once warm; a
+ * view or a shared buffer in out is released first, never written.
+ *
+ * @param frame Video or depth frame
+ * @param type OpenCV type matching the frame format (e.g. CV_8UC3, CV_16UC1)
+ * @param zeroCopy Hand out a view when no conversion is needed
+ * @param out Output Mat
+ * @return Bytes copied or converted (0 for a view)
+ */
+size_t exportFrame(const rs2::video_frame &frame, int type, bool zeroCopy,
+                   cv::Mat &out);
+
+} // namespace RealsenseBodyPose
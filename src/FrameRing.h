@@ -0,0 +1,219 @@
+// Bounded lock-free ring buffer for handing frames between threads
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief What a producer does when the ring is full
+ */
+enum class OverflowPolicy {
+  DROP_OLDEST, // Evict the oldest queued entry to make room
+  BLOCK,       // Wait until the consumer frees a slot
+  LATEST_ONLY  // Evict on push, and the consumer skips to the newest entry
+};
+
+/**
+ * @brief Bounded lock-free ring of movable items
+ *
+ * One thread pushes, one thread pops. Each slot carries a sequence number
+ * (Vyukov-style), which lets the producer also pop the oldest entry to
+ * implement DROP_OLDEST without racing the consumer on the same slot.
+ * Capacity is rounded up to a power of two.
+ */
+template <typename T> class FrameRing {
+public:
+  explicit FrameRing(size_t capacity = 4) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos_.store(0, std::memory_order_relaxed);
+    dequeuePos_.store(0, std::memory_order_relaxed);
+  }
+
+  FrameRing(const FrameRing &) = delete;
+  FrameRing &operator=(const FrameRing &) = delete;
+
+  /**
+   * @brief Push without waiting
+   * @return false if the ring is full (item is left untouched)
+   */
+  bool tryPush(T &item) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos_.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          cell.data = std::move(item);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueuePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Pop the oldest entry without waiting
+   * @return false if the ring is empty
+   */
+  bool tryPop(T &item) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeuePos_.compare_exchange_weak(pos, pos + 1,
+                                              std::memory_order_relaxed)) {
+          item = std::move(cell.data);
+          cell.data = T();
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeuePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Push according to an overflow policy
+   * @param item Item to move into the ring
+   * @param policy Behavior when the ring is full
+   * @param cancel Aborts a BLOCK wait when set
+   * @param dropped Incremented for every entry evicted or discarded
+   * @return false if the item itself was discarded (BLOCK cancelled)
+   */
+  bool push(T &item, OverflowPolicy policy, const std::atomic<bool> &cancel,
+            std::atomic<size_t> &dropped) {
+    int spins = 0;
+    while (!tryPush(item)) {
+      if (policy == OverflowPolicy::BLOCK) {
+        if (cancel.load(std::memory_order_relaxed)) {
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        }
+        backoff(spins);
+        continue;
+      }
+
+      T evicted;
+      if (tryPop(evicted)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Pop the newest entry, discarding anything queued before it
+   * @param item Receives the newest entry
+   * @param skipped Incremented for every older entry discarded
+   * @return false if the ring is empty
+   */
+  bool popLatest(T &item, std::atomic<size_t> &skipped) {
+    if (!tryPop(item)) {
+      return false;
+    }
+    T newer;
+    while (tryPop(newer)) {
+      item = std::move(newer);
+      skipped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Wait for an entry until timeout
+   * @param item Receives the entry
+   * @param timeout_ms Maximum wait in milliseconds
+   * @param latestOnly Skip to the newest entry (LATEST_ONLY consumers)
+   * @param skipped Incremented for every entry skipped in latestOnly mode
+   * @return false on timeout
+   */
+  bool waitPop(T &item, int timeout_ms, bool latestOnly,
+               std::atomic<size_t> &skipped) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout_ms);
+    int spins = 0;
+    for (;;) {
+      if (latestOnly ? popLatest(item, skipped) : tryPop(item)) {
+        return true;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+      }
+      backoff(spins);
+    }
+  }
+
+  /**
+   * @brief Approximate number of queued entries
+   */
+  size_t size() const {
+    size_t head = enqueuePos_.load(std::memory_order_relaxed);
+    size_t tail = dequeuePos_.load(std::memory_order_relaxed);
+    return head > tail ? head - tail : 0;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  /**
+   * @brief Drop all queued entries (consumer side)
+   */
+  void clear() {
+    T item;
+    while (tryPop(item)) {
+    }
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  // Spin briefly, then yield, then sleep: frames arrive every few ms, so a
+  // short sleep costs little latency while keeping an idle waiter off the CPU
+  static void backoff(int &spins) {
+    if (spins < 64) {
+      spins++;
+    } else if (spins < 128) {
+      spins++;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> enqueuePos_;
+  alignas(64) std::atomic<size_t> dequeuePos_;
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,145 @@
+// Frame Source Interface - anything that produces color + depth framesets
+
+#pragma once
+
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <librealsense2/rs.hpp>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <thread>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Source of color + depth framesets driving the pipeline
+ *
+ * Implemented by the live camera (RealSenseCamera, which also plays back
+ * .bag files) and by offline sources (ImageDirectorySource,
+ * SyntheticSource) so the pipeline can be exercised without hardware.
+ */
+class FrameSource {
+public:
+  virtual ~FrameSource() = default;
+
+  /**
+   * @brief Open the source and start producing frames
+   * @throws std::runtime_error if the source cannot be opened
+   */
+  virtual void start() = 0;
+
+  /**
+   * @brief Stop producing frames
+   */
+  virtual void stop() = 0;
+
+  /**
+   * @brief Get next frameset
+   * @param colorImage Output BGR image (CV_8UC3); may be a view over a
+   * device buffer, so stages must not draw into it
+   * @param depthImage Output depth image (CV_16UC1, depth units), likewise
+   * read-only
+   * @param timeout_ms Timeout in milliseconds
+   * @param info Optional frame lineage (frame number, timestamps, capture
+   * stamp)
+   * @return true if frames were produced, false on timeout or end of stream
+   */
+  virtual bool captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
+                             int timeout_ms = 5000,
+                             FrameInfo *info = nullptr) = 0;
+
+  /**
+   * @brief Get color intrinsics for deprojection
+   */
+  virtual rs2_intrinsics getColorIntrinsics() const = 0;
+
+  /**
+   * @brief Get depth intrinsics (only meaningful for unaligned depth)
+   */
+  virtual rs2_intrinsics getDepthIntrinsics() const {
+    return getColorIntrinsics();
+  }
+
+  /**
+   * @brief Get depth -> color extrinsics (identity for aligned sources)
+   */
+  virtual rs2_extrinsics getDepthToColorExtrinsics() const {
+    return identityExtrinsics();
+  }
+
+  /**
+   * @brief Get color -> depth extrinsics (identity for aligned sources)
+   */
+  virtual rs2_extrinsics getColorToDepthExtrinsics() const {
+    return identityExtrinsics();
+  }
+
+  /**
+   * @brief Check whether depth images are pixel-aligned to color
+   */
+  virtual bool isDepthAlignedToColor() const { return true; }
+
+  /**
+   * @brief Get depth scale (meters per depth unit)
+   */
+  virtual float getDepthScale() const = 0;
+
+  /**
+   * @brief Check if the source is producing frames
+   */
+  virtual bool isRunning() const = 0;
+
+  /**
+   * @brief Check if a finite source has delivered its last frame
+   */
+  virtual bool isFinished() const { return false; }
+
+  /**
+   * @brief Human-readable description for logs
+   */
+  virtual std::string getName() const = 0;
+
+protected:
+  static rs2_extrinsics identityExtrinsics() {
+    rs2_extrinsics extrinsics = {{1, 0, 0, 0, 1, 0, 0, 0, 1}, {0, 0, 0}};
+    return extrinsics;
+  }
+};
+
+/**
+ * @brief Paces an offline source at a nominal frame rate
+ *
+ * In real-time mode wait() sleeps until the next frame is due; otherwise it
+ * returns immediately so frames are fed as fast as the pipeline consumes
+ * them.
+ */
+class FramePacer {
+public:
+  FramePacer(int fps, bool realTime)
+      : period_(std::chrono::microseconds(1000000 / std::max(fps, 1))),
+        realTime_(realTime), next_(std::chrono::steady_clock::now()) {}
+
+  void reset() { next_ = std::chrono::steady_clock::now(); }
+
+  void wait() {
+    if (!realTime_) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (next_ > now) {
+      std::this_thread::sleep_until(next_);
+      next_ += period_;
+    } else {
+      // Running late: restart the schedule instead of bursting to catch up
+      next_ = now + period_;
+    }
+  }
+
+private:
+  std::chrono::steady_clock::duration period_;
+  bool realTime_;
+  std::chrono::steady_clock::time_point next_;
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,144 @@
+// Image Directory Source Implementation
+
+#include "ImageDirectorySource.h"
+#include "Utils.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace RealsenseBodyPose {
+
+ImageDirectorySource::ImageDirectorySource(const Config &config)
+    : config_(config), nextIndex_(0), running_(false), intrinsics_(),
+      depthScale_(0.001f), pacer_(config.fps, config.realTime) {}
+
+void ImageDirectorySource::start() {
+  appLog(LogLevel::INFO, "Opening image directory: " + config_.directory);
+
+  cv::glob(config_.directory + "/color_*.png", colorFiles_, false);
+  cv::glob(config_.directory + "/depth_*.png", depthFiles_, false);
+
+  if (colorFiles_.empty()) {
+    throw std::runtime_error("No color_*.png images found in " +
+                             config_.directory);
+  }
+  if (colorFiles_.size() != depthFiles_.size()) {
+    throw std::runtime_error(
+        "Color/depth image count mismatch in " + config_.directory + " (" +
+        std::to_string(colorFiles_.size()) + " color, " +
+        std::to_string(depthFiles_.size()) + " depth)");
+  }
+
+  cv::Mat first = cv::imread(colorFiles_[0], cv::IMREAD_COLOR);
+  if (first.empty()) {
+    throw std::runtime_error("Failed to read " + colorFiles_[0]);
+  }
+  loadIntrinsics(first.cols, first.rows);
+
+  nextIndex_ = 0;
+  running_ = true;
+  pacer_.reset();
+
+  appLog(LogLevel::INFO, "✅ Image source ready: " +
+                             std::to_string(colorFiles_.size()) + " frames, " +
+                             std::to_string(intrinsics_.width) + "x" +
+                             std::to_string(intrinsics_.height) +
+                             (config_.realTime ? " (real time)"
+                                               : " (as fast as possible)"));
+}
+
+void ImageDirectorySource::stop() { running_ = false; }
+
+void ImageDirectorySource::loadIntrinsics(int width, int height) {
+  intrinsics_ = rs2_intrinsics();
+  intrinsics_.width = width;
+  intrinsics_.height = height;
+  intrinsics_.model = RS2_DISTORTION_NONE;
+
+  cv::FileStorage fs(config_.directory + "/intrinsics.yml",
+                     cv::FileStorage::READ);
+  if (fs.isOpened()) {
+    fs["fx"] >> intrinsics_.fx;
+    fs["fy"] >> intrinsics_.fy;
+    fs["ppx"] >> intrinsics_.ppx;
+    fs["ppy"] >> intrinsics_.ppy;
+    if (!fs["depth_scale"].empty()) {
+      fs["depth_scale"] >> depthScale_;
+    }
+    appLog(LogLevel::INFO, "  Intrinsics loaded from intrinsics.yml");
+
+    // Calibrated at another resolution: scale to the images as they are
+    int calibWidth = width;
+    int calibHeight = height;
+    if (!fs["width"].empty() && !fs["height"].empty()) {
+      fs["width"] >> calibWidth;
+      fs["height"] >> calibHeight;
+    }
+    if (calibWidth > 0 && calibHeight > 0 &&
+        (calibWidth != width || calibHeight != height)) {
+      const float sx = static_cast<float>(width) / calibWidth;
+      const float sy = static_cast<float>(height) / calibHeight;
+      intrinsics_.fx *= sx;
+      intrinsics_.ppx *= sx;
+      intrinsics_.fy *= sy;
+      intrinsics_.ppy *= sy;
+      appLog(LogLevel::WARNING,
+             "  intrinsics.yml is for " + std::to_string(calibWidth) + "x" +
+                 std::to_string(calibHeight) + ", scaled to the " +
+                 std::to_string(width) + "x" + std::to_string(height) +
+                 " images");
+    }
+    return;
+  }
+
+  // D4xx color sensor: roughly 69 degrees horizontal field of view
+  const float hfov = 69.0f * static_cast<float>(CV_PI) / 180.0f;
+  intrinsics_.fx = intrinsics_.fy = width / (2.0f * std::tan(hfov / 2.0f));
+  intrinsics_.ppx = width / 2.0f;
+  intrinsics_.ppy = height / 2.0f;
+  appLog(LogLevel::WARNING,
+         "No intrinsics.yml found, assuming 69 deg HFOV pinhole model");
+}
+
+bool ImageDirectorySource::isFinished() const {
+  return !config_.loop && nextIndex_ >= colorFiles_.size();
+}
+
+bool ImageDirectorySource::captureFrames(cv::Mat &colorImage,
+                                         cv::Mat &depthImage, int timeout_ms,
+                                         FrameInfo *info) {
+  if (!running_ || colorFiles_.empty()) {
+    return false;
+  }
+
+  if (nextIndex_ >= colorFiles_.size()) {
+    if (!config_.loop) {
+      return false;
+    }
+    nextIndex_ = 0;
+  }
+
+  pacer_.wait();
+
+  size_t index = nextIndex_++;
+  colorImage = cv::imread(colorFiles_[index], cv::IMREAD_COLOR);
+  depthImage = cv::imread(depthFiles_[index], cv::IMREAD_ANYDEPTH);
+
+  if (colorImage.empty() || depthImage.type() != CV_16UC1) {
+    appLog(LogLevel::WARNING,
+           "Skipping unreadable frame pair: " + colorFiles_[index]);
+    return false;
+  }
+
+  if (info) {
+    *info = FrameInfo();
+    info->frameNumber = index;
+    info->stampCapture();
+  }
+  return true;
+}
+
+std::string ImageDirectorySource::getName() const {
+  return "Image directory (" + config_.directory + ")";
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,66 @@
+// Frame source reading color + depth image pairs from a directory
+
+#pragma once
+
+#include "FrameSource.h"
+#include <string>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Plays back a directory of PNG color and 16-bit depth images
+ *
+ * Expects color_<N>.png (8-bit BGR) and depth_<N>.png (16-bit, depth units,
+ * aligned to color) pairs, matched in sorted order. Camera parameters are
+ * read from an optional intrinsics.yml (fx, fy, ppx, ppy, depth_scale, and
+ * the width and height they were calibrated at, if not the image size, to
+ * scale them to it); otherwise a pinhole model with a D4xx-like field of
+ * view is assumed. The image size always comes from the first color image.
+ */
+class ImageDirectorySource : public FrameSource {
+public:
+  /**
+   * @brief Source configuration
+   */
+  struct Config {
+    std::string directory;
+    int fps = 30;          // Nominal rate for real-time playback
+    bool realTime = true;  // false: deliver frames as fast as consumed
+    bool loop = false;     // Restart at the first frame after the last one
+
+    Config() {}
+    explicit Config(const std::string &dir) : directory(dir) {}
+  };
+
+  explicit ImageDirectorySource(const Config &config);
+
+  void start() override;
+  void stop() override;
+  bool captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
+                     int timeout_ms = 5000,
+                     FrameInfo *info = nullptr) override;
+
+  rs2_intrinsics getColorIntrinsics() const override { return intrinsics_; }
+  float getDepthScale() const override { return depthScale_; }
+  bool isRunning() const override { return running_; }
+  bool isFinished() const override;
+  std::string getName() const override;
+
+private:
+  Config config_;
+  std::vector<cv::String> colorFiles_;
+  std::vector<cv::String> depthFiles_;
+  size_t nextIndex_;
+  bool running_;
+  rs2_intrinsics intrinsics_;
+  float depthScale_;
+  FramePacer pacer_;
+
+  /**
+   * @brief Load intrinsics.yml or synthesize intrinsics from image size
+   */
+  void loadIntrinsics(int width, int height);
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,143 @@
+// JSON Encoder Implementation
+
+#include "JsonEncoder.h"
+#include <charconv>
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Key joint with its precomputed opening fragment: "Name":{"x":
+struct KeyJoint {
+  int id;
+  const char *fragment;
+  size_t length;
+};
+
+template <size_t N>
+constexpr KeyJoint keyJoint(int id, const char (&fragment)[N]) {
+  return KeyJoint{id, fragment, N - 1};
+}
+
+// Only sending key joints for robot control (Wrists, Shoulders, Elbows,
+// Nose) Indices match JointType in Utils.h
+const KeyJoint kKeyJoints[] = {
+    keyJoint(0, "\"Nose\":{\"x\":"),      keyJoint(5, "\"LShoulder\":{\"x\":"),
+    keyJoint(6, "\"RShoulder\":{\"x\":"), keyJoint(7, "\"LElbow\":{\"x\":"),
+    keyJoint(8, "\"RElbow\":{\"x\":"),    keyJoint(9, "\"LWrist\":{\"x\":"),
+    keyJoint(10, "\"RWrist\":{\"x\":")};
+
+} // namespace
+
+JsonSkeletonEncoder::JsonSkeletonEncoder(size_t capacity)
+    : capacity_(capacity), buffer_(new char[capacity]), size_(0),
+      out_(nullptr), end_(nullptr), overflow_(false) {}
+
+void JsonSkeletonEncoder::append(const char *text, size_t length) {
+  if (overflow_ || static_cast<size_t>(end_ - out_) < length) {
+    overflow_ = true;
+    return;
+  }
+  std::memcpy(out_, text, length);
+  out_ += length;
+}
+
+void JsonSkeletonEncoder::appendInt(long long value) {
+  if (overflow_) {
+    return;
+  }
+  std::to_chars_result result = std::to_chars(out_, end_, value);
+  if (result.ec != std::errc()) {
+    overflow_ = true;
+    return;
+  }
+  out_ = result.ptr;
+}
+
+void JsonSkeletonEncoder::appendUnsigned(unsigned long long value) {
+  if (overflow_) {
+    return;
+  }
+  std::to_chars_result result = std::to_chars(out_, end_, value);
+  if (result.ec != std::errc()) {
+    overflow_ = true;
+    return;
+  }
+  out_ = result.ptr;
+}
+
+void JsonSkeletonEncoder::appendFixed(double value, int decimals) {
+  if (overflow_) {
+    return;
+  }
+  // Same digits as printf("%.*f"): both round the exact binary value
+  std::to_chars_result result =
+      std::to_chars(out_, end_, value, std::chars_format::fixed, decimals);
+  if (result.ec != std::errc()) {
+    overflow_ = true;
+    return;
+  }
+  out_ = result.ptr;
+}
+
+size_t JsonSkeletonEncoder::encode(const SkeletonBatch &skeletons,
+                                   const FrameInfo *info, int decimals,
+                                   const JointMask<kNumJoints> *joints) {
+  out_ = buffer_.get();
+  end_ = out_ + capacity_;
+  overflow_ = false;
+
+  append("{\"skeletons\":[");
+  for (int i = 0; i < skeletons.size(); ++i) {
+    const SkeletonView skel = skeletons[i];
+
+    if (i > 0) {
+      append(",");
+    }
+
+    append("{\"id\":");
+    appendInt(skel.publicId());
+    append(",\"joints\":{");
+
+    bool firstJoint = true;
+    for (const KeyJoint &kj : kKeyJoints) {
+      if (joints && !joints->test(kj.id)) {
+        continue;
+      }
+      const Keypoint3D k3d = skel.keypoint3D(kj.id);
+      if (!k3d.isValid()) {
+        continue;
+      }
+      if (!firstJoint) {
+        append(",");
+      }
+      append(kj.fragment, kj.length);
+      appendFixed(k3d.x, decimals);
+      append(",\"y\":");
+      appendFixed(k3d.y, decimals);
+      append(",\"z\":");
+      appendFixed(k3d.z, decimals);
+      append(",\"conf\":");
+      appendFixed(k3d.confidence, decimals);
+      append("}");
+      firstJoint = false;
+    }
+    append("}}");
+  }
+  append("]");
+
+  // Frame lineage so receivers can measure latency and detect gaps
+  if (info) {
+    append(",\"frame\":");
+    appendUnsigned(info->frameNumber);
+    append(",\"timestamp\":");
+    appendFixed(info->sensorTimestampMs, 3);
+  }
+  append("}");
+
+  size_ = overflow_ ? 0 : static_cast<size_t>(out_ - buffer_.get());
+  return size_;
+}
+
+} // namespace RealsenseBodyPose
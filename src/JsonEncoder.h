@@ -0,0 +1,70 @@
+// Allocation-free encoder for the UDP skeleton JSON schema
+
+#pragma once
+
+#include "SkeletonBatch.h"
+#include "Utils.h"
+#include <cstddef>
+#include <memory>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Writes the {"skeletons":[{"id":..,"joints":{..}}]} packet into a
+ *        reusable fixed buffer
+ *
+ * Produces exactly the bytes of the original stringstream/printf encoder:
+ * the key joints (nose, shoulders, elbows, wrists) whose 3D point is valid,
+ * each coordinate and confidence with three decimals, followed by the frame
+ * number and device timestamp when lineage is given. Key names and
+ * punctuation are precomputed fragments and numbers are formatted with
+ * std::to_chars, so encoding never allocates and never touches the locale.
+ */
+class JsonSkeletonEncoder {
+public:
+  /**
+   * @brief Constructor
+   * @param capacity Buffer size in bytes (one full batch fits in the
+   *        default)
+   */
+  explicit JsonSkeletonEncoder(size_t capacity = 64 * 1024);
+
+  JsonSkeletonEncoder(const JsonSkeletonEncoder &) = delete;
+  JsonSkeletonEncoder &operator=(const JsonSkeletonEncoder &) = delete;
+
+  /**
+   * @brief Encode a batch, replacing the previous packet
+   * @param skeletons People to encode
+   * @param info Frame lineage, or nullptr to omit "frame" / "timestamp"
+   * @param decimals Digits after the point for coordinates and confidences
+   * @param joints Restrict the key joints to this subset, or nullptr
+   * @return Packet size, or 0 if it did not fit in the buffer
+   */
+  size_t encode(const SkeletonBatch &skeletons, const FrameInfo *info,
+                int decimals = 3,
+                const JointMask<kNumJoints> *joints = nullptr);
+
+  const char *data() const { return buffer_.get(); }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+
+private:
+  size_t capacity_;
+  std::unique_ptr<char[]> buffer_;
+  size_t size_;
+
+  // Write cursor, valid during encode()
+  char *out_;
+  char *end_;
+  bool overflow_;
+
+  void append(const char *text, size_t length);
+  template <size_t N> void append(const char (&text)[N]) {
+    append(text, N - 1);
+  }
+  void appendInt(long long value);
+  void appendUnsigned(unsigned long long value);
+  void appendFixed(double value, int decimals);
+};
+
+} // namespace RealsenseBodyPose
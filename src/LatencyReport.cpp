@@ -0,0 +1,108 @@
+// Latency Report Implementation
+
+#include "LatencyReport.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace RealsenseBodyPose {
+
+LatencyReport::LatencyReport(size_t window) : windowSize_(window) {
+  for (auto &w : windows_) {
+    w.samples.resize(windowSize_);
+  }
+  scratch_.reserve(windowSize_);
+}
+
+void LatencyReport::addSample(Stage stage, double ms) {
+  Window &w = windows_[stage];
+  w.samples[w.next] = ms;
+  w.next = (w.next + 1) % windowSize_;
+  w.count = std::min(w.count + 1, windowSize_);
+}
+
+void LatencyReport::addFrame(const FrameInfo &info) {
+  if (info.captureNs == 0) {
+    return;
+  }
+
+  const double nsToMs = 1e-6;
+  if (info.inferenceNs) {
+    addSample(CAPTURE_TO_INFERENCE,
+              (info.inferenceNs - info.captureNs) * nsToMs);
+  }
+  if (info.projectionNs && info.inferenceNs) {
+    addSample(INFERENCE_TO_PROJECTION,
+              (info.projectionNs - info.inferenceNs) * nsToMs);
+  }
+  if (info.sendNs && info.projectionNs) {
+    addSample(PROJECTION_TO_SEND, (info.sendNs - info.projectionNs) * nsToMs);
+  }
+  if (info.sendNs) {
+    double endToEnd = (info.sendNs - info.captureNs) * nsToMs;
+    addSample(END_TO_END, endToEnd);
+
+    // Global-time frame timestamps share the host wall clock, so the time
+    // from exposure to host arrival can be added on top
+    if (info.globalTimestamp) {
+      addSample(GLASS_TO_WIRE,
+                info.captureSystemMs - info.sensorTimestampMs + endToEnd);
+    }
+  }
+}
+
+double LatencyReport::percentile(Stage stage, double percentile) const {
+  const Window &w = windows_[stage];
+  if (w.count == 0) {
+    return 0.0;
+  }
+
+  scratch_.assign(w.samples.begin(), w.samples.begin() + w.count);
+  size_t rank = static_cast<size_t>(percentile / 100.0 * (w.count - 1) + 0.5);
+  rank = std::min(rank, w.count - 1);
+  std::nth_element(scratch_.begin(), scratch_.begin() + rank, scratch_.end());
+  return scratch_[rank];
+}
+
+std::string LatencyReport::summary() const {
+  std::stringstream ss;
+  ss << "Latency (ms)          p50      p95      p99";
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    Stage stage = static_cast<Stage>(s);
+    if (windows_[stage].count == 0) {
+      continue;
+    }
+    ss << "\n  " << std::setw(18) << std::left << stageName(stage) << std::right
+       << std::fixed << std::setprecision(2) << std::setw(7)
+       << percentile(stage, 50) << "  " << std::setw(7)
+       << percentile(stage, 95) << "  " << std::setw(7)
+       << percentile(stage, 99) << "  (n=" << windows_[stage].count << ")";
+  }
+  return ss.str();
+}
+
+void LatencyReport::reset() {
+  for (auto &w : windows_) {
+    w.next = 0;
+    w.count = 0;
+  }
+}
+
+const char *LatencyReport::stageName(Stage stage) {
+  switch (stage) {
+  case CAPTURE_TO_INFERENCE:
+    return "capture->infer";
+  case INFERENCE_TO_PROJECTION:
+    return "infer->project";
+  case PROJECTION_TO_SEND:
+    return "project->send";
+  case END_TO_END:
+    return "end-to-end";
+  case GLASS_TO_WIRE:
+    return "glass-to-wire";
+  default:
+    return "unknown";
+  }
+}
+
+} // namespace RealsenseBodyPose
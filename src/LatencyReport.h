@@ -0,0 +1,74 @@
+// Per-stage latency statistics built from frame lineage timestamps
+
+#pragma once
+
+#include "Utils.h"
+#include <string>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Collects per-stage latencies from FrameInfo and reports percentiles
+ *
+ * Keeps a sliding window of the most recent samples per stage and reports
+ * p50/p95/p99 for each pipeline stage and end to end. Stages a frame did not
+ * reach (e.g. no send when nobody was detected) are simply not sampled.
+ */
+class LatencyReport {
+public:
+  enum Stage {
+    CAPTURE_TO_INFERENCE,    // Capture -> pose estimation done
+    INFERENCE_TO_PROJECTION, // Pose estimation -> 3D projection done
+    PROJECTION_TO_SEND,      // 3D projection -> UDP send
+    END_TO_END,              // Capture -> UDP send
+    GLASS_TO_WIRE,           // Device timestamp -> UDP send (global time only)
+    STAGE_COUNT
+  };
+
+  /**
+   * @brief Constructor
+   * @param window Number of most recent samples kept per stage
+   */
+  explicit LatencyReport(size_t window = 1000);
+
+  /**
+   * @brief Add the stage latencies of one completed frame
+   */
+  void addFrame(const FrameInfo &info);
+
+  /**
+   * @brief Format p50/p95/p99 for every stage with samples
+   */
+  std::string summary() const;
+
+  /**
+   * @brief Get a percentile of one stage in milliseconds
+   * @param stage Stage to query
+   * @param percentile Percentile in [0, 100]
+   * @return Latency in milliseconds, or 0 if the stage has no samples
+   */
+  double percentile(Stage stage, double percentile) const;
+
+  /**
+   * @brief Drop all samples
+   */
+  void reset();
+
+private:
+  struct Window {
+    std::vector<double> samples; // Milliseconds, ring buffer
+    size_t next = 0;
+    size_t count = 0;
+  };
+
+  size_t windowSize_;
+  Window windows_[STAGE_COUNT];
+  mutable std::vector<double> scratch_;
+
+  void addSample(Stage stage, double ms);
+
+  static const char *stageName(Stage stage);
+};
+
+} // namespace RealsenseBodyPose
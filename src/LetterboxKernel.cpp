@@ -0,0 +1,165 @@
+// Fused Letterbox Kernel Implementation
+
+#include "LetterboxKernel.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Same fixed-point precision as cv::resize(INTER_LINEAR) for 8-bit images
+const int kCoefBits = 11;
+const int kCoefScale = 1 << kCoefBits;
+const int kCastBits = kCoefBits * 2;
+
+const int kMaxStripes = 8;
+
+} // namespace
+
+LetterboxKernel::LetterboxKernel(int outputWidth, int outputHeight)
+    : outW_(outputWidth), outH_(outputHeight), newW_(0), newH_(0), offX_(0),
+      offY_(0), scale_(1.0f), padX_(0.0f), padY_(0.0f), stripes_(1),
+      tensorData_(nullptr) {}
+
+void LetterboxKernel::configure(const cv::Size &sourceSize) {
+  sourceSize_ = sourceSize;
+
+  // Letterbox geometry, identical to the original preprocess() path
+  float scaleW = static_cast<float>(outW_) / sourceSize.width;
+  float scaleH = static_cast<float>(outH_) / sourceSize.height;
+  scale_ = std::min(scaleW, scaleH);
+  newW_ = static_cast<int>(sourceSize.width * scale_);
+  newH_ = static_cast<int>(sourceSize.height * scale_);
+  padX_ = (outW_ - newW_) / 2.0f;
+  padY_ = (outH_ - newH_) / 2.0f;
+  offX_ = static_cast<int>(padX_);
+  offY_ = static_cast<int>(padY_);
+
+  // Tap positions and weights follow cv::resize: half-pixel centers, taps
+  // clamped at the borders, weights rounded to 11-bit fixed point
+  auto buildTable = [](int srcLen, int dstLen, int stride,
+                       std::vector<int> &ofs, std::vector<short> &alpha) {
+    double scale = 1.0 / (static_cast<double>(dstLen) / srcLen);
+    ofs.resize(dstLen * 2);
+    alpha.resize(dstLen * 2);
+    for (int d = 0; d < dstLen; d++) {
+      float f = static_cast<float>((d + 0.5) * scale - 0.5);
+      int s = cvFloor(f);
+      f -= s;
+      if (s < 0) {
+        f = 0.0f;
+        s = 0;
+      }
+      if (s >= srcLen - 1) {
+        f = 0.0f;
+        s = srcLen - 1;
+      }
+      ofs[d * 2] = s * stride;
+      ofs[d * 2 + 1] = std::min(s + 1, srcLen - 1) * stride;
+      alpha[d * 2] = cv::saturate_cast<short>((1.0f - f) * kCoefScale);
+      alpha[d * 2 + 1] = cv::saturate_cast<short>(f * kCoefScale);
+    }
+  };
+  buildTable(sourceSize.width, newW_, 3, xofs_, xalpha_);
+  buildTable(sourceSize.height, newH_, 1, yofs_, yalpha_);
+
+  stripes_ = std::max(1, std::min({cv::getNumThreads(), kMaxStripes, newH_}));
+  scratch_.assign(static_cast<size_t>(stripes_) * 6 * newW_, 0);
+  tensorData_ = nullptr; // Padding must be rewritten for the new geometry
+}
+
+void LetterboxKernel::processRows(const cv::Mat &image, float *tensor,
+                                  int rowBegin, int rowEnd,
+                                  int *scratch) const {
+  const size_t plane = static_cast<size_t>(outW_) * outH_;
+  int *h0 = scratch;             // Row 0, planes B, G, R
+  int *h1 = scratch + 3 * newW_; // Row 1, planes B, G, R
+
+  for (int dy = rowBegin; dy < rowEnd; dy++) {
+    const uchar *s0 = image.ptr<uchar>(yofs_[dy * 2]);
+    const uchar *s1 = image.ptr<uchar>(yofs_[dy * 2 + 1]);
+    const int b0 = yalpha_[dy * 2];
+    const int b1 = yalpha_[dy * 2 + 1];
+
+    // Horizontal pass: interleaved BGR -> planar fixed-point rows
+    for (int dx = 0; dx < newW_; dx++) {
+      const int o0 = xofs_[dx * 2];
+      const int o1 = xofs_[dx * 2 + 1];
+      const int a0 = xalpha_[dx * 2];
+      const int a1 = xalpha_[dx * 2 + 1];
+      for (int c = 0; c < 3; c++) {
+        h0[c * newW_ + dx] = s0[o0 + c] * a0 + s0[o1 + c] * a1;
+        h1[c * newW_ + dx] = s1[o0 + c] * a0 + s1[o1 + c] * a1;
+      }
+    }
+
+    // Vertical pass: blend, round to 8 bits, normalize, store RGB planes
+    const size_t rowOffset =
+        static_cast<size_t>(offY_ + dy) * outW_ + static_cast<size_t>(offX_);
+    for (int p = 0; p < 3; p++) {
+      const int c = 2 - p; // Tensor plane 0 is R, source channel 2
+      const int *r0 = h0 + c * newW_;
+      const int *r1 = h1 + c * newW_;
+      float *dst = tensor + p * plane + rowOffset;
+
+      int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+      const int lanes = cv::VTraits<cv::v_int32>::vlanes();
+      const cv::v_int32 vb0 = cv::vx_setall_s32(b0);
+      const cv::v_int32 vb1 = cv::vx_setall_s32(b1);
+      const cv::v_int32 vround = cv::vx_setall_s32(1 << (kCastBits - 1));
+      const cv::v_int32 vzero = cv::vx_setzero_s32();
+      const cv::v_int32 vmax = cv::vx_setall_s32(255);
+      const cv::v_float32 vnorm = cv::vx_setall_f32(1.0f / 255.0f);
+      for (; x <= newW_ - lanes; x += lanes) {
+        cv::v_int32 v0 = cv::v_mul(cv::vx_load(r0 + x), vb0);
+        cv::v_int32 v1 = cv::v_mul(cv::vx_load(r1 + x), vb1);
+        cv::v_int32 v = cv::v_add(cv::v_add(v0, v1), vround);
+        v = cv::v_min(cv::v_max(cv::v_shr<kCastBits>(v), vzero), vmax);
+        cv::v_store(dst + x, cv::v_mul(cv::v_cvt_f32(v), vnorm));
+      }
+#endif
+      for (; x < newW_; x++) {
+        int v =
+            (r0[x] * b0 + r1[x] * b1 + (1 << (kCastBits - 1))) >> kCastBits;
+        dst[x] = cv::saturate_cast<uchar>(v) * (1.0f / 255.0f);
+      }
+    }
+  }
+}
+
+void LetterboxKernel::run(const cv::Mat &image, cv::Mat &tensor) {
+  CV_Assert(image.type() == CV_8UC3 && !image.empty());
+
+  if (image.size() != sourceSize_) {
+    configure(image.size());
+  }
+
+  const int sizes[4] = {1, 3, outH_, outW_};
+  if (tensor.dims != 4 || tensor.type() != CV_32F || tensor.size[1] != 3 ||
+      tensor.size[2] != outH_ || tensor.size[3] != outW_) {
+    tensor.create(4, sizes, CV_32F);
+  }
+
+  // Letterbox bars are constant: clear once per geometry / tensor buffer
+  if (tensorData_ != tensor.data) {
+    tensor.setTo(cv::Scalar(0));
+    tensorData_ = tensor.data;
+  }
+
+  float *data = tensor.ptr<float>();
+  cv::parallel_for_(
+      cv::Range(0, stripes_),
+      [&](const cv::Range &range) {
+        for (int s = range.start; s < range.end; s++) {
+          int rowBegin = newH_ * s / stripes_;
+          int rowEnd = newH_ * (s + 1) / stripes_;
+          processRows(image, data, rowBegin, rowEnd,
+                      scratch_.data() + static_cast<size_t>(s) * 6 * newW_);
+        }
+      },
+      stripes_);
+}
+
+} // namespace RealsenseBodyPose
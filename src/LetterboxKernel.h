@@ -0,0 +1,96 @@
+// Fused letterbox preprocessing: resize + pad + BGR->RGB + /255 + HWC->NCHW
+
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Single-pass letterbox preprocessing into a planar float tensor
+ *
+ * Replaces the resize -> pad -> blobFromImage chain with one pass over the
+ * output: each output row is bilinearly resampled from two source rows with
+ * the same 11-bit fixed-point weights cv::resize(INTER_LINEAR) uses, rounded
+ * to 8 bits, then swapped to RGB, scaled by 1/255 and stored straight into
+ * the NCHW planes. The vertical blend and float conversion are vectorized
+ * with OpenCV universal intrinsics and rows are split across threads.
+ *
+ * Interpolation tables are rebuilt only when the source size changes, and
+ * the constant padding is written only then, so steady-state frames touch
+ * each output pixel exactly once and allocate nothing. Results match the
+ * reference path to within one 8-bit step (1/255) per channel; OpenCV's own
+ * SIMD/IPP resize paths round slightly differently from its scalar code.
+ */
+class LetterboxKernel {
+public:
+  /**
+   * @brief Constructor
+   * @param outputWidth Network input width
+   * @param outputHeight Network input height
+   */
+  LetterboxKernel(int outputWidth, int outputHeight);
+
+  /**
+   * @brief Letterbox a BGR image into a 1x3xHxW float tensor
+   * @param image Source image (CV_8UC3, BGR)
+   * @param tensor Destination tensor (4D, CV_32F, 1x3xHxW); allocated on
+   * first use and reused afterwards
+   */
+  void run(const cv::Mat &image, cv::Mat &tensor);
+
+  /**
+   * @brief Resize factor applied to the source image
+   */
+  float scale() const { return scale_; }
+
+  /**
+   * @brief Left padding in output pixels
+   */
+  float padX() const { return padX_; }
+
+  /**
+   * @brief Top padding in output pixels
+   */
+  float padY() const { return padY_; }
+
+private:
+  int outW_;
+  int outH_;
+
+  // Geometry for the current source size
+  cv::Size sourceSize_;
+  int newW_;
+  int newH_;
+  int offX_;
+  int offY_;
+  float scale_;
+  float padX_;
+  float padY_;
+
+  // Fixed-point interpolation tables (two taps per output column / row)
+  std::vector<int> xofs_;     // Byte offsets of the two source pixels
+  std::vector<short> xalpha_; // Weights, sum to INTER_RESIZE_COEF_SCALE
+  std::vector<int> yofs_;     // Source rows
+  std::vector<short> yalpha_;
+
+  // Horizontal-pass scratch: per stripe, 2 rows x 3 channels x newW
+  int stripes_;
+  std::vector<int> scratch_;
+
+  const void *tensorData_; // Tensor whose padding was last written
+
+  /**
+   * @brief Rebuild interpolation tables for a new source size
+   */
+  void configure(const cv::Size &sourceSize);
+
+  /**
+   * @brief Process output rows [rowBegin, rowEnd) using a stripe's scratch
+   */
+  void processRows(const cv::Mat &image, float *tensor, int rowBegin,
+                   int rowEnd, int *scratch) const;
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,174 @@
+// NMS Engine Implementation
+
+#include "NmsEngine.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+const int kKeypointStride = NmsEngine::kNumKeypoints * 3;
+
+} // namespace
+
+NmsEngine::NmsEngine(const Config &config) : config_(config) {}
+
+void NmsEngine::clear() {
+  score_.clear();
+  x1_.clear();
+  y1_.clear();
+  x2_.clear();
+  y2_.clear();
+  area_.clear();
+  keypoints_.clear();
+}
+
+int NmsEngine::add(float score, const float *bbox, const float *keypoints) {
+  score_.push_back(score);
+  x1_.push_back(bbox[0]);
+  y1_.push_back(bbox[1]);
+  x2_.push_back(bbox[0] + bbox[2]);
+  y2_.push_back(bbox[1] + bbox[3]);
+  area_.push_back(bbox[2] * bbox[3]);
+
+  if (config_.mode == Mode::OKS) {
+    // Missing keypoints count as invisible: OKS 0, never suppressed
+    if (keypoints) {
+      keypoints_.insert(keypoints_.end(), keypoints,
+                        keypoints + kKeypointStride);
+    } else {
+      keypoints_.resize(keypoints_.size() + kKeypointStride, 0.0f);
+    }
+  }
+
+  return static_cast<int>(score_.size()) - 1;
+}
+
+const std::vector<int> &NmsEngine::run() {
+  keep_.clear();
+  keptX1_.clear();
+  keptY1_.clear();
+  keptX2_.clear();
+  keptY2_.clear();
+  keptArea_.clear();
+
+  order_.resize(score_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+
+  // Sort by confidence (descending)
+  std::sort(order_.begin(), order_.end(),
+            [this](int a, int b) { return score_[a] > score_[b]; });
+
+  const size_t cap = config_.maxDetections > 0
+                         ? static_cast<size_t>(config_.maxDetections)
+                         : order_.size();
+
+  for (int i : order_) {
+    if (keep_.size() >= cap) {
+      break;
+    }
+
+    bool suppressed = config_.mode == Mode::OKS ? overlapsKeptOKS(i)
+                                                : overlapsKeptIoU(i);
+    if (suppressed) {
+      continue;
+    }
+
+    keep_.push_back(i);
+    keptX1_.push_back(x1_[i]);
+    keptY1_.push_back(y1_[i]);
+    keptX2_.push_back(x2_[i]);
+    keptY2_.push_back(y2_[i]);
+    keptArea_.push_back(area_[i]);
+  }
+
+  return keep_;
+}
+
+bool NmsEngine::overlapsKeptIoU(int i) const {
+  const int count = static_cast<int>(keptX1_.size());
+  const float threshold = config_.threshold;
+
+  int k = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+  const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+  const cv::v_float32 vx1 = cv::vx_setall_f32(x1_[i]);
+  const cv::v_float32 vy1 = cv::vx_setall_f32(y1_[i]);
+  const cv::v_float32 vx2 = cv::vx_setall_f32(x2_[i]);
+  const cv::v_float32 vy2 = cv::vx_setall_f32(y2_[i]);
+  const cv::v_float32 varea = cv::vx_setall_f32(area_[i]);
+  const cv::v_float32 vthreshold = cv::vx_setall_f32(threshold);
+  const cv::v_float32 vzero = cv::vx_setzero_f32();
+  for (; k <= count - lanes; k += lanes) {
+    cv::v_float32 w =
+        cv::v_sub(cv::v_min(cv::vx_load(keptX2_.data() + k), vx2),
+                  cv::v_max(cv::vx_load(keptX1_.data() + k), vx1));
+    cv::v_float32 h =
+        cv::v_sub(cv::v_min(cv::vx_load(keptY2_.data() + k), vy2),
+                  cv::v_max(cv::vx_load(keptY1_.data() + k), vy1));
+    cv::v_float32 inter =
+        cv::v_mul(cv::v_max(vzero, w), cv::v_max(vzero, h));
+    cv::v_float32 uni = cv::v_sub(
+        cv::v_add(cv::vx_load(keptArea_.data() + k), varea), inter);
+    cv::v_float32 iou = cv::v_div(inter, uni);
+    if (cv::v_check_any(
+            cv::v_and(cv::v_gt(uni, vzero), cv::v_gt(iou, vthreshold)))) {
+      return true;
+    }
+  }
+#endif
+  for (; k < count; k++) {
+    float w = std::min(keptX2_[k], x2_[i]) - std::max(keptX1_[k], x1_[i]);
+    float h = std::min(keptY2_[k], y2_[i]) - std::max(keptY1_[k], y1_[i]);
+    float inter = std::max(0.0f, w) * std::max(0.0f, h);
+    float uni = keptArea_[k] + area_[i] - inter;
+    if (uni > 0 && inter / uni > threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool NmsEngine::overlapsKeptOKS(int i) const {
+  for (int k : keep_) {
+    if (oks(k, i) > config_.threshold) {
+      return true;
+    }
+  }
+  return false;
+}
+
+float NmsEngine::oks(int reference, int other) const {
+  if (keypoints_.empty()) {
+    return 0.0f;
+  }
+
+  const float *a = keypoints_.data() + reference * kKeypointStride;
+  const float *b = keypoints_.data() + other * kKeypointStride;
+
+  // COCO OKS: mean over visible joints of exp(-d^2 / (2 s^2 (2 sigma)^2)),
+  // with the reference box area standing in for the object scale s^2
+  const float scale = area_[reference] + 1e-6f;
+  float sum = 0.0f;
+  int visible = 0;
+  for (int j = 0; j < kNumKeypoints; j++) {
+    const float *ka = a + j * 3;
+    const float *kb = b + j * 3;
+    if (ka[2] < config_.keypointThreshold ||
+        kb[2] < config_.keypointThreshold) {
+      continue;
+    }
+    float dx = ka[0] - kb[0];
+    float dy = ka[1] - kb[1];
+    const float sigma = ActiveTopology::kSigmas[j];
+    float variance = 4.0f * sigma * sigma;
+    sum += std::exp(-(dx * dx + dy * dy) / (2.0f * scale * variance));
+    visible++;
+  }
+  return visible > 0 ? sum / visible : 0.0f;
+}
+
+} // namespace RealsenseBodyPose
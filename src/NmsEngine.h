@@ -0,0 +1,116 @@
+// Greedy non-maximum suppression over detection candidates
+
+#pragma once
+
+#include "SkeletonTopology.h"
+#include <cstddef>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Index-based greedy NMS with box IoU or keypoint OKS suppression
+ *
+ * Candidates are stored structure-of-arrays and referred to by the index
+ * add() returned; nothing is copied into the result. Greedy NMS only ever
+ * suppresses against boxes that were kept, so instead of comparing every
+ * pair the engine sweeps candidates in descending score order and tests
+ * each one against the kept set in a single batched SIMD pass. With the
+ * detection cap that is O(n log n + n * maxDetections) rather than O(n^2),
+ * and the output is identical to the pairwise loop.
+ *
+ * In OKS mode two people are considered duplicates when their keypoints
+ * agree (COCO object keypoint similarity, using the per-joint sigmas of
+ * the active skeleton topology), which keeps overlapping but distinct
+ * people that box IoU would merge.
+ */
+class NmsEngine {
+public:
+  enum class Mode {
+    IOU, // Suppress by bounding-box intersection over union
+    OKS  // Suppress by object keypoint similarity (needs keypoints)
+  };
+
+  /**
+   * @brief Suppression configuration
+   */
+  struct Config {
+    Mode mode = Mode::IOU;
+    float threshold = 0.45f;        // Suppress above this IoU / OKS
+    int maxDetections = 10;         // Stop after this many (<= 0: no cap)
+    float keypointThreshold = 0.3f; // OKS: joints below this are ignored
+
+    Config() {}
+  };
+
+  static constexpr int kNumKeypoints = ActiveTopology::kNumJoints;
+
+  explicit NmsEngine(const Config &config = Config());
+
+  void setConfig(const Config &config) { config_ = config; }
+  const Config &getConfig() const { return config_; }
+
+  /**
+   * @brief Remove all candidates (keeps capacity)
+   */
+  void clear();
+
+  /**
+   * @brief Add a candidate
+   * @param score Detection confidence
+   * @param bbox Box as [x, y, w, h]
+   * @param keypoints kNumKeypoints x (x, y, confidence), required in OKS mode
+   * @return Candidate index
+   */
+  int add(float score, const float *bbox, const float *keypoints = nullptr);
+
+  /**
+   * @brief Run suppression over the current candidates
+   * @return Kept candidate indices in descending score order (valid until
+   * the next call)
+   */
+  const std::vector<int> &run();
+
+  size_t size() const { return score_.size(); }
+
+  /**
+   * @brief Object keypoint similarity between two candidates
+   * @param reference Candidate whose box area sets the scale
+   */
+  float oks(int reference, int other) const;
+
+private:
+  Config config_;
+
+  // Candidates (structure of arrays)
+  std::vector<float> score_;
+  std::vector<float> x1_;
+  std::vector<float> y1_;
+  std::vector<float> x2_;
+  std::vector<float> y2_;
+  std::vector<float> area_;
+  std::vector<float> keypoints_; // kNumKeypoints * 3 per candidate
+
+  // Kept set, mirrored as arrays for the batched IoU test
+  std::vector<float> keptX1_;
+  std::vector<float> keptY1_;
+  std::vector<float> keptX2_;
+  std::vector<float> keptY2_;
+  std::vector<float> keptArea_;
+
+  std::vector<int> order_;
+  std::vector<int> keep_;
+
+  /**
+   * @brief True if candidate i overlaps any kept box by more than threshold
+   */
+  bool overlapsKeptIoU(int i) const;
+
+  /**
+   * @brief True if candidate i matches any kept skeleton by more than
+   * threshold
+   */
+  bool overlapsKeptOKS(int i) const;
+};
+
+} // namespace RealsenseBodyPose
@@ -1,10 +1,10 @@
 // GPU-Accelerated Pose Estimator using OpenCV DNN with CUDA
 
 #include "PoseEstimator.h"
+#include <opencv2/core/hal/intrin.hpp>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 
 namespace RealsenseBodyPose {
@@ -16,7 +16,13 @@ PoseEstimator::PoseEstimator(const Config& config)
     , scaleY_(1.0f)
     , padX_(0.0f)
     , padY_(0.0f)
+    , letterbox_(config.inputWidth, config.inputHeight)
 {
+    NmsEngine::Config nmsConfig;
+    nmsConfig.mode = config_.oksNms ? NmsEngine::Mode::OKS : NmsEngine::Mode::IOU;
+    nmsConfig.threshold = config_.oksNms ? config_.oksThreshold : config_.nmsThreshold;
+    nmsConfig.maxDetections = config_.maxDetections;
+    nms_.setConfig(nmsConfig);
 }
 
 PoseEstimator::~PoseEstimator() {
@@ -24,7 +30,7 @@ PoseEstimator::~PoseEstimator() {
 }
 
 void PoseEstimator::initialize() {
-    std::cout << "[INFO] Initializing GPU Pose Estimator..." << std::endl;
+    appLog(LogLevel::INFO, "Initializing GPU Pose Estimator...");
     
     // Load model
     loadModel();
@@ -32,19 +38,33 @@ void PoseEstimator::initialize() {
     // Check CUDA availability
     if (cv::cuda::getCudaEnabledDeviceCount() > 0) {
         cv::cuda::DeviceInfo deviceInfo;
-        std::cout << "[INFO] ✅ GPU: " << deviceInfo.name() << std::endl;
-        std::cout << "[INFO]   Compute Capability: " << deviceInfo.majorVersion() << "." 
-                  << deviceInfo.minorVersion() << std::endl;
+        appLog(LogLevel::INFO, std::string("✅ GPU: ") + deviceInfo.name());
+        appLog(LogLevel::INFO, "  Compute Capability: " +
+                                   std::to_string(deviceInfo.majorVersion()) + "." +
+                                   std::to_string(deviceInfo.minorVersion()));
     } else {
-        std::cout << "[WARN] ⚠️  No CUDA device found, using CPU" << std::endl;
+        appLog(LogLevel::WARNING, "⚠️  No CUDA device found, using CPU");
     }
     
     initialized_ = true;
-    std::cout << "[INFO] ✅ Pose Estimator initialized successfully!" << std::endl;
+    appLog(LogLevel::INFO, "✅ Pose Estimator initialized successfully!");
+}
+
+void PoseEstimator::warmup(int iterations) {
+    if (!initialized_) {
+        throw std::runtime_error("Pose estimator not initialized");
+    }
+    
+    cv::Mat dummy = cv::Mat::zeros(config_.inputHeight, config_.inputWidth, CV_8UC3);
+    for (int i = 0; i < iterations; i++) {
+        estimate(dummy, warmupBatch_);
+    }
+    appLog(LogLevel::INFO, "✅ Pose Estimator warmed up (" + std::to_string(iterations) +
+                               (iterations == 1 ? " pass)" : " passes)"));
 }
 
 void PoseEstimator::loadModel() {
-    std::cout << "[INFO] Loading ONNX model: " << config_.modelPath << std::endl;
+    appLog(LogLevel::INFO, "Loading ONNX model: " + config_.modelPath);
     
     // Check file exists
     std::ifstream file(config_.modelPath);
@@ -68,44 +88,57 @@ void PoseEstimator::loadModel() {
     if (cv::cuda::getCudaEnabledDeviceCount() > 0) {
         net_.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
         net_.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
-        std::cout << "[INFO] ✅ Using CUDA backend for inference" << std::endl;
+        appLog(LogLevel::INFO, "✅ Using CUDA backend for inference");
     } else {
         net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
         net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
-        std::cout << "[WARN] Using CPU backend for inference" << std::endl;
+        appLog(LogLevel::WARNING, "Using CPU backend for inference");
     }
     
-    std::cout << "[INFO] ✅ Model loaded successfully" << std::endl;
+    appLog(LogLevel::INFO, "✅ Model loaded successfully");
 }
 
-std::vector<Skeleton> PoseEstimator::estimate(const cv::Mat& image) {
+void PoseEstimator::estimate(const cv::Mat& image, SkeletonBatch& skeletons) {
     if (!initialized_) {
         throw std::runtime_error("Pose estimator not initialized");
     }
     
+    skeletons.clear();
     if (image.empty()) {
-        return {};
+        return;
     }
     
     // Preprocess
-    cv::Mat blob = preprocess(image);
+    if (config_.fusedPreprocess) {
+        letterbox_.run(image, inputTensor_);
+        scaleX_ = scaleY_ = letterbox_.scale();
+        padX_ = letterbox_.padX();
+        padY_ = letterbox_.padY();
+        net_.setInput(inputTensor_);
+    } else {
+        net_.setInput(preprocess(image));
+    }
     
     // Inference
-    net_.setInput(blob);
     cv::Mat output = net_.forward();
     
     // Postprocess
-    return postprocess(output, image.cols, image.rows);
+    postprocess(output, image.cols, image.rows, skeletons);
 }
 
-cv::Mat PoseEstimator::preprocess(const cv::Mat& image) {
+void PoseEstimator::decode(const cv::Mat& output, const cv::Size& imageSize, SkeletonBatch& skeletons) {
+    setLetterbox(imageSize.width, imageSize.height);
+    postprocess(output, imageSize.width, imageSize.height, skeletons);
+}
+
+void PoseEstimator::setLetterbox(int imageWidth, int imageHeight) {
     // Calculate letterbox resize parameters
-    float scaleW = static_cast<float>(config_.inputWidth) / image.cols;
-    float scaleH = static_cast<float>(config_.inputHeight) / image.rows;
+    float scaleW = static_cast<float>(config_.inputWidth) / imageWidth;
+    float scaleH = static_cast<float>(config_.inputHeight) / imageHeight;
     float scale = std::min(scaleW, scaleH);
     
-    int newW = static_cast<int>(image.cols * scale);
-    int newH = static_cast<int>(image.rows * scale);
+    int newW = static_cast<int>(imageWidth * scale);
+    int newH = static_cast<int>(imageHeight * scale);
     
     // Calculate padding
     padX_ = (config_.inputWidth - newW) / 2.0f;
@@ -114,6 +147,12 @@ cv::Mat PoseEstimator::preprocess(const cv::Mat& image) {
     // Store scale for postprocessing
     scaleX_ = scale;
     scaleY_ = scale;
+}
+
+cv::Mat PoseEstimator::preprocess(const cv::Mat& image) {
+    setLetterbox(image.cols, image.rows);
+    int newW = static_cast<int>(image.cols * scaleX_);
+    int newH = static_cast<int>(image.rows * scaleY_);
     
     // Resize image
     cv::Mat resized;
@@ -130,25 +169,67 @@ cv::Mat PoseEstimator::preprocess(const cv::Mat& image) {
     return blob;
 }
 
-std::vector<Skeleton> PoseEstimator::postprocess(const cv::Mat& output, int imageWidth, int imageHeight) {
-    std::vector<Skeleton> skeletons;
-    
-    // YOLOv8-Pose output shape: [1, 56, 8400]
-    // Channels: [x, y, w, h, confidence, {17 keypoints * 3}]
+void PoseEstimator::postprocess(const cv::Mat& output, int imageWidth, int imageHeight, SkeletonBatch& skeletons) {
+    // YOLOv8-Pose output shape: [1, 5 + 3 * J, 8400] (56 for COCO-17)
+    // Channels: [x, y, w, h, confidence, {J keypoints * 3}]
     // Each keypoint: [x, y, confidence]
+    // Layout is channel-major, so each channel is a contiguous row of anchors
+    
+    // The model has to be exported for the topology this build decodes
+    const int expectedChannels = kPoseOutputChannels<ActiveTopology>;
+    if (output.dims != 3 || output.size[1] != expectedChannels) {
+        throw std::runtime_error("Model output does not match the " + std::string(ActiveTopology::kName) +
+                                 " topology: expected " + std::to_string(expectedChannels) +
+                                 " channels per anchor (5 + 3 x " + std::to_string(kNumJoints) + ")");
+    }
     
     const float* data = (float*)output.data;
     int numAnchors = output.size[2];  // 8400
-    int numChannels = output.size[1]; // 56
     
-    for (int i = 0; i < numAnchors; i++) {
-        // Get bbox confidence (index 4)
-        float confidence = data[4 * numAnchors + i];
+    // Boxes only for anchors over threshold; keypoints wait until after NMS
+    collectCandidates(data, numAnchors);
+    const std::vector<int>& keep = nms_.run();
+    
+    skeletons.clear();
+    for (int c : keep) {
+        const Candidate& candidate = candidates_[c];
         
-        if (confidence < config_.confidenceThreshold) {
-            continue;
+        int person = skeletons.addPerson(candidate.confidence, candidate.bbox);
+        if (person < 0) {
+            break;  // Batch full
+        }
+        
+        // Extract keypoints
+        float keypoints[kNumJoints * 3];
+        decodeKeypoints(data, numAnchors, candidate.anchor, keypoints);
+        for (int k = 0; k < kNumJoints; k++) {
+            skeletons.setKeypoint2D(person, k, keypoints[k * 3], keypoints[k * 3 + 1], keypoints[k * 3 + 2]);
         }
+    }
+}
+
+void PoseEstimator::decodeKeypoints(const float* data, int numAnchors, int anchor, float* keypoints) const {
+    for (int k = 0; k < kNumJoints; k++) {
+        int baseIdx = 5 + k * 3;  // Start after bbox + confidence
+        float kx = data[(baseIdx + 0) * numAnchors + anchor];
+        float ky = data[(baseIdx + 1) * numAnchors + anchor];
+        float kconf = data[(baseIdx + 2) * numAnchors + anchor];
         
+        // Scale back to original coordinates
+        keypoints[k * 3 + 0] = (kx - padX_) / scaleX_;
+        keypoints[k * 3 + 1] = (ky - padY_) / scaleY_;
+        keypoints[k * 3 + 2] = kconf;
+    }
+}
+
+void PoseEstimator::collectCandidates(const float* data, int numAnchors) {
+    candidates_.clear();
+    nms_.clear();
+    
+    const float* scores = data + 4 * numAnchors;  // Confidence row (index 4)
+    const float threshold = config_.confidenceThreshold;
+    
+    auto addCandidate = [&](int i) {
         // Extract bounding box (indices 0-3)
         float cx = data[0 * numAnchors + i];  // center x
         float cy = data[1 * numAnchors + i];  // center y
@@ -161,91 +242,47 @@ std::vector<Skeleton> PoseEstimator::postprocess(const cv::Mat& output, int imag
         w = w / scaleX_;
         h = h / scaleY_;
         
-        float x1 = cx - w / 2;
-        float y1 = cy - h / 2;
-        
-        // Extract 17 keypoints
-        Skeleton skeleton;
-        skeleton.overallConfidence = confidence;
-        skeleton.bbox[0] = x1;
-        skeleton.bbox[1] = y1;
-        skeleton.bbox[2] = w;
-        skeleton.bbox[3] = h;
+        Candidate candidate;
+        candidate.anchor = i;
+        candidate.confidence = scores[i];
+        candidate.bbox[0] = cx - w / 2;
+        candidate.bbox[1] = cy - h / 2;
+        candidate.bbox[2] = w;
+        candidate.bbox[3] = h;
+        candidates_.push_back(candidate);
         
-        for (int k = 0; k < 17; k++) {
-            int baseIdx = 5 + k * 3;  // Start after bbox + confidence
-            float kx = data[(baseIdx + 0) * numAnchors + i];
-            float ky = data[(baseIdx + 1) * numAnchors + i];
-            float kconf = data[(baseIdx + 2) * numAnchors + i];
-            
-            // Scale back to original coordinates
-            kx = (kx - padX_) / scaleX_;
-            ky = (ky - padY_) / scaleY_;
-            
-            skeleton.keypoints2D[k] = Keypoint2D(kx, ky, kconf);
+        // OKS suppression compares keypoints, so those candidates need them up front
+        if (config_.oksNms) {
+            float keypoints[kNumJoints * 3];
+            decodeKeypoints(data, numAnchors, i, keypoints);
+            nms_.add(candidate.confidence, candidate.bbox, keypoints);
+        } else {
+            nms_.add(candidate.confidence, candidate.bbox);
         }
-        
-        skeletons.push_back(skeleton);
-    }
-    
-    // Apply NMS
-    return applyNMS(skeletons);
-}
-
-std::vector<Skeleton> PoseEstimator::applyNMS(const std::vector<Skeleton>& skeletons) {
-    if (skeletons.empty()) {
-        return {};
-    }
+    };
     
-    std::vector<Skeleton> result;
-    std::vector<int> indices(skeletons.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    
-    // Sort by confidence (descending)
-    std::sort(indices.begin(), indices.end(), [&skeletons](int a, int b) {
-        return skeletons[a].overallConfidence > skeletons[b].overallConfidence;
-    });
-    
-    std::vector<bool> suppressed(skeletons.size(), false);
-    
-    for (size_t i = 0; i < indices.size(); i++) {
-        if (suppressed[i]) continue;
-        
-        int idx = indices[i];
-        result.push_back(skeletons[idx]);
-        
-        if (result.size() >= static_cast<size_t>(config_.maxDetections)) {
-            break;
+    int i = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    // Almost every anchor is background: test a vector of scores at a time and
+    // only look at individual lanes when at least one of them passes
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vthreshold = cv::vx_setall_f32(threshold);
+    for (; i <= numAnchors - lanes; i += lanes) {
+        if (!cv::v_check_any(cv::v_ge(cv::vx_load(scores + i), vthreshold))) {
+            continue;
         }
-        
-        // Suppress overlapping boxes
-        for (size_t j = i + 1; j < indices.size(); j++) {
-            if (suppressed[j]) continue;
-            
-            int jdx = indices[j];
-            float iou = calculateIoU(skeletons[idx].bbox, skeletons[jdx].bbox);
-            
-            if (iou > config_.nmsThreshold) {
-                suppressed[j] = true;
+        for (int j = i; j < i + lanes; j++) {
+            if (scores[j] >= threshold) {
+                addCandidate(j);
             }
         }
     }
-    
-    return result;
-}
-
-float PoseEstimator::calculateIoU(const float* box1, const float* box2) {
-    float x1 = std::max(box1[0], box2[0]);
-    float y1 = std::max(box1[1], box2[1]);
-    float x2 = std::min(box1[0] + box1[2], box2[0] + box2[2]);
-    float y2 = std::min(box1[1] + box1[3], box2[1] + box2[3]);
-    
-    float intersection = std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
-    float area1 = box1[2] * box1[3];
-    float area2 = box2[2] * box2[3];
-    float unionArea = area1 + area2 - intersection;
-    
-    return (unionArea > 0) ? (intersection / unionArea) : 0.0f;
+#endif
+    for (; i < numAnchors; i++) {
+        if (scores[i] >= threshold) {
+            addCandidate(i);
+        }
+    }
 }
 
 } // namespace RealsenseBodyPose
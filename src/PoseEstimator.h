@@ -3,6 +3,9 @@
 #pragma once
 
 #include "Utils.h"
+#include "SkeletonBatch.h"
+#include "LetterboxKernel.h"
+#include "NmsEngine.h"
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
 #include <memory>
@@ -28,6 +31,9 @@ public:
         float confidenceThreshold = 0.5f;  // Minimum confidence for detection
         float nmsThreshold = 0.45f;     // Non-max suppression threshold
         int maxDetections = 10;         // Maximum number of people to detect
+        bool oksNms = false;            // Suppress duplicates by keypoint similarity instead of box IoU
+        float oksThreshold = 0.5f;      // OKS above which a detection is a duplicate
+        bool fusedPreprocess = true;    // Single-pass letterbox kernel (false: resize/pad/blobFromImage)
         
         Config() = default;
         explicit Config(const std::string& path) : modelPath(path) {}
@@ -50,12 +56,31 @@ public:
      */
     void initialize();
     
+    /**
+     * @brief Run dummy forward passes so backend setup (CUDA context, kernel
+     *        selection, workspace allocation) happens before the first frame
+     * @param iterations Number of warm-up passes
+     */
+    void warmup(int iterations = 1);
+    
     /**
      * @brief Run pose estimation on RGB image
      * @param image Input RGB image (CV_8UC3)
-     * @return Vector of detected skeletons (2D keypoints only)
+     * @param skeletons Output: detected skeletons (2D keypoints only), at
+     *        most kMaxPeople in descending confidence order
+     */
+    void estimate(const cv::Mat& image, SkeletonBatch& skeletons);
+    
+    /**
+     * @brief Decode a raw model output, as estimate() does after inference
+     * @param output Model output, [1, 5 + 3 * J, anchors]
+     * @param imageSize Size of the image the input tensor was letterboxed from
+     * @param skeletons Output: detected skeletons (2D keypoints only)
+     *
+     * Needs no model, so outputs from another runtime (or synthetic ones)
+     * can be decoded too.
      */
-    std::vector<Skeleton> estimate(const cv::Mat& image);
+    void decode(const cv::Mat& output, const cv::Size& imageSize, SkeletonBatch& skeletons);
     
     /**
      * @brief Check if estimator is initialized
@@ -81,13 +106,36 @@ private:
     float padX_;
     float padY_;
     
+    // Fused preprocessing state, reused across frames
+    LetterboxKernel letterbox_;
+    cv::Mat inputTensor_;
+    
+    /**
+     * @brief Detection candidate: anchor index plus decoded box, no keypoints
+     */
+    struct Candidate {
+        int anchor;        // Column in the model output
+        float confidence;  // Box confidence
+        float bbox[4];     // [x, y, w, h] in image coordinates
+    };
+    
+    // Postprocessing scratch, reused across frames
+    std::vector<Candidate> candidates_;
+    NmsEngine nms_;
+    SkeletonBatch warmupBatch_;
+    
     /**
      * @brief Load ONNX model
      */
     void loadModel();
     
     /**
-     * @brief Preprocess image for model input
+     * @brief Letterbox scale and padding for an image size (reference path)
+     */
+    void setLetterbox(int imageWidth, int imageHeight);
+    
+    /**
+     * @brief Preprocess image for model input (reference path)
      * @param image Input image
      * @return Preprocessed blob
      */
@@ -95,24 +143,26 @@ private:
     
     /**
      * @brief Postprocess model output to extract skeletons
+     * @throws std::runtime_error if the output does not match ActiveTopology
      * @param output Raw model output
      * @param imageWidth Original image width
      * @param imageHeight Original image height
-     * @return Detected skeletons with 2D keypoints
+     * @param skeletons Output: detected skeletons with 2D keypoints
      */
-    std::vector<Skeleton> postprocess(const cv::Mat& output, int imageWidth, int imageHeight);
+    void postprocess(const cv::Mat& output, int imageWidth, int imageHeight, SkeletonBatch& skeletons);
     
     /**
-     * @brief Apply Non-Maximum Suppression
-     * @param skeletons Input skeletons
-     * @return Filtered skeletons after NMS
+     * @brief Collect anchors whose confidence passes the threshold
+     * @param data Model output (channel-major, numAnchors per channel)
+     * @param numAnchors Number of anchors
      */
-    std::vector<Skeleton> applyNMS(const std::vector<Skeleton>& skeletons);
+    void collectCandidates(const float* data, int numAnchors);
     
     /**
-     * @brief Calculate Intersection over Union for two bounding boxes
+     * @brief Decode one anchor's keypoints into image coordinates
+     * @param keypoints Output, kNumJoints x (x, y, confidence)
      */
-    float calculateIoU(const float* box1, const float* box2);
+    void decodeKeypoints(const float* data, int numAnchors, int anchor, float* keypoints) const;
 };
 
 } // namespace RealsenseBodyPose
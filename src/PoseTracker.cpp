@@ -0,0 +1,289 @@
+// PoseTracker Implementation
+
+#include "PoseTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Share of the prediction error folded into the velocity each frame
+const float kVelocityGain = 0.5f;
+
+// Velocity kept per frame while a track coasts, so it slows to a stop
+const float kCoastDamping = 0.5f;
+
+float boxIou(const float *a, const float *b) {
+  const float x1 = std::max(a[0], b[0]);
+  const float y1 = std::max(a[1], b[1]);
+  const float x2 = std::min(a[0] + a[2], b[0] + b[2]);
+  const float y2 = std::min(a[1] + a[3], b[1] + b[3]);
+  if (x2 <= x1 || y2 <= y1) {
+    return 0.0f;
+  }
+  const float intersection = (x2 - x1) * (y2 - y1);
+  return intersection / (a[2] * a[3] + b[2] * b[3] - intersection + 1e-6f);
+}
+
+} // namespace
+
+PoseTracker::PoseTracker(const Config &config)
+    : config_(config), nextId_(0) {}
+
+void PoseTracker::update(SkeletonBatch &skeletons) {
+  stats_.frames++;
+  const int people = skeletons.size();
+
+  for (Track &track : tracks_) {
+    if (track.used) {
+      predict(track);
+    }
+  }
+
+  for (int p = 0; p < people; p++) {
+    personTrack_[p] = -1;
+    float sum[3] = {0.0f, 0.0f, 0.0f};
+    int count = 0;
+    for (int j = 0; j < kNumJoints; j++) {
+      if (skeletons.valid3D[p].test(j)) {
+        sum[0] += skeletons.x[j][p];
+        sum[1] += skeletons.y[j][p];
+        sum[2] += skeletons.z[j][p];
+        count++;
+      }
+    }
+    hasCentroid_[p] = count > 0;
+    for (int i = 0; i < 3; i++) {
+      centroid_[p][i] = count > 0 ? sum[i] / count : 0.0f;
+    }
+  }
+
+  // Score every track against every detection, keeping pairs that pass
+  int count = 0;
+  for (int t = 0; t < kMaxTracks; t++) {
+    if (!tracks_[t].used) {
+      continue;
+    }
+    for (int p = 0; p < people; p++) {
+      const float score = similarity(tracks_[t], skeletons, p);
+      if (score >= config_.minSimilarity) {
+        candidates_[count++] = {score, t, p};
+      }
+    }
+  }
+
+  // Greedy assignment, best pair first (ties in table order, so repeatable)
+  std::sort(candidates_, candidates_ + count,
+            [](const Candidate &a, const Candidate &b) {
+              if (a.score != b.score) {
+                return a.score > b.score;
+              }
+              return a.track != b.track ? a.track < b.track
+                                        : a.person < b.person;
+            });
+  bool matched[kMaxTracks] = {};
+  for (int i = 0; i < count; i++) {
+    const Candidate &c = candidates_[i];
+    if (matched[c.track] || personTrack_[c.person] >= 0) {
+      continue;
+    }
+    matched[c.track] = true;
+    personTrack_[c.person] = c.track;
+  }
+
+  for (int t = 0; t < kMaxTracks; t++) {
+    Track &track = tracks_[t];
+    if (!track.used || matched[t]) {
+      continue;
+    }
+    // A tentative track must be seen every frame; a confirmed one coasts
+    track.hits = 0;
+    track.missed++;
+    if (!track.confirmed) {
+      track.used = false;
+    } else if (track.missed > config_.maxMissedFrames) {
+      track.used = false;
+      stats_.deaths++;
+    }
+  }
+
+  // Correct every matched track before starting new ones, so a matched
+  // track that coasted until this frame has missed == 0 again and
+  // freeTrack() cannot take it
+  for (int p = 0; p < people; p++) {
+    if (personTrack_[p] >= 0) {
+      Track &track = tracks_[personTrack_[p]];
+      stats_.recovered += track.confirmed && track.missed > 0 ? 1 : 0;
+      correct(track, skeletons, p);
+    }
+  }
+
+  for (int p = 0; p < people; p++) {
+    if (personTrack_[p] >= 0) {
+      continue;
+    }
+    Track *track = freeTrack();
+    if (!track) {
+      continue;
+    }
+    track->used = true;
+    track->confirmed = false;
+    track->id = -1;
+    track->hits = 0;
+    track->missed = 0;
+    track->velocity[0] = track->velocity[1] = 0.0f;
+    for (int i = 0; i < 4; i++) {
+      track->bbox[i] = skeletons.bbox[p][i];
+    }
+    correct(*track, skeletons, p);
+    personTrack_[p] = static_cast<int>(track - tracks_);
+  }
+
+  // Publish confirmed tracks; hold back the rest (from the end, so the
+  // indices still to visit do not move)
+  for (int p = people - 1; p >= 0; p--) {
+    const int t = personTrack_[p];
+    if (t >= 0 && tracks_[t].confirmed) {
+      skeletons.trackId[p] = tracks_[t].id;
+    } else {
+      skeletons.removePerson(p);
+      stats_.held++;
+    }
+  }
+}
+
+void PoseTracker::reset() {
+  for (Track &track : tracks_) {
+    track.used = false;
+  }
+}
+
+int PoseTracker::activeTracks() const {
+  int active = 0;
+  for (const Track &track : tracks_) {
+    active += track.used && track.confirmed ? 1 : 0;
+  }
+  return active;
+}
+
+std::string PoseTracker::summary() const {
+  std::stringstream ss;
+  ss << "Tracker: " << activeTracks() << " active | " << stats_.births
+     << " IDs given | " << stats_.deaths << " lost | " << stats_.recovered
+     << " recovered | " << stats_.held << " held";
+  return ss.str();
+}
+
+float PoseTracker::similarity(const Track &track,
+                              const SkeletonBatch &skeletons,
+                              int person) const {
+  const float *box = skeletons.bbox[person];
+  const float iou = boxIou(track.bbox, box);
+
+  // 3D gate, widening with every frame the track went unseen
+  float weights = config_.iouWeight;
+  float score = config_.iouWeight * iou;
+  if (track.hasCentroid && hasCentroid_[person]) {
+    const float gate = config_.maxDistanceM * (track.missed + 1);
+    const float dx = track.centroid[0] - centroid_[person][0];
+    const float dy = track.centroid[1] - centroid_[person][1];
+    const float dz = track.centroid[2] - centroid_[person][2];
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (distance > gate) {
+      return -1.0f;
+    }
+    score += config_.distanceWeight * (1.0f - distance / gate);
+    weights += config_.distanceWeight;
+  } else if (iou <= 0.0f) {
+    return -1.0f; // No depth and no overlap: nothing ties them
+  }
+
+  // COCO OKS against the predicted keypoints, as NmsEngine::oks
+  const float scale = track.bbox[2] * track.bbox[3] + 1e-6f;
+  float oks = 0.0f;
+  int visible = 0;
+  for (int j = 0; j < kNumJoints; j++) {
+    if (!track.visible.test(j) || !skeletons.valid2D[person].test(j)) {
+      continue;
+    }
+    const float dx = track.u[j] - skeletons.u[j][person];
+    const float dy = track.v[j] - skeletons.v[j][person];
+    const float sigma = ActiveTopology::kSigmas[j];
+    oks += std::exp(-(dx * dx + dy * dy) / (8.0f * scale * sigma * sigma));
+    visible++;
+  }
+  if (visible > 0) {
+    score += config_.oksWeight * oks / visible;
+    weights += config_.oksWeight;
+  }
+  return weights > 0.0f ? score / weights : 0.0f;
+}
+
+void PoseTracker::predict(Track &track) {
+  track.bbox[0] += track.velocity[0];
+  track.bbox[1] += track.velocity[1];
+  for (int j = 0; j < kNumJoints; j++) {
+    track.u[j] += track.velocity[0];
+    track.v[j] += track.velocity[1];
+  }
+  if (track.missed > 0) {
+    track.velocity[0] *= kCoastDamping;
+    track.velocity[1] *= kCoastDamping;
+  }
+}
+
+void PoseTracker::correct(Track &track, const SkeletonBatch &skeletons,
+                          int person) {
+  // Prediction error of the box centre, spread over the frames it coasted
+  const float *box = skeletons.bbox[person];
+  const float frames = static_cast<float>(track.missed + 1);
+  const float errorX =
+      (box[0] + 0.5f * box[2]) - (track.bbox[0] + 0.5f * track.bbox[2]);
+  const float errorY =
+      (box[1] + 0.5f * box[3]) - (track.bbox[1] + 0.5f * track.bbox[3]);
+  track.velocity[0] += kVelocityGain * errorX / frames;
+  track.velocity[1] += kVelocityGain * errorY / frames;
+
+  for (int i = 0; i < 4; i++) {
+    track.bbox[i] = box[i];
+  }
+  track.visible = skeletons.valid2D[person];
+  for (int j = 0; j < kNumJoints; j++) {
+    track.u[j] = skeletons.u[j][person];
+    track.v[j] = skeletons.v[j][person];
+  }
+  track.hasCentroid = hasCentroid_[person];
+  for (int i = 0; i < 3; i++) {
+    track.centroid[i] = centroid_[person][i];
+  }
+
+  track.hits++;
+  track.missed = 0;
+  if (!track.confirmed && track.hits >= config_.birthFrames) {
+    track.confirmed = true;
+    track.id = nextId_++;
+    stats_.births++;
+  }
+}
+
+PoseTracker::Track *PoseTracker::freeTrack() {
+  // An unused slot, else the confirmed track that has coasted longest
+  Track *oldest = nullptr;
+  for (Track &track : tracks_) {
+    if (!track.used) {
+      return &track;
+    }
+    if (track.missed > 0 && (!oldest || track.missed > oldest->missed)) {
+      oldest = &track;
+    }
+  }
+  if (oldest) {
+    oldest->used = false;
+    stats_.deaths++;
+  }
+  return oldest;
+}
+
+} // namespace RealsenseBodyPose
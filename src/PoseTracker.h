@@ -0,0 +1,133 @@
+// Persistent person IDs across frames (track association and lifetime)
+
+#pragma once
+
+#include "SkeletonBatch.h"
+#include <cstddef>
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Gives each person a track ID that stays the same from frame to frame
+ *
+ * Runs once per frame after pose estimation and 3D projection, and writes
+ * SkeletonBatch::trackId, so the UDP sender, the recorder and the
+ * shared-memory ring report the same ID for the same person whatever order
+ * the detections come in.
+ *
+ * Every detection is scored against every track by a weighted mean of box
+ * IoU, keypoint OKS (both against the track moved by its image velocity)
+ * and 3D centroid distance. Centroids further apart than maxDistanceM per
+ * frame since the track was last seen never match; pairs scoring below
+ * minSimilarity never match either. Pairs are then matched greedily, best
+ * first, which on well separated people gives the same result as optimal
+ * assignment at a fraction of the cost.
+ *
+ * Hysteresis on both ends of a track's life:
+ *  - birth: a new track is tentative until matched birthFrames frames in a
+ *    row, and its people are removed from the batch until then, so one-frame
+ *    false positives never reach subscribers and never use up an ID;
+ *  - death: a confirmed track that goes unmatched is kept, coasting on its
+ *    velocity, for maxMissedFrames frames, so a person briefly occluded or
+ *    missed by the detector gets their ID back.
+ *
+ * Tracks live in a fixed table sized for kMaxPeople, and the candidate
+ * pairs in a fixed array, so update() never allocates.
+ */
+class PoseTracker {
+public:
+  struct Config {
+    float minSimilarity = 0.3f;  // Pairs scoring below this never match
+    float iouWeight = 1.0f;      // Weights of the three similarity terms
+    float oksWeight = 1.0f;
+    float distanceWeight = 0.5f; // Alone, distance cannot reach the minimum
+    float maxDistanceM = 0.5f;   // 3D centroid gate per frame unseen
+    int birthFrames = 3;         // Matches in a row before an ID is given
+    int maxMissedFrames = 15;    // Unmatched frames before a track is dropped
+    Config() {}
+  };
+
+  /**
+   * @brief Counters since construction
+   */
+  struct Stats {
+    size_t frames = 0;    // update() calls
+    size_t births = 0;    // Tracks confirmed (IDs given)
+    size_t deaths = 0;    // Confirmed tracks dropped after maxMissedFrames
+    size_t recovered = 0; // Confirmed tracks matched again after a miss
+    size_t held = 0;      // People removed while their track was tentative
+  };
+
+  // Room for every person in a frame plus as many coasting tracks
+  static const int kMaxTracks = 2 * kMaxPeople;
+
+  explicit PoseTracker(const Config &config = Config());
+
+  /**
+   * @brief Associate this frame's people with the tracks
+   *
+   * Call for every frame, including empty ones, so unmatched tracks age.
+   * Sets trackId for people on a confirmed track and removes the others.
+   */
+  void update(SkeletonBatch &skeletons);
+
+  // Forget every track (IDs keep counting up)
+  void reset();
+
+  // Confirmed tracks, including those coasting through a miss
+  int activeTracks() const;
+
+  const Stats &stats() const { return stats_; }
+
+  /**
+   * @brief One-line summary for the periodic log
+   */
+  std::string summary() const;
+
+private:
+  struct Track {
+    bool used = false;
+    bool confirmed = false;
+    int id = -1;
+    int hits = 0;   // Frames matched in a row
+    int missed = 0; // Frames unmatched in a row
+    float bbox[4];     // Predicted for the current frame, [x, y, w, h]
+    float velocity[2]; // Box motion per frame, pixels
+    float u[kNumJoints];
+    float v[kNumJoints];
+    JointMask<kNumJoints> visible; // Joints in u / v
+    float centroid[3];             // Mean of the 3D joints, meters
+    bool hasCentroid = false;
+  };
+
+  struct Candidate {
+    float score;
+    int track;
+    int person;
+  };
+
+  /**
+   * @brief Similarity of a track and a detection in [0, 1], or -1 if gated
+   */
+  float similarity(const Track &track, const SkeletonBatch &skeletons,
+                   int person) const;
+
+  void predict(Track &track);
+  void correct(Track &track, const SkeletonBatch &skeletons, int person);
+  Track *freeTrack();
+
+  Config config_;
+  Track tracks_[kMaxTracks];
+  Candidate candidates_[kMaxTracks * kMaxPeople];
+
+  // Per detection of the current frame
+  int personTrack_[kMaxPeople];
+  float centroid_[kMaxPeople][3];
+  bool hasCentroid_[kMaxPeople];
+
+  int nextId_;
+  Stats stats_;
+};
+
+} // namespace RealsenseBodyPose
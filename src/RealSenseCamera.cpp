@@ -1,6 +1,7 @@
 // RealSense Camera Implementation
 
 #include "RealSenseCamera.h"
+#include "FrameMat.h"
 #include "Utils.h"
 #include <iostream>
 
@@ -10,8 +11,11 @@ RealSenseCamera::RealSenseCamera(const Config &config)
     : config_(config), aligner_(nullptr),
       depthScale_(0.001f) // Default: 1mm = 0.001m
       ,
-      pipelineStarted_(false) {
-  if (config_.enableAlignment) {
+      pipelineStarted_(false), lastFrameBytesCopied_(0),
+      ring_(config.ringCapacity), stopCapture_(false), droppedFrames_(0) {
+  // Sparse alignment maps only keypoints into the raw depth frame (see
+  // SkeletonProjector), so the full-frame reprojection is skipped
+  if (config_.enableAlignment && !config_.sparseAlignment) {
     aligner_ = new rs2::align(RS2_STREAM_COLOR);
   }
 }
@@ -26,6 +30,14 @@ RealSenseCamera::~RealSenseCamera() {
 rs2::config RealSenseCamera::configurePipeline() {
   rs2::config cfg;
 
+  // Playback: stream whatever resolution and format the file was recorded in
+  if (!config_.playbackFile.empty()) {
+    cfg.enable_device_from_file(config_.playbackFile, config_.loopPlayback);
+    cfg.enable_stream(RS2_STREAM_COLOR);
+    cfg.enable_stream(RS2_STREAM_DEPTH);
+    return cfg;
+  }
+
   // Enable color stream
   cfg.enable_stream(RS2_STREAM_COLOR, config_.colorWidth, config_.colorHeight,
                     RS2_FORMAT_BGR8, // OpenCV-compatible BGR format
@@ -45,6 +57,13 @@ void RealSenseCamera::extractIntrinsics(const rs2::pipeline_profile &profile) {
       profile.get_stream(RS2_STREAM_COLOR).as<rs2::video_stream_profile>();
   colorIntrinsics_ = colorStream.get_intrinsics();
 
+  // Get depth stream intrinsics and depth <-> color extrinsics
+  auto depthStream =
+      profile.get_stream(RS2_STREAM_DEPTH).as<rs2::video_stream_profile>();
+  depthIntrinsics_ = depthStream.get_intrinsics();
+  depthToColor_ = depthStream.get_extrinsics_to(colorStream);
+  colorToDepth_ = colorStream.get_extrinsics_to(depthStream);
+
   // Get depth scale
   auto depthSensor = profile.get_device().first<rs2::depth_sensor>();
   depthScale_ = depthSensor.get_depth_scale();
@@ -90,14 +109,36 @@ void RealSenseCamera::start() {
                                "x" + std::to_string(config_.colorHeight) +
                                " @ " + std::to_string(config_.colorFPS) +
                                " FPS");
+    appLog(LogLevel::INFO,
+           std::string("  Alignment: ") +
+               (aligner_ ? "full frame (rs2::align)"
+                         : config_.sparseAlignment ? "sparse (keypoints only)"
+                                                   : "disabled"));
 
-    // Discard first few frames to allow auto-exposure to stabilize
-    appLog(LogLevel::INFO, "Waiting for auto-exposure to stabilize...");
-    for (int i = 0; i < 30; i++) {
-      pipeline_.wait_for_frames();
+    if (!config_.playbackFile.empty()) {
+      // Recorded frames need no exposure settling
+      device.as<rs2::playback>().set_real_time(config_.realTime);
+      appLog(LogLevel::INFO, "  Playback: " + config_.playbackFile +
+                                 (config_.realTime ? " (real time)"
+                                                   : " (as fast as possible)"));
+    } else {
+      // Discard first few frames to allow auto-exposure to stabilize
+      appLog(LogLevel::INFO, "Waiting for auto-exposure to stabilize...");
+      for (int i = 0; i < 30; i++) {
+        pipeline_.wait_for_frames();
+      }
     }
     appLog(LogLevel::INFO, "Camera ready!");
 
+    if (config_.asyncCapture) {
+      droppedFrames_ = 0;
+      stopCapture_ = false;
+      captureThread_ = std::thread(&RealSenseCamera::captureLoop, this);
+      appLog(LogLevel::INFO, "  Async capture: ring of " +
+                                 std::to_string(ring_.capacity()) +
+                                 " framesets");
+    }
+
   } catch (const rs2::error &e) {
     throw std::runtime_error("RealSense error: " + std::string(e.what()));
   } catch (const std::exception &e) {
@@ -107,6 +148,12 @@ void RealSenseCamera::start() {
 }
 
 void RealSenseCamera::stop() {
+  if (captureThread_.joinable()) {
+    stopCapture_ = true;
+    captureThread_.join();
+    ring_.clear();
+  }
+
   if (pipelineStarted_) {
     pipeline_.stop();
     pipelineStarted_ = false;
@@ -114,43 +161,98 @@ void RealSenseCamera::stop() {
   }
 }
 
-bool RealSenseCamera::captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
-                                    int timeout_ms) {
-  try {
-    // Wait for frames with timeout
-    rs2::frameset frames = pipeline_.wait_for_frames(timeout_ms);
+bool RealSenseCamera::processFrameset(rs2::frameset frames,
+                                      cv::Mat &colorImage, cv::Mat &depthImage,
+                                      FrameInfo *info) {
+  // Stamp arrival before alignment so its cost shows up in the latency report
+  if (info) {
+    *info = FrameInfo();
+    info->stampCapture();
+  }
 
-    // Apply alignment if enabled
-    if (aligner_) {
-      frames = aligner_->process(frames);
-    }
+  // Apply alignment if enabled
+  if (aligner_) {
+    frames = aligner_->process(frames);
+  }
 
-    // Get color frame
-    rs2::video_frame colorFrame = frames.get_color_frame();
-    if (!colorFrame) {
-      appLog(LogLevel::WARNING, "No color frame received");
-      return false;
-    }
+  // Get color frame
+  rs2::video_frame colorFrame = frames.get_color_frame();
+  if (!colorFrame) {
+    appLog(LogLevel::WARNING, "No color frame received");
+    return false;
+  }
 
-    // Get depth frame
-    rs2::depth_frame depthFrame = frames.get_depth_frame();
-    if (!depthFrame) {
-      appLog(LogLevel::WARNING, "No depth frame received");
-      return false;
-    }
+  // Get depth frame
+  rs2::depth_frame depthFrame = frames.get_depth_frame();
+  if (!depthFrame) {
+    appLog(LogLevel::WARNING, "No depth frame received");
+    return false;
+  }
+
+  if (info) {
+    info->frameNumber = colorFrame.get_frame_number();
+    info->sensorTimestampMs = colorFrame.get_timestamp();
+    info->globalTimestamp = colorFrame.get_frame_timestamp_domain() ==
+                            RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME;
+  }
+
+  // Convert to OpenCV Mat (views keep the rs2 frames alive, no pixel copy;
+  // RGB8 recordings are converted into an owned buffer, never in place)
+  lastFrameBytesCopied_ =
+      exportFrame(colorFrame, CV_8UC3, config_.zeroCopy, colorImage) +
+      exportFrame(depthFrame, CV_16UC1, config_.zeroCopy, depthImage);
 
-    // Convert to OpenCV Mat
-    colorImage =
-        cv::Mat(cv::Size(colorFrame.get_width(), colorFrame.get_height()),
-                CV_8UC3, (void *)colorFrame.get_data(), cv::Mat::AUTO_STEP)
-            .clone();
+  return true;
+}
 
-    depthImage =
-        cv::Mat(cv::Size(depthFrame.get_width(), depthFrame.get_height()),
-                CV_16UC1, (void *)depthFrame.get_data(), cv::Mat::AUTO_STEP)
-            .clone();
+void RealSenseCamera::captureLoop() {
+  while (!stopCapture_) {
+    try {
+      // Short timeout so stop() is never held up by a stalled device
+      rs2::frameset frames;
+      if (!pipeline_.try_wait_for_frames(&frames, 100)) {
+        continue;
+      }
 
+      CapturedFrames captured;
+      if (!processFrameset(frames, captured.color, captured.depth,
+                           &captured.info)) {
+        continue;
+      }
+
+      ring_.push(captured, config_.overflowPolicy, stopCapture_,
+                 droppedFrames_);
+
+    } catch (const rs2::error &e) {
+      appLog(LogLevel::ERR, "Frame capture error: " + std::string(e.what()));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    } catch (const std::exception &e) {
+      appLog(LogLevel::ERR, "Unexpected error: " + std::string(e.what()));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+bool RealSenseCamera::captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
+                                    int timeout_ms, FrameInfo *info) {
+  if (captureThread_.joinable()) {
+    CapturedFrames captured;
+    bool latestOnly = config_.overflowPolicy == OverflowPolicy::LATEST_ONLY;
+    if (!ring_.waitPop(captured, timeout_ms, latestOnly, droppedFrames_)) {
+      return false;
+    }
+    colorImage = std::move(captured.color);
+    depthImage = std::move(captured.depth);
+    if (info) {
+      *info = captured.info;
+    }
     return true;
+  }
+
+  try {
+    // Wait for frames with timeout
+    rs2::frameset frames = pipeline_.wait_for_frames(timeout_ms);
+    return processFrameset(frames, colorImage, depthImage, info);
 
   } catch (const rs2::error &e) {
     appLog(LogLevel::ERR, "Frame capture error: " + std::string(e.what()));
@@ -161,6 +263,27 @@ bool RealSenseCamera::captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
   }
 }
 
+bool RealSenseCamera::isFinished() const {
+  if (!pipelineStarted_ || config_.playbackFile.empty() ||
+      config_.loopPlayback) {
+    return false;
+  }
+  try {
+    auto device = pipeline_.get_active_profile().get_device();
+    return device.as<rs2::playback>().current_status() ==
+           RS2_PLAYBACK_STATUS_STOPPED;
+  } catch (...) {
+    return false;
+  }
+}
+
+std::string RealSenseCamera::getName() const {
+  if (!config_.playbackFile.empty()) {
+    return "RealSense playback (" + config_.playbackFile + ")";
+  }
+  return "RealSense camera (" + getSerialNumber() + ")";
+}
+
 std::string RealSenseCamera::getSerialNumber() const {
   if (!pipelineStarted_) {
     return "N/A";
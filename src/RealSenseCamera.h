@@ -2,10 +2,14 @@
 
 #pragma once
 
+#include "FrameRing.h"
+#include "FrameSource.h"
 #include <librealsense2/rs.hpp>
 #include <opencv2/opencv.hpp>
+#include <atomic>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 
 namespace RealsenseBodyPose {
 
@@ -13,9 +17,10 @@ namespace RealsenseBodyPose {
  * @brief Wrapper for Intel RealSense D457 camera
  * 
  * Handles initialization, configuration, and frame acquisition
- * with automatic alignment of depth to color frames.
+ * with automatic alignment of depth to color frames. Can also play
+ * back a recorded .bag file instead of streaming from a device.
  */
-class RealSenseCamera {
+class RealSenseCamera : public FrameSource {
 public:
     /**
      * @brief Camera configuration parameters
@@ -28,8 +33,16 @@ public:
         int depthHeight = 720;
         int depthFPS = 30;
         bool enableAlignment = true;  // Align depth to color
+        bool sparseAlignment = false; // Skip rs2::align; map keypoints into raw depth instead
+        bool zeroCopy = true;         // Hand out Mat views over rs2 frames instead of clones
+        bool asyncCapture = false;    // Acquire frames on a dedicated thread
+        OverflowPolicy overflowPolicy = OverflowPolicy::LATEST_ONLY;  // Ring policy when consumer lags
+        size_t ringCapacity = 4;      // Framesets buffered between acquisition and consumer
+        std::string playbackFile;     // Play back a .bag recording instead of a live device
+        bool realTime = true;         // Playback at recorded speed (false: as fast as consumed)
+        bool loopPlayback = false;    // Restart playback at end of file
         
-        Config() = default;
+        Config() {}
     };
     
     /**
@@ -41,45 +54,100 @@ public:
     /**
      * @brief Destructor - stops camera pipeline
      */
-    ~RealSenseCamera();
+    ~RealSenseCamera() override;
     
     /**
      * @brief Initialize and start camera
      * @throws std::runtime_error if camera initialization fails
      */
-    void start();
+    void start() override;
     
     /**
      * @brief Stop camera pipeline
      */
-    void stop();
+    void stop() override;
     
     /**
      * @brief Capture next frameset
+     *
+     * With Config::zeroCopy the returned images are read-only views over
+     * the librealsense frame buffers; the frames stay alive until the last
+     * cv::Mat referencing them is released. RGB8 color is always converted
+     * into an owned buffer.
+     *
+     * With Config::asyncCapture the frames come from the acquisition
+     * thread's ring instead of a blocking wait_for_frames() call.
+     *
      * @param colorImage Output RGB image (CV_8UC3)
      * @param depthImage Output depth image (CV_16UC1, millimeters)
      * @param timeout_ms Timeout in milliseconds (default 5000)
+     * @param info Optional frame lineage (rs2 frame number, device timestamp)
      * @return true if frames captured successfully, false on timeout
      */
-    bool captureFrames(cv::Mat& colorImage, cv::Mat& depthImage, int timeout_ms = 5000);
+    bool captureFrames(cv::Mat& colorImage, cv::Mat& depthImage, int timeout_ms = 5000,
+                       FrameInfo* info = nullptr) override;
     
     /**
      * @brief Get camera intrinsics for deprojection
      * @return RealSense intrinsics structure
      */
-    rs2_intrinsics getColorIntrinsics() const { return colorIntrinsics_; }
+    rs2_intrinsics getColorIntrinsics() const override { return colorIntrinsics_; }
+    
+    /**
+     * @brief Get depth stream intrinsics (raw, unaligned depth)
+     */
+    rs2_intrinsics getDepthIntrinsics() const override { return depthIntrinsics_; }
+    
+    /**
+     * @brief Get rigid transform from the depth to the color sensor
+     */
+    rs2_extrinsics getDepthToColorExtrinsics() const override { return depthToColor_; }
+    
+    /**
+     * @brief Get rigid transform from the color to the depth sensor
+     */
+    rs2_extrinsics getColorToDepthExtrinsics() const override { return colorToDepth_; }
+    
+    /**
+     * @brief Check whether captured depth images are aligned to color
+     * @return false in sparse-alignment or no-alignment mode (raw depth)
+     */
+    bool isDepthAlignedToColor() const override { return aligner_ != nullptr; }
     
     /**
      * @brief Get depth scale (meters per depth unit)
      * @return Depth scale value
      */
-    float getDepthScale() const { return depthScale_; }
+    float getDepthScale() const override { return depthScale_; }
+    
+    /**
+     * @brief Get number of pixel bytes copied for the last captured frameset
+     * @return 0 for views, otherwise the bytes copied or converted (color +
+     *         depth in copy mode, color alone for RGB8 in zero-copy mode)
+     */
+    size_t getLastFrameBytesCopied() const { return lastFrameBytesCopied_; }
+    
+    /**
+     * @brief Get number of framesets dropped by the acquisition ring
+     * @return Evicted plus skipped framesets since start()
+     */
+    size_t getDroppedFrames() const { return droppedFrames_.load(); }
     
     /**
      * @brief Check if camera is running
      * @return true if pipeline is active
      */
-    bool isRunning() const { return pipelineStarted_; }
+    bool isRunning() const override { return pipelineStarted_; }
+    
+    /**
+     * @brief Check if a non-looping playback has reached the end of the file
+     */
+    bool isFinished() const override;
+    
+    /**
+     * @brief Describe the source (device or playback file)
+     */
+    std::string getName() const override;
     
     /**
      * @brief Get device serial number
@@ -92,8 +160,23 @@ private:
     rs2::pipeline pipeline_;
     rs2::align* aligner_;  // Depth-to-color alignment
     rs2_intrinsics colorIntrinsics_;
+    rs2_intrinsics depthIntrinsics_;
+    rs2_extrinsics depthToColor_;
+    rs2_extrinsics colorToDepth_;
     float depthScale_;
     bool pipelineStarted_;
+    std::atomic<size_t> lastFrameBytesCopied_;
+    
+    // Asynchronous acquisition
+    struct CapturedFrames {
+        cv::Mat color;
+        cv::Mat depth;
+        FrameInfo info;
+    };
+    FrameRing<CapturedFrames> ring_;
+    std::thread captureThread_;
+    std::atomic<bool> stopCapture_;
+    std::atomic<size_t> droppedFrames_;
     
     /**
      * @brief Configure pipeline with desired stream settings
@@ -106,6 +189,18 @@ private:
      * @param profile Pipeline profile after start
      */
     void extractIntrinsics(const rs2::pipeline_profile& profile);
+    
+    /**
+     * @brief Align a frameset and convert it to OpenCV images
+     * @return false if the color or depth frame is missing
+     */
+    bool processFrameset(rs2::frameset frames, cv::Mat& colorImage, cv::Mat& depthImage,
+                         FrameInfo* info);
+    
+    /**
+     * @brief Acquisition thread body: wait for framesets and push them into the ring
+     */
+    void captureLoop();
 };
 
 } // namespace RealsenseBodyPose
@@ -0,0 +1,270 @@
+// Fixed-capacity structure-of-arrays storage for all people in a frame
+
+#pragma once
+
+#include "SkeletonTopology.h"
+#include "Utils.h"
+#include <cstdint>
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+const int kMaxPeople = 32; // Detections kept per frame
+
+/**
+ * @brief One bit per joint, sized for the topology at compile time
+ *
+ * A single 64-bit word for COCO-17 and Halpe-26, three for WholeBody-133.
+ */
+template <int NumJoints> class JointMask {
+public:
+  JointMask() { clear(); }
+
+  void clear() {
+    for (int w = 0; w < kWords; w++) {
+      words_[w] = 0;
+    }
+  }
+
+  bool test(int joint) const {
+    return (words_[joint >> 6] >> (joint & 63)) & 1u;
+  }
+  void set(int joint) { words_[joint >> 6] |= uint64_t(1) << (joint & 63); }
+  void reset(int joint) {
+    words_[joint >> 6] &= ~(uint64_t(1) << (joint & 63));
+  }
+
+  bool any() const {
+    for (int w = 0; w < kWords; w++) {
+      if (words_[w]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void setAll() {
+    for (int j = 0; j < NumJoints; j++) {
+      set(j);
+    }
+  }
+
+  int count() const {
+    int n = 0;
+    for (int j = 0; j < NumJoints; j++) {
+      n += test(j) ? 1 : 0;
+    }
+    return n;
+  }
+
+  JointMask &operator&=(const JointMask &other) {
+    for (int w = 0; w < kWords; w++) {
+      words_[w] &= other.words_[w];
+    }
+    return *this;
+  }
+
+  bool operator==(const JointMask &other) const {
+    for (int w = 0; w < kWords; w++) {
+      if (words_[w] != other.words_[w]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr int kWords = (NumJoints + 63) / 64;
+  uint64_t words_[kWords];
+};
+
+template <typename Topology> class BasicSkeletonBatch;
+
+/**
+ * @brief Read-only view of one person in a SkeletonBatch
+ *
+ * Cheap to copy (a pointer and an index); materializes Keypoint2D /
+ * Keypoint3D values on access so drawing and serialization code reads the
+ * same way it did with per-person Skeleton objects.
+ */
+template <typename Topology> class BasicSkeletonView {
+public:
+  BasicSkeletonView(const BasicSkeletonBatch<Topology> &batch, int person)
+      : batch_(&batch), person_(person) {}
+
+  int index() const { return person_; }
+  int trackId() const { return batch_->trackId[person_]; }
+  int publicId() const { return batch_->publicId(person_); }
+  float confidence() const { return batch_->score[person_]; }
+  const float *bbox() const { return batch_->bbox[person_]; }
+
+  bool hasKeypoint2D(int joint) const {
+    return batch_->valid2D[person_].test(joint);
+  }
+  bool hasKeypoint3D(int joint) const {
+    return batch_->valid3D[person_].test(joint);
+  }
+
+  Keypoint2D keypoint2D(int joint) const {
+    return Keypoint2D(batch_->u[joint][person_], batch_->v[joint][person_],
+                      batch_->conf[joint][person_]);
+  }
+
+  Keypoint3D keypoint3D(int joint) const {
+    // Unprojected joints read as the default (invalid) keypoint, as before
+    if (!hasKeypoint3D(joint)) {
+      return Keypoint3D();
+    }
+    return Keypoint3D(batch_->x[joint][person_], batch_->y[joint][person_],
+                      batch_->z[joint][person_], batch_->conf[joint][person_]);
+  }
+
+private:
+  const BasicSkeletonBatch<Topology> *batch_;
+  int person_;
+};
+
+/**
+ * @brief All skeletons detected in one frame, stored joint-major
+ *
+ * Each per-joint array holds that joint for every person contiguously
+ * (u[joint][person]), so per-joint work across people vectorizes and the
+ * whole batch lives in one flat object with no heap storage: filling,
+ * copying and moving it between pipeline stages never allocates.
+ *
+ * A bit per joint in valid2D / valid3D records which keypoints passed the
+ * 2D confidence threshold and which were given a depth, so consumers can
+ * skip invalid joints without inspecting them.
+ *
+ * The joint count comes from the Topology trait, so every per-joint loop
+ * has a compile-time bound.
+ */
+template <typename Topology> class BasicSkeletonBatch {
+public:
+  static constexpr int kNumJoints = Topology::kNumJoints;
+
+  // 2D keypoints (pixels) and confidence
+  float u[kNumJoints][kMaxPeople];
+  float v[kNumJoints][kMaxPeople];
+  float conf[kNumJoints][kMaxPeople];
+
+  // 3D keypoints (meters, camera frame)
+  float x[kNumJoints][kMaxPeople];
+  float y[kNumJoints][kMaxPeople];
+  float z[kNumJoints][kMaxPeople];
+
+  // Per person
+  float bbox[kMaxPeople][4]; // [x, y, w, h]
+  float score[kMaxPeople];   // Overall detection confidence
+  int trackId[kMaxPeople];   // -1 until a tracker assigns one
+  JointMask<kNumJoints> valid2D[kMaxPeople]; // Passed Keypoint2D::isValid()
+  JointMask<kNumJoints> valid3D[kMaxPeople]; // Has a 3D position
+
+  BasicSkeletonBatch() : count_(0) {}
+
+  int size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  /**
+   * @brief Id every output reports for a person: the track id once the
+   *        tracker assigned one, otherwise the index in this frame
+   */
+  int publicId(int person) const {
+    return trackId[person] >= 0 ? trackId[person] : person;
+  }
+  bool full() const { return count_ == kMaxPeople; }
+  void clear() { count_ = 0; }
+
+  /**
+   * @brief Append a person with no keypoints yet
+   * @return Person index, or -1 if the batch is full
+   */
+  int addPerson(float confidence, const float *box) {
+    if (full()) {
+      return -1;
+    }
+    const int p = count_++;
+    score[p] = confidence;
+    for (int i = 0; i < 4; i++) {
+      bbox[p][i] = box[i];
+    }
+    trackId[p] = -1;
+    valid2D[p].clear();
+    valid3D[p].clear();
+    for (int j = 0; j < kNumJoints; j++) {
+      u[j][p] = v[j][p] = conf[j][p] = 0.0f;
+      x[j][p] = y[j][p] = z[j][p] = 0.0f;
+    }
+    return p;
+  }
+
+  void setKeypoint2D(int person, int joint, float px, float py,
+                     float confidence) {
+    u[joint][person] = px;
+    v[joint][person] = py;
+    conf[joint][person] = confidence;
+    if (Keypoint2D(px, py, confidence).isValid()) {
+      valid2D[person].set(joint);
+    } else {
+      valid2D[person].reset(joint);
+    }
+  }
+
+  void setKeypoint3D(int person, int joint, float px, float py, float pz) {
+    x[joint][person] = px;
+    y[joint][person] = py;
+    z[joint][person] = pz;
+    valid3D[person].set(joint);
+  }
+
+  void clearKeypoint3D(int person, int joint) {
+    x[joint][person] = y[joint][person] = z[joint][person] = 0.0f;
+    valid3D[person].reset(joint);
+  }
+
+  /**
+   * @brief Remove a person, moving the later ones down a slot
+   *
+   * Keeps the order of the remaining people; each per-joint array is one
+   * contiguous move.
+   */
+  void removePerson(int person) {
+    const int tail = count_ - person - 1;
+    if (person < 0 || tail < 0) {
+      return;
+    }
+    const size_t bytes = tail * sizeof(float);
+    for (int j = 0; j < kNumJoints; j++) {
+      std::memmove(&u[j][person], &u[j][person + 1], bytes);
+      std::memmove(&v[j][person], &v[j][person + 1], bytes);
+      std::memmove(&conf[j][person], &conf[j][person + 1], bytes);
+      std::memmove(&x[j][person], &x[j][person + 1], bytes);
+      std::memmove(&y[j][person], &y[j][person + 1], bytes);
+      std::memmove(&z[j][person], &z[j][person + 1], bytes);
+    }
+    for (int p = person; p < count_ - 1; p++) {
+      for (int i = 0; i < 4; i++) {
+        bbox[p][i] = bbox[p + 1][i];
+      }
+      score[p] = score[p + 1];
+      trackId[p] = trackId[p + 1];
+      valid2D[p] = valid2D[p + 1];
+      valid3D[p] = valid3D[p + 1];
+    }
+    count_--;
+  }
+
+  BasicSkeletonView<Topology> operator[](int person) const {
+    return BasicSkeletonView<Topology>(*this, person);
+  }
+
+private:
+  int count_;
+};
+
+// The pipeline is built for one topology, chosen at configure time
+using SkeletonBatch = BasicSkeletonBatch<ActiveTopology>;
+using SkeletonView = BasicSkeletonView<ActiveTopology>;
+const int kNumJoints = ActiveTopology::kNumJoints;
+
+} // namespace RealsenseBodyPose
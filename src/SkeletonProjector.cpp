@@ -2,44 +2,57 @@
 
 #include "SkeletonProjector.h"
 #include <algorithm>
+#include <cmath>
+#include <librealsense2/rsutil.h>
 
 namespace RealsenseBodyPose {
 
 SkeletonProjector::SkeletonProjector(const rs2_intrinsics &intrinsics,
                                      float depthScale)
-    : intrinsics_(intrinsics), depthScale_(depthScale) {}
-
-uint16_t SkeletonProjector::sampleDepth(const cv::Mat &depthImage, int x, int y,
-                                        int radius) {
-  // Bounds checking
-  if (x < 0 || x >= depthImage.cols || y < 0 || y >= depthImage.rows) {
-    return 0;
+    : intrinsics_(intrinsics), depthScale_(depthScale),
+      colorRays_(intrinsics), sparseAlignment_(false),
+      depthIntrinsics_(intrinsics), colorToDepth_(), depthToColor_(),
+      radius_(2), adaptiveRadius_(false), radiusFraction_(0.01f), minRadius_(1),
+      maxRadius_(kMaxDepthSampleRadius) {
+  float sigmaSum = 0.0f;
+  for (int j = 0; j < kNumJoints; j++) {
+    sigmaSum += ActiveTopology::kSigmas[j];
+  }
+  for (int j = 0; j < kNumJoints; j++) {
+    jointRadiusScale_[j] = ActiveTopology::kSigmas[j] * kNumJoints / sigmaSum;
   }
+}
 
-  // Sample in a small neighborhood to reduce noise
-  std::vector<uint16_t> validDepths;
+void SkeletonProjector::enableSparseAlignment(
+    const rs2_intrinsics &depthIntrinsics, const rs2_extrinsics &colorToDepth,
+    const rs2_extrinsics &depthToColor) {
+  depthIntrinsics_ = depthIntrinsics;
+  colorToDepth_ = colorToDepth;
+  depthToColor_ = depthToColor;
+  depthRays_.reset(depthIntrinsics);
+  sparseAlignment_ = true;
+}
 
-  for (int dy = -radius; dy <= radius; dy++) {
-    for (int dx = -radius; dx <= radius; dx++) {
-      int sx = x + dx;
-      int sy = y + dy;
+void SkeletonProjector::enableAdaptiveRadius(float bboxFraction,
+                                             int minRadius, int maxRadius) {
+  radiusFraction_ = bboxFraction;
+  minRadius_ = std::max(0, minRadius);
+  maxRadius_ = std::min(std::max(minRadius_, maxRadius), kMaxDepthSampleRadius);
+  adaptiveRadius_ = true;
+}
 
-      if (sx >= 0 && sx < depthImage.cols && sy >= 0 && sy < depthImage.rows) {
-        uint16_t depth = depthImage.at<uint16_t>(sy, sx);
-        if (depth > 0) { // Valid depth
-          validDepths.push_back(depth);
-        }
-      }
-    }
+int SkeletonProjector::radiusFor(const float *bbox, int joint) const {
+  if (!adaptiveRadius_) {
+    return radius_;
   }
-
-  if (validDepths.empty()) {
-    return 0;
+  // Bounding box height shrinks with distance, so it sets the window scale;
+  // the box is in color pixels and a sparse window in depth pixels
+  float radius = bbox[3] * radiusFraction_ * jointRadiusScale_[joint];
+  if (sparseAlignment_) {
+    radius *= depthIntrinsics_.fy / intrinsics_.fy;
   }
-
-  // Return median depth for robustness
-  std::sort(validDepths.begin(), validDepths.end());
-  return validDepths[validDepths.size() / 2];
+  const int rounded = static_cast<int>(std::lround(radius));
+  return std::min(std::max(rounded, minRadius_), maxRadius_);
 }
 
 Keypoint3D SkeletonProjector::projectPoint(const Keypoint2D &pixel,
@@ -51,41 +64,107 @@ Keypoint3D SkeletonProjector::projectPoint(const Keypoint2D &pixel,
   // Convert depth from millimeters to meters
   float depthMeters = depth * depthScale_;
 
-  // Deproject pixel to 3D point using RealSense intrinsics
+  // Deproject pixel to 3D point using the cached rays for these intrinsics
   float pixelCoords[2] = {pixel.x, pixel.y};
   float point3D[3];
 
-  rs2_deproject_pixel_to_point(point3D, &intrinsics_, pixelCoords, depthMeters);
+  colorRays_.deproject(point3D, pixelCoords, depthMeters);
 
   // Create 3D keypoint with confidence from 2D detection
   return Keypoint3D(point3D[0], point3D[1], point3D[2], pixel.confidence);
 }
 
-void SkeletonProjector::project(std::vector<Skeleton> &skeletons,
+void SkeletonProjector::mapToDepthPixel(const Keypoint2D &pixel,
+                                        const cv::Mat &depthImage,
+                                        float *depthPixel) {
+  // Search the epipolar line in the raw depth frame for the depth pixel that
+  // projects onto this color pixel (same 0.1m - 10m range as Keypoint3D)
+  float colorPixel[2] = {pixel.x, pixel.y};
+  depthPixel[0] = depthPixel[1] = -1.0f;
+  rs2_project_color_pixel_to_depth_pixel(
+      depthPixel, depthImage.ptr<uint16_t>(), depthScale_, 0.1f, 10.0f,
+      &depthIntrinsics_, &intrinsics_, &colorToDepth_, &depthToColor_,
+      colorPixel);
+}
+
+Keypoint3D SkeletonProjector::projectPointSparse(const float *depthPixel,
+                                                 uint16_t depth,
+                                                 float confidence) {
+  if (depth == 0) {
+    return Keypoint3D();
+  }
+
+  // Deproject in the depth camera, then move the point into the color frame
+  float depthPoint[3];
+  float colorPoint[3];
+  depthRays_.deproject(depthPoint, depthPixel, depth * depthScale_);
+  rs2_transform_point_to_point(colorPoint, &depthToColor_, depthPoint);
+
+  return Keypoint3D(colorPoint[0], colorPoint[1], colorPoint[2], confidence);
+}
+
+void SkeletonProjector::project(SkeletonBatch &skeletons,
                                 const cv::Mat &depthImage) {
   if (depthImage.empty() || depthImage.type() != CV_16UC1) {
     appLog(LogLevel::ERR, "Invalid depth image for projection");
     return;
   }
 
-  for (auto &skeleton : skeletons) {
-    // Project each keypoint
-    for (size_t i = 0; i < skeleton.keypoints2D.size(); i++) {
-      const Keypoint2D &kpt2D = skeleton.keypoints2D[i];
+  // Gather one depth query per valid keypoint of every skeleton
+  queries_.clear();
+  pending_.clear();
+  for (int p = 0; p < skeletons.size(); p++) {
+    for (int j = 0; j < kNumJoints; j++) {
+      // Invalid 2D keypoints get no 3D position
+      skeletons.clearKeypoint3D(p, j);
+      if (!skeletons.valid2D[p].test(j)) {
+        continue;
+      }
+
+      const Keypoint2D kpt2D = skeletons[p].keypoint2D(j);
 
-      if (kpt2D.isValid()) {
-        // Sample depth at keypoint location
-        uint16_t depth = sampleDepth(depthImage, static_cast<int>(kpt2D.x),
-                                     static_cast<int>(kpt2D.y));
+      PendingKeypoint pending;
+      pending.person = p;
+      pending.joint = j;
 
-        // Project to 3D
-        skeleton.keypoints3D[i] = projectPoint(kpt2D, depth);
+      DepthQuery query;
+      query.radius = radiusFor(skeletons.bbox[p], j);
+      if (sparseAlignment_) {
+        mapToDepthPixel(kpt2D, depthImage, pending.depthPixel);
+        query.x = static_cast<int>(std::lround(pending.depthPixel[0]));
+        query.y = static_cast<int>(std::lround(pending.depthPixel[1]));
       } else {
-        // Invalid 2D keypoint
-        skeleton.keypoints3D[i] = Keypoint3D();
+        pending.depthPixel[0] = kpt2D.x;
+        pending.depthPixel[1] = kpt2D.y;
+        query.x = static_cast<int>(kpt2D.x);
+        query.y = static_cast<int>(kpt2D.y);
       }
+      queries_.push_back(query);
+      pending_.push_back(pending);
     }
   }
+
+  // Sample depth for all of them in one pass
+  depths_.resize(queries_.size());
+  sampleMedianDepths(depthImage, queries_.data(), queries_.size(),
+                     depths_.data());
+
+  // Project to 3D (keypoints without valid depth stay unset)
+  for (size_t q = 0; q < pending_.size(); q++) {
+    if (depths_[q] == 0) {
+      continue;
+    }
+
+    const PendingKeypoint &pending = pending_[q];
+    const Keypoint2D kpt2D =
+        skeletons[pending.person].keypoint2D(pending.joint);
+    Keypoint3D kpt3D = sparseAlignment_
+                           ? projectPointSparse(pending.depthPixel, depths_[q],
+                                                kpt2D.confidence)
+                           : projectPoint(kpt2D, depths_[q]);
+    skeletons.setKeypoint3D(pending.person, pending.joint, kpt3D.x, kpt3D.y,
+                            kpt3D.z);
+  }
 }
 
 } // namespace RealsenseBodyPose
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "Utils.h"
+#include "SkeletonBatch.h"
+#include "DepthSampler.h"
+#include "DeprojectionTable.h"
 #include "RealSenseCamera.h"
 #include <opencv2/opencv.hpp>
 #include <librealsense2/rs.hpp>
@@ -22,12 +25,48 @@ public:
      */
     explicit SkeletonProjector(const rs2_intrinsics& intrinsics, float depthScale);
     
+    /**
+     * @brief Read depth from the raw (unaligned) depth frame
+     *
+     * Instead of relying on a full-frame rs2::align, each color-space
+     * keypoint is mapped into the depth image along its epipolar line,
+     * deprojected with the depth intrinsics and transformed back into the
+     * color camera frame. project() then expects the raw depth image.
+     *
+     * @param depthIntrinsics Depth stream intrinsics
+     * @param colorToDepth Extrinsics from color to depth sensor
+     * @param depthToColor Extrinsics from depth to color sensor
+     */
+    void enableSparseAlignment(const rs2_intrinsics& depthIntrinsics,
+                               const rs2_extrinsics& colorToDepth,
+                               const rs2_extrinsics& depthToColor);
+    
+    /**
+     * @brief Scale the depth sampling window with each person and joint
+     *
+     * Nearby people cover more depth pixels, so a larger window rejects
+     * more noise without mixing in background; far people keep a small one.
+     * The keypoint's own distance is not known until its depth is sampled,
+     * so the bounding box height stands in for it. Within a person the
+     * window follows the joint's OKS sigma (ActiveTopology::kSigmas): hips
+     * get a wider one than wrists or eyes, which sit on small body parts.
+     *
+     * The radius is box height x fraction x sigma / mean sigma, converted
+     * to depth pixels in sparse mode, then clamped.
+     *
+     * @param bboxFraction Radius per pixel of bounding box height (mean joint)
+     * @param minRadius Smallest window radius
+     * @param maxRadius Largest window radius (at most kMaxDepthSampleRadius)
+     */
+    void enableAdaptiveRadius(float bboxFraction = 0.01f, int minRadius = 1,
+                              int maxRadius = kMaxDepthSampleRadius);
+    
     /**
      * @brief Project 2D skeletons to 3D using depth image
-     * @param skeletons Input skeletons with 2D keypoints (will be modified)
-     * @param depthImage Aligned depth image (CV_16UC1)
+     * @param skeletons Skeletons with 2D keypoints; 3D keypoints are filled in
+     * @param depthImage Aligned depth image, or raw depth in sparse mode (CV_16UC1)
      */
-    void project(std::vector<Skeleton>& skeletons, const cv::Mat& depthImage);
+    void project(SkeletonBatch& skeletons, const cv::Mat& depthImage);
     
     /**
      * @brief Project single 2D point to 3D
@@ -40,16 +79,60 @@ public:
 private:
     rs2_intrinsics intrinsics_;
     float depthScale_;
+    DeprojectionTable colorRays_;
+    
+    // Sparse alignment (keypoint-only color -> depth mapping)
+    bool sparseAlignment_;
+    rs2_intrinsics depthIntrinsics_;
+    rs2_extrinsics colorToDepth_;
+    rs2_extrinsics depthToColor_;
+    DeprojectionTable depthRays_;
+    
+    // Depth sampling window
+    int radius_;
+    bool adaptiveRadius_;
+    float radiusFraction_;
+    int minRadius_;
+    int maxRadius_;
+    float jointRadiusScale_[kNumJoints];  // Joint sigma / mean sigma
+    
+    /**
+     * @brief Keypoint awaiting its depth sample
+     */
+    struct PendingKeypoint {
+        int person;
+        int joint;
+        float depthPixel[2];  // Sparse mode: matching raw depth pixel
+    };
+    
+    // Per-frame batch, reused across frames
+    std::vector<DepthQuery> queries_;
+    std::vector<PendingKeypoint> pending_;
+    std::vector<uint16_t> depths_;
+    
+    /**
+     * @brief Sampling radius for one joint of a detected person
+     * @param bbox Person bounding box [x, y, w, h]
+     * @param joint Joint index
+     */
+    int radiusFor(const float* bbox, int joint) const;
+    
+    /**
+     * @brief Find the raw depth pixel seen by a color-space keypoint
+     * @param pixel Keypoint in color image coordinates
+     * @param depthImage Raw depth image (CV_16UC1)
+     * @param depthPixel Output depth pixel ({-1, -1} if not found)
+     */
+    void mapToDepthPixel(const Keypoint2D& pixel, const cv::Mat& depthImage, float* depthPixel);
     
     /**
-     * @brief Sample depth value at pixel location with averaging
-     * @param depthImage Depth image
-     * @param x Pixel x coordinate
-     * @param y Pixel y coordinate
-     * @param radius Sampling radius (default 2 pixels)
-     * @return Average depth value (millimeters), or 0 if invalid
+     * @brief Deproject a raw depth pixel into the color camera frame
+     * @param depthPixel Pixel in the depth image
+     * @param depth Sampled depth (depth units)
+     * @param confidence Keypoint confidence to carry over
+     * @return 3D point in the color camera frame (meters)
      */
-    uint16_t sampleDepth(const cv::Mat& depthImage, int x, int y, int radius = 2);
+    Keypoint3D projectPointSparse(const float* depthPixel, uint16_t depth, float confidence);
 };
 
 } // namespace RealsenseBodyPose
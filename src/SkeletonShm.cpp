@@ -0,0 +1,252 @@
+// Skeleton Shared Memory Implementation
+
+#include "SkeletonShm.h"
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+#ifdef _WIN32
+std::string nativeName(const std::string &name) { return "Local\\" + name; }
+#else
+std::string nativeName(const std::string &name) { return "/" + name; }
+#endif
+
+// Fresh reads attempted before readLatest() gives up on a busy writer
+const int kReadAttempts = 4;
+
+} // namespace
+
+SharedMemoryRegion::SharedMemoryRegion()
+    : m_data(nullptr), m_size(0), m_handle(-1) {}
+
+SharedMemoryRegion::~SharedMemoryRegion() { close(); }
+
+#ifdef _WIN32
+
+bool SharedMemoryRegion::create(const std::string &name, size_t size) {
+  close();
+  HANDLE mapping = CreateFileMappingA(
+      INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+      static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+      static_cast<DWORD>(size), nativeName(name).c_str());
+  if (!mapping) {
+    return false;
+  }
+  void *data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (!data) {
+    CloseHandle(mapping);
+    return false;
+  }
+  m_handle = reinterpret_cast<intptr_t>(mapping);
+  m_data = data;
+  m_size = size;
+  return true;
+}
+
+bool SharedMemoryRegion::open(const std::string &name, bool writable) {
+  close();
+  const DWORD access = writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ;
+  HANDLE mapping = OpenFileMappingA(access, FALSE, nativeName(name).c_str());
+  if (!mapping) {
+    return false;
+  }
+  void *data = MapViewOfFile(mapping, access, 0, 0, 0);
+  MEMORY_BASIC_INFORMATION info;
+  if (!data || VirtualQuery(data, &info, sizeof(info)) == 0) {
+    if (data) {
+      UnmapViewOfFile(data);
+    }
+    CloseHandle(mapping);
+    return false;
+  }
+  m_handle = reinterpret_cast<intptr_t>(mapping);
+  m_data = data;
+  m_size = info.RegionSize;
+  return true;
+}
+
+void SharedMemoryRegion::close() {
+  if (m_data) {
+    UnmapViewOfFile(m_data);
+  }
+  if (m_handle != -1) {
+    CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_handle = -1;
+}
+
+void SharedMemoryRegion::remove(const std::string &) {}
+
+#else
+
+bool SharedMemoryRegion::create(const std::string &name, size_t size) {
+  close();
+  int fd = shm_open(nativeName(name).c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  void *data = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (data == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  m_handle = fd;
+  m_data = data;
+  m_size = size;
+  return true;
+}
+
+bool SharedMemoryRegion::open(const std::string &name, bool writable) {
+  close();
+  int fd = shm_open(nativeName(name).c_str(), writable ? O_RDWR : O_RDONLY, 0);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  void *data = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    data = mmap(nullptr, static_cast<size_t>(info.st_size),
+                writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd,
+                0);
+  }
+  if (data == MAP_FAILED) {
+    ::close(fd);
+    return false;
+  }
+  m_handle = fd;
+  m_data = data;
+  m_size = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+void SharedMemoryRegion::close() {
+  if (m_data) {
+    munmap(m_data, m_size);
+  }
+  if (m_handle != -1) {
+    ::close(static_cast<int>(m_handle));
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_handle = -1;
+}
+
+void SharedMemoryRegion::remove(const std::string &name) {
+  shm_unlink(nativeName(name).c_str());
+}
+
+#endif
+
+SkeletonShmReader::SkeletonShmReader(const std::string &name)
+    : m_name(name), m_header(nullptr), m_slots(nullptr), m_slotCount(0) {}
+
+bool SkeletonShmReader::attach() {
+  detach();
+  if (!m_region.open(m_name, false) ||
+      m_region.size() < sizeof(SkeletonShmHeader)) {
+    m_region.close();
+    return false;
+  }
+
+  const SkeletonShmHeader *header =
+      static_cast<const SkeletonShmHeader *>(m_region.data());
+  if (header->magic.load(std::memory_order_acquire) != kSkeletonShmMagic ||
+      header->version != kSkeletonShmVersion ||
+      header->jointCount != ActiveTopology::kNumJoints ||
+      header->maxPeople != kSkeletonShmMaxPeople ||
+      header->slotBytes != sizeof(SkeletonShmSlot) ||
+      header->slotCount == 0 ||
+      m_region.size() < skeletonShmBytes(header->slotCount)) {
+    m_region.close();
+    return false;
+  }
+
+  m_header = header;
+  m_slots = reinterpret_cast<const SkeletonShmSlot *>(
+      static_cast<const char *>(m_region.data()) + sizeof(SkeletonShmHeader));
+  m_slotCount = header->slotCount;
+  return true;
+}
+
+void SkeletonShmReader::detach() {
+  m_region.close();
+  m_header = nullptr;
+  m_slots = nullptr;
+  m_slotCount = 0;
+}
+
+uint64_t SkeletonShmReader::published() const {
+  return m_header ? m_header->published.load(std::memory_order_acquire) : 0;
+}
+
+bool SkeletonShmReader::readLatest(SkeletonShmFrame &frame) const {
+  const size_t headerBytes = offsetof(SkeletonShmFrame, people);
+
+  for (int attempt = 0; attempt < kReadAttempts; attempt++) {
+    const uint64_t published = this->published();
+    if (published == 0) {
+      return false;
+    }
+    const SkeletonShmSlot &slot = m_slots[(published - 1) % m_slotCount];
+    const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1u) {
+      continue;
+    }
+
+    // Header, then only the people actually in the frame
+    std::memcpy(&frame, &slot.frame, headerBytes);
+    uint32_t count = frame.personCount;
+    if (count > kSkeletonShmMaxPeople) {
+      count = kSkeletonShmMaxPeople; // Torn read; rejected below
+    }
+    std::memcpy(frame.people, slot.frame.people,
+                count * sizeof(SkeletonShmPerson));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SkeletonShmReader::waitForFrame(uint64_t seen, int timeout_ms) const {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  int spins = 0;
+  while (published() <= seen) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    // Spin briefly for low latency, then stop burning the core
+    if (++spins < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+  return true;
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,194 @@
+// Shared-memory skeleton ring: layout and reader library
+
+#pragma once
+
+#include "SkeletonTopology.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/*
+ * One writer (the tracker) publishes every frame into a ring of fixed-size
+ * slots in a named shared-memory object; any number of same-host readers map
+ * it read-only. Each slot is guarded by a seqlock: the writer makes the slot
+ * sequence odd, writes the record, then makes it even again. A reader copies
+ * (or inspects in place) and accepts the data only if the sequence was even
+ * and unchanged across the read, so readers never block or slow the writer
+ * and publishing costs no syscall.
+ *
+ * The ring gives readers slotCount - 1 frames of time before the slot they
+ * are reading is reused. Only this header (and SkeletonTopology.h) is needed
+ * to read; no OpenCV or pipeline headers.
+ */
+const uint32_t kSkeletonShmMagic = 0x4D485342; // "BSHM"
+const uint16_t kSkeletonShmVersion = 1;
+const int kSkeletonShmMaxPeople = 32;
+const int kSkeletonShmMaskWords = (ActiveTopology::kNumJoints + 63) / 64;
+
+// Default object name ("/rbp_skeletons" on POSIX, "Local\rbp_skeletons" on
+// Windows)
+const char *const kSkeletonShmDefaultName = "rbp_skeletons";
+
+struct SkeletonShmJoint {
+  float x, y, z;    // Meters, camera frame
+  float confidence; // Keypoint confidence
+};
+
+struct SkeletonShmPerson {
+  int32_t id; // Track id, or index in the frame when untracked
+  float confidence;
+  float bbox[4]; // [x, y, w, h] pixels
+  uint64_t valid[kSkeletonShmMaskWords]; // Bit j: joints[j] has a 3D point
+  SkeletonShmJoint joints[ActiveTopology::kNumJoints];
+
+  bool hasJoint(int joint) const {
+    return (valid[joint >> 6] >> (joint & 63)) & 1u;
+  }
+};
+
+struct SkeletonShmFrame {
+  uint64_t index;           // Publish counter, 0 for the first frame
+  uint64_t frameNumber;     // FrameInfo::frameNumber
+  double sensorTimestampMs; // Device timestamp
+  int64_t captureNs;        // monotonicNowNs() at capture
+  int64_t publishNs;        // monotonicNowNs() when written
+  uint32_t personCount;
+  uint32_t reserved;
+  SkeletonShmPerson people[kSkeletonShmMaxPeople]; // First personCount used
+};
+
+struct alignas(64) SkeletonShmSlot {
+  std::atomic<uint32_t> sequence; // Odd while the writer is in the slot
+  uint32_t reserved;
+  SkeletonShmFrame frame;
+};
+
+struct alignas(64) SkeletonShmHeader {
+  std::atomic<uint32_t> magic; // Stored last, once the layout is valid
+  uint16_t version;
+  uint16_t jointCount;
+  uint32_t maxPeople;
+  uint32_t slotCount;
+  uint64_t slotBytes;
+  alignas(64) std::atomic<uint64_t> published; // Frames published so far
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory atomics must be lock-free (address-free)");
+
+inline size_t skeletonShmBytes(uint32_t slotCount) {
+  return sizeof(SkeletonShmHeader) + slotCount * sizeof(SkeletonShmSlot);
+}
+
+/**
+ * @brief A named shared-memory mapping (POSIX shm_open / Windows file
+ *        mapping)
+ */
+class SharedMemoryRegion {
+public:
+  SharedMemoryRegion();
+  ~SharedMemoryRegion();
+
+  SharedMemoryRegion(const SharedMemoryRegion &) = delete;
+  SharedMemoryRegion &operator=(const SharedMemoryRegion &) = delete;
+
+  // Create (or resize) and map read-write; new contents are zero
+  bool create(const std::string &name, size_t size);
+
+  // Map an existing object; read-only unless writable
+  bool open(const std::string &name, bool writable);
+
+  void close();
+
+  // Remove the name so the next create() starts fresh (no-op on Windows,
+  // where the object goes away with its last handle)
+  static void remove(const std::string &name);
+
+  void *data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  void *m_data;
+  size_t m_size;
+  intptr_t m_handle; // fd on POSIX, HANDLE on Windows
+};
+
+/**
+ * @brief Attaches to a running tracker's skeleton ring
+ *
+ * Reading takes no locks and no syscalls. readLatest() copies the newest
+ * frame (header plus the people in it); visitLatest() hands the slot to a
+ * callback in place for zero-copy consumers.
+ */
+class SkeletonShmReader {
+public:
+  explicit SkeletonShmReader(const std::string &name = kSkeletonShmDefaultName);
+
+  /**
+   * @brief Map the ring
+   * @return false if no writer has created it yet, or it was built for a
+   *         different topology / version
+   */
+  bool attach();
+
+  void detach();
+
+  bool isAttached() const { return m_header != nullptr; }
+
+  // Frames published so far (the newest has index published() - 1)
+  uint64_t published() const;
+
+  /**
+   * @brief Copy the newest frame
+   * @return false if nothing was published yet or the writer kept
+   *         overwriting the slot (retry later)
+   */
+  bool readLatest(SkeletonShmFrame &frame) const;
+
+  /**
+   * @brief Wait until more than seen frames are published
+   *
+   * Pass frame.index + 1 after a read (0 before the first). Polls the
+   * publish counter, sleeping between checks when nothing is new.
+   *
+   * @return false on timeout
+   */
+  bool waitForFrame(uint64_t seen, int timeout_ms) const;
+
+  /**
+   * @brief Inspect the newest frame in place
+   *
+   * visit(const SkeletonShmFrame &) runs on the shared slot; the writer may
+   * change it underneath, so act on what visit() gathered only when this
+   * returns true.
+   *
+   * @return true if the slot was stable for the whole visit
+   */
+  template <typename Visitor> bool visitLatest(Visitor &&visit) const {
+    const uint64_t published = this->published();
+    if (published == 0) {
+      return false;
+    }
+    const SkeletonShmSlot &slot = m_slots[(published - 1) % m_slotCount];
+    const uint32_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before & 1u) {
+      return false;
+    }
+    visit(slot.frame);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == before;
+  }
+
+private:
+  std::string m_name;
+  SharedMemoryRegion m_region;
+  const SkeletonShmHeader *m_header;
+  const SkeletonShmSlot *m_slots;
+  uint32_t m_slotCount;
+};
+
+} // namespace RealsenseBodyPose
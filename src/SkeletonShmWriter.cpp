@@ -0,0 +1,135 @@
+// Skeleton Shared Memory Writer Implementation
+
+#include "SkeletonShmWriter.h"
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+static_assert(kSkeletonShmMaxPeople == kMaxPeople,
+              "Shared-memory records must hold a full batch");
+
+namespace {
+
+bool isCompatible(const SkeletonShmHeader &header, size_t regionSize,
+                  uint32_t slotCount) {
+  return header.magic.load(std::memory_order_acquire) == kSkeletonShmMagic &&
+         header.version == kSkeletonShmVersion &&
+         header.jointCount == kNumJoints &&
+         header.maxPeople == kSkeletonShmMaxPeople &&
+         header.slotBytes == sizeof(SkeletonShmSlot) &&
+         header.slotCount == slotCount &&
+         regionSize >= skeletonShmBytes(slotCount);
+}
+
+} // namespace
+
+SkeletonShmWriter::SkeletonShmWriter(const Config &config)
+    : m_config(config), m_header(nullptr), m_slots(nullptr) {}
+
+bool SkeletonShmWriter::initialize() {
+  if (m_config.slotCount < 2) {
+    m_config.slotCount = 2;
+  }
+  const size_t bytes = skeletonShmBytes(m_config.slotCount);
+
+  // Keep a compatible ring (and its attached readers) from a previous run
+  bool reused = m_region.open(m_config.name, true) &&
+                isCompatible(*static_cast<SkeletonShmHeader *>(m_region.data()),
+                             m_region.size(), m_config.slotCount);
+  if (!reused) {
+    m_region.close();
+    SharedMemoryRegion::remove(m_config.name);
+    if (!m_region.create(m_config.name, bytes)) {
+      return false;
+    }
+  }
+
+  SkeletonShmHeader *header = static_cast<SkeletonShmHeader *>(m_region.data());
+  m_slots = reinterpret_cast<SkeletonShmSlot *>(
+      static_cast<char *>(m_region.data()) + sizeof(SkeletonShmHeader));
+
+  if (!reused) {
+    if (header->magic.load(std::memory_order_relaxed) != 0) {
+      // Windows: an incompatible ring is still held open by a reader
+      m_region.close();
+      return false;
+    }
+    header->version = kSkeletonShmVersion;
+    header->jointCount = static_cast<uint16_t>(kNumJoints);
+    header->maxPeople = kSkeletonShmMaxPeople;
+    header->slotCount = m_config.slotCount;
+    header->slotBytes = sizeof(SkeletonShmSlot);
+    header->published.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < m_config.slotCount; i++) {
+      m_slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    // Readers check the magic first; everything above is visible once it is
+    header->magic.store(kSkeletonShmMagic, std::memory_order_release);
+  } else {
+    // A writer that died mid-publish left its slot odd, which would flip
+    // the seqlock parity for good. Step to the next even value rather than
+    // back to the last one, so a reader that saw it cannot mistake the torn
+    // record for the old one (the torn slot is the next one written anyway)
+    for (uint32_t i = 0; i < m_config.slotCount; i++) {
+      const uint32_t sequence =
+          m_slots[i].sequence.load(std::memory_order_relaxed);
+      if (sequence & 1u) {
+        m_slots[i].sequence.store(sequence + 1, std::memory_order_release);
+      }
+    }
+  }
+
+  m_header = header;
+  return true;
+}
+
+void SkeletonShmWriter::publish(const SkeletonBatch &skeletons,
+                                const FrameInfo *info) {
+  if (!m_header) {
+    return;
+  }
+
+  const uint64_t index = m_header->published.load(std::memory_order_relaxed);
+  SkeletonShmSlot &slot = m_slots[index % m_config.slotCount];
+
+  // Seqlock: odd while writing; the fence keeps the record stores after it
+  const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  SkeletonShmFrame &frame = slot.frame;
+  frame.index = index;
+  frame.frameNumber = info ? info->frameNumber : 0;
+  frame.sensorTimestampMs = info ? info->sensorTimestampMs : 0.0;
+  frame.captureNs = info ? info->captureNs : 0;
+  frame.personCount = static_cast<uint32_t>(skeletons.size());
+
+  for (int i = 0; i < skeletons.size(); i++) {
+    const SkeletonView skel = skeletons[i];
+    SkeletonShmPerson &person = frame.people[i];
+    person.id = skel.publicId();
+    person.confidence = skel.confidence();
+    std::memcpy(person.bbox, skel.bbox(), sizeof(person.bbox));
+    std::memset(person.valid, 0, sizeof(person.valid));
+
+    for (int j = 0; j < kNumJoints; j++) {
+      SkeletonShmJoint &joint = person.joints[j];
+      if (!skel.hasKeypoint3D(j)) {
+        joint.x = joint.y = joint.z = joint.confidence = 0.0f;
+        continue;
+      }
+      const Keypoint3D k3d = skel.keypoint3D(j);
+      joint.x = k3d.x;
+      joint.y = k3d.y;
+      joint.z = k3d.z;
+      joint.confidence = k3d.confidence;
+      person.valid[j >> 6] |= uint64_t(1) << (j & 63);
+    }
+  }
+  frame.publishNs = monotonicNowNs();
+
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  m_header->published.store(index + 1, std::memory_order_release);
+}
+
+} // namespace RealsenseBodyPose
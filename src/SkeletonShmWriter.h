@@ -0,0 +1,57 @@
+// Publishes skeletons into the shared-memory ring (SkeletonShm.h)
+
+#pragma once
+
+#include "SkeletonBatch.h"
+#include "SkeletonShm.h"
+#include "Utils.h"
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Writer side of the shared-memory skeleton ring
+ *
+ * publish() writes one fixed-size record per frame with plain stores under
+ * the slot's seqlock: no syscall, no allocation, and no waiting on readers.
+ * A compatible ring left by a previous run is reused, so readers stay
+ * attached across tracker restarts; otherwise it is recreated.
+ */
+class SkeletonShmWriter {
+public:
+  struct Config {
+    std::string name = kSkeletonShmDefaultName;
+    uint32_t slotCount = 8; // Frames a slow reader has before reuse
+    Config() {}
+  };
+
+  explicit SkeletonShmWriter(const Config &config = Config());
+
+  SkeletonShmWriter(const SkeletonShmWriter &) = delete;
+  SkeletonShmWriter &operator=(const SkeletonShmWriter &) = delete;
+
+  /**
+   * @brief Create or reuse the shared-memory object
+   * @return false if it could not be created or mapped
+   */
+  bool initialize();
+
+  bool isInitialized() const { return m_header != nullptr; }
+
+  /**
+   * @brief Publish one frame (empty batches too, so readers see people leave)
+   * @param skeletons People in the frame
+   * @param info Frame lineage, or nullptr
+   */
+  void publish(const SkeletonBatch &skeletons, const FrameInfo *info);
+
+  const std::string &name() const { return m_config.name; }
+
+private:
+  Config m_config;
+  SharedMemoryRegion m_region;
+  SkeletonShmHeader *m_header;
+  SkeletonShmSlot *m_slots;
+};
+
+} // namespace RealsenseBodyPose
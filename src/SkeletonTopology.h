@@ -0,0 +1,199 @@
+// Compile-time skeleton topologies (joint count, bones, names, OKS sigmas)
+
+#pragma once
+
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief A bone drawn between two joints
+ */
+struct Bone {
+  int from;
+  int to;
+};
+
+/*
+ * Each topology is a trait struct with:
+ *   kNumJoints          Keypoints per person (constexpr, sizes every array)
+ *   kName               Human-readable layout name
+ *   kBones / kNumBones  Bones drawn by the visualizer
+ *   kJointNames         One name per joint (CSV headers, logs)
+ *   kSigmas             Per-joint OKS standard deviations
+ *
+ * Every topology starts with the 17 COCO body joints in COCO order, so
+ * JointType indices and code that only looks at the body (UDP key joints,
+ * 3D printout) work unchanged whichever layout is active.
+ */
+
+/**
+ * @brief COCO 17-keypoint body (YOLOv8-Pose default)
+ */
+struct Coco17 {
+  static constexpr int kNumJoints = 17;
+  static constexpr const char *kName = "COCO-17";
+
+  static constexpr Bone kBones[] = {
+      {0, 1},   {0, 2},   {1, 3},   {2, 4},   // Face
+      {5, 6},   {5, 11},  {6, 12},  {11, 12}, // Torso
+      {5, 7},   {7, 9},   {6, 8},   {8, 10},  // Arms
+      {11, 13}, {13, 15}, {12, 14}, {14, 16}  // Legs
+  };
+  static constexpr int kNumBones = sizeof(kBones) / sizeof(kBones[0]);
+
+  static constexpr const char *kJointNames[kNumJoints] = {
+      "Nose",        "Left Eye",      "Right Eye",      "Left Ear",
+      "Right Ear",   "Left Shoulder", "Right Shoulder", "Left Elbow",
+      "Right Elbow", "Left Wrist",    "Right Wrist",    "Left Hip",
+      "Right Hip",   "Left Knee",     "Right Knee",     "Left Ankle",
+      "Right Ankle"};
+
+  static constexpr float kSigmas[kNumJoints] = {
+      0.026f, 0.025f, 0.025f, 0.035f, 0.035f, 0.079f, 0.079f, 0.072f, 0.072f,
+      0.062f, 0.062f, 0.107f, 0.107f, 0.087f, 0.087f, 0.089f, 0.089f};
+};
+
+/**
+ * @brief Halpe 26-keypoint body: COCO plus head, neck, hip and feet
+ */
+struct Halpe26 {
+  static constexpr int kNumJoints = 26;
+  static constexpr const char *kName = "Halpe-26";
+
+  static constexpr Bone kBones[] = {
+      {0, 1},   {0, 2},   {1, 3},   {2, 4},   // Face
+      {5, 6},   {5, 11},  {6, 12},  {11, 12}, // Torso
+      {5, 7},   {7, 9},   {6, 8},   {8, 10},  // Arms
+      {11, 13}, {13, 15}, {12, 14}, {14, 16}, // Legs
+      {17, 18}, {18, 19},                     // Head -> neck -> hip
+      {15, 20}, {15, 22}, {15, 24},           // Left foot
+      {16, 21}, {16, 23}, {16, 25}            // Right foot
+  };
+  static constexpr int kNumBones = sizeof(kBones) / sizeof(kBones[0]);
+
+  static constexpr const char *kJointNames[kNumJoints] = {
+      "Nose",          "Left Eye",       "Right Eye",      "Left Ear",
+      "Right Ear",     "Left Shoulder",  "Right Shoulder", "Left Elbow",
+      "Right Elbow",   "Left Wrist",     "Right Wrist",    "Left Hip",
+      "Right Hip",     "Left Knee",      "Right Knee",     "Left Ankle",
+      "Right Ankle",   "Head",           "Neck",           "Hip",
+      "Left Big Toe",  "Right Big Toe",  "Left Small Toe", "Right Small Toe",
+      "Left Heel",     "Right Heel"};
+
+  static constexpr float kSigmas[kNumJoints] = {
+      0.026f, 0.025f, 0.025f, 0.035f, 0.035f, 0.079f, 0.079f, 0.072f, 0.072f,
+      0.062f, 0.062f, 0.107f, 0.107f, 0.087f, 0.087f, 0.089f, 0.089f, 0.080f,
+      0.080f, 0.080f, 0.089f, 0.089f, 0.089f, 0.089f, 0.089f, 0.089f};
+};
+
+/**
+ * @brief COCO-WholeBody 133 keypoints: body, feet, 68 face landmarks and
+ *        21 landmarks per hand
+ *
+ * Face landmarks are drawn as points only; hands are connected to the
+ * wrists and drawn finger by finger.
+ */
+struct WholeBody133 {
+  static constexpr int kNumJoints = 133;
+  static constexpr const char *kName = "COCO-WholeBody-133";
+
+  static constexpr Bone kBones[] = {
+      {0, 1},   {0, 2},   {1, 3},   {2, 4},   // Face
+      {5, 6},   {5, 11},  {6, 12},  {11, 12}, // Torso
+      {5, 7},   {7, 9},   {6, 8},   {8, 10},  // Arms
+      {11, 13}, {13, 15}, {12, 14}, {14, 16}, // Legs
+      {15, 17}, {15, 18}, {15, 19},           // Left foot
+      {16, 20}, {16, 21}, {16, 22},           // Right foot
+      // Hands: wrist -> hand root, then thumb to little finger
+      {9, 91}, {91, 92}, {92, 93}, {93, 94}, {94, 95}, {91, 96}, {96, 97},
+      {97, 98}, {98, 99}, {91, 100}, {100, 101}, {101, 102}, {102, 103},
+      {91, 104}, {104, 105}, {105, 106}, {106, 107}, {91, 108}, {108, 109},
+      {109, 110}, {110, 111}, {10, 112}, {112, 113}, {113, 114}, {114, 115},
+      {115, 116}, {112, 117}, {117, 118}, {118, 119}, {119, 120}, {112, 121},
+      {121, 122}, {122, 123}, {123, 124}, {112, 125}, {125, 126}, {126, 127},
+      {127, 128}, {112, 129}, {129, 130}, {130, 131}, {131, 132}};
+  static constexpr int kNumBones = sizeof(kBones) / sizeof(kBones[0]);
+
+  static constexpr const char *kJointNames[kNumJoints] = {
+      "Nose", "Left Eye", "Right Eye", "Left Ear", "Right Ear", "Left Shoulder",
+      "Right Shoulder", "Left Elbow", "Right Elbow", "Left Wrist",
+      "Right Wrist", "Left Hip", "Right Hip", "Left Knee", "Right Knee",
+      "Left Ankle", "Right Ankle", "Left Big Toe", "Left Small Toe",
+      "Left Heel", "Right Big Toe", "Right Small Toe", "Right Heel", "Face 0",
+      "Face 1", "Face 2", "Face 3", "Face 4", "Face 5", "Face 6", "Face 7",
+      "Face 8", "Face 9", "Face 10", "Face 11", "Face 12", "Face 13", "Face 14",
+      "Face 15", "Face 16", "Face 17", "Face 18", "Face 19", "Face 20",
+      "Face 21", "Face 22", "Face 23", "Face 24", "Face 25", "Face 26",
+      "Face 27", "Face 28", "Face 29", "Face 30", "Face 31", "Face 32",
+      "Face 33", "Face 34", "Face 35", "Face 36", "Face 37", "Face 38",
+      "Face 39", "Face 40", "Face 41", "Face 42", "Face 43", "Face 44",
+      "Face 45", "Face 46", "Face 47", "Face 48", "Face 49", "Face 50",
+      "Face 51", "Face 52", "Face 53", "Face 54", "Face 55", "Face 56",
+      "Face 57", "Face 58", "Face 59", "Face 60", "Face 61", "Face 62",
+      "Face 63", "Face 64", "Face 65", "Face 66", "Face 67", "Left Hand 0",
+      "Left Hand 1", "Left Hand 2", "Left Hand 3", "Left Hand 4", "Left Hand 5",
+      "Left Hand 6", "Left Hand 7", "Left Hand 8", "Left Hand 9",
+      "Left Hand 10", "Left Hand 11", "Left Hand 12", "Left Hand 13",
+      "Left Hand 14", "Left Hand 15", "Left Hand 16", "Left Hand 17",
+      "Left Hand 18", "Left Hand 19", "Left Hand 20", "Right Hand 0",
+      "Right Hand 1", "Right Hand 2", "Right Hand 3", "Right Hand 4",
+      "Right Hand 5", "Right Hand 6", "Right Hand 7", "Right Hand 8",
+      "Right Hand 9", "Right Hand 10", "Right Hand 11", "Right Hand 12",
+      "Right Hand 13", "Right Hand 14", "Right Hand 15", "Right Hand 16",
+      "Right Hand 17", "Right Hand 18", "Right Hand 19", "Right Hand 20"};
+
+  // COCO-WholeBody evaluation sigmas
+  static constexpr float kSigmas[kNumJoints] = {
+      // Body and feet
+      0.026f, 0.025f, 0.025f, 0.035f, 0.035f, 0.079f, 0.079f, 0.072f, 0.072f,
+      0.062f, 0.062f, 0.107f, 0.107f, 0.087f, 0.087f, 0.089f, 0.089f, 0.068f,
+      0.066f, 0.066f, 0.092f, 0.094f, 0.094f,
+      // Face
+      0.042f, 0.043f, 0.044f, 0.043f, 0.040f, 0.035f, 0.031f, 0.025f, 0.020f,
+      0.023f, 0.029f, 0.032f, 0.037f, 0.038f, 0.043f, 0.041f, 0.045f, 0.013f,
+      0.012f, 0.011f, 0.011f, 0.012f, 0.012f, 0.011f, 0.011f, 0.013f, 0.015f,
+      0.009f, 0.007f, 0.007f, 0.007f, 0.012f, 0.009f, 0.008f, 0.016f, 0.010f,
+      0.017f, 0.011f, 0.009f, 0.011f, 0.009f, 0.007f, 0.013f, 0.008f, 0.011f,
+      0.012f, 0.010f, 0.034f, 0.008f, 0.008f, 0.009f, 0.008f, 0.008f, 0.007f,
+      0.010f, 0.008f, 0.009f, 0.009f, 0.009f, 0.007f, 0.007f, 0.008f, 0.011f,
+      0.008f, 0.008f, 0.008f, 0.010f, 0.008f,
+      // Left and right hand
+      0.029f, 0.022f, 0.035f, 0.037f, 0.047f, 0.026f, 0.025f, 0.024f, 0.035f,
+      0.018f, 0.024f, 0.022f, 0.026f, 0.017f, 0.021f, 0.021f, 0.032f, 0.020f,
+      0.019f, 0.022f, 0.031f, 0.029f, 0.022f, 0.035f, 0.037f, 0.047f, 0.026f,
+      0.025f, 0.024f, 0.035f, 0.018f, 0.024f, 0.022f, 0.026f, 0.017f, 0.021f,
+      0.021f, 0.032f, 0.020f, 0.019f, 0.022f, 0.031f};
+};
+
+#if defined(RBP_TOPOLOGY_WHOLEBODY133)
+using ActiveTopology = WholeBody133;
+#elif defined(RBP_TOPOLOGY_HALPE26)
+using ActiveTopology = Halpe26;
+#else
+using ActiveTopology = Coco17; // Default (RBP_TOPOLOGY_COCO17)
+#endif
+
+/**
+ * @brief Channels of a YOLO-Pose output for a topology
+ *
+ * [x, y, w, h, confidence] followed by (x, y, confidence) per joint.
+ */
+template <typename Topology>
+constexpr int kPoseOutputChannels = 5 + 3 * Topology::kNumJoints;
+
+/**
+ * @brief Joint name in a topology, "Unknown" when out of range
+ */
+template <typename Topology> const char *jointName(int index) {
+  return (index >= 0 && index < Topology::kNumJoints)
+             ? Topology::kJointNames[index]
+             : "Unknown";
+}
+
+// Joint name lookup in the active topology
+inline std::string getJointName(int index) {
+  return jointName<ActiveTopology>(index);
+}
+
+} // namespace RealsenseBodyPose
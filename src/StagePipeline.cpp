@@ -0,0 +1,208 @@
+// Stage Pipeline Implementation
+
+#include "StagePipeline.h"
+#include "FrameMat.h"
+#include <sstream>
+#include <stdexcept>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// How long an idle stage waits before re-checking for shutdown
+const int kPollMs = 50;
+
+// Enough packets to cover every queue in a short pipeline
+const size_t kRecycledPackets = 8;
+
+} // namespace
+
+StagePipeline::StagePipeline()
+    : sourceFrames_(0), recycled_(kRecycledPackets), stopRequested_(false),
+      aborted_(false), endOfInput_(false), failed_(false), started_(false) {}
+
+StagePipeline::~StagePipeline() {
+  abort();
+  join();
+}
+
+void StagePipeline::setSource(const std::string &name, SourceFn fn) {
+  sourceName_ = name;
+  source_ = std::move(fn);
+}
+
+void StagePipeline::addStage(const std::string &name, StageFn fn,
+                             const EdgeConfig &input) {
+  if (started_) {
+    throw std::runtime_error("Cannot add stages to a running pipeline");
+  }
+  edges_.push_back(std::make_unique<Edge>(input));
+  stages_.push_back(std::make_unique<Stage>(name, std::move(fn)));
+}
+
+void StagePipeline::setOutput(const EdgeConfig &output) {
+  outputConfig_ = output;
+}
+
+void StagePipeline::start() {
+  if (!source_) {
+    throw std::runtime_error("Pipeline has no source");
+  }
+  if (started_) {
+    throw std::runtime_error("Pipeline already started");
+  }
+  started_ = true;
+
+  edges_.push_back(std::make_unique<Edge>(outputConfig_));
+
+  for (size_t i = 0; i < stages_.size(); i++) {
+    stages_[i]->thread = std::thread(&StagePipeline::stageLoop, this, i);
+  }
+  sourceThread_ = std::thread(&StagePipeline::sourceLoop, this);
+
+  appLog(LogLevel::INFO, "✅ Pipeline running: " + sourceName_ + " + " +
+                             std::to_string(stages_.size()) + " stages");
+}
+
+void StagePipeline::stop() { stopRequested_ = true; }
+
+void StagePipeline::abort() {
+  stopRequested_ = true;
+  aborted_ = true;
+}
+
+void StagePipeline::join() {
+  if (sourceThread_.joinable()) {
+    sourceThread_.join();
+  }
+  for (auto &stage : stages_) {
+    if (stage->thread.joinable()) {
+      stage->thread.join();
+    }
+  }
+}
+
+void StagePipeline::sourceLoop() {
+  Edge &out = *edges_.front();
+
+  while (!stopRequested_) {
+    FramePacket packet;
+    recycled_.tryPop(packet);
+
+    SourceResult result;
+    try {
+      result = source_(packet);
+    } catch (const std::exception &e) {
+      fail(sourceName_, e);
+      break;
+    }
+    if (result == SourceResult::END_OF_INPUT) {
+      endOfInput_ = true;
+      break;
+    }
+    if (result == SourceResult::NO_FRAME) {
+      continue;
+    }
+    sourceFrames_++;
+    out.ring.push(packet, out.config.policy, aborted_, out.dropped);
+  }
+
+  out.closed.store(true, std::memory_order_release);
+}
+
+void StagePipeline::stageLoop(size_t index) {
+  Stage &stage = *stages_[index];
+  Edge &in = *edges_[index];
+  Edge &out = *edges_[index + 1];
+  const bool latestOnly = in.config.policy == OverflowPolicy::LATEST_ONLY;
+
+  while (!aborted_) {
+    FramePacket packet;
+    if (!in.ring.waitPop(packet, kPollMs, latestOnly, in.dropped)) {
+      // The producer closes its edge after its last push, so a closed and
+      // empty edge means everything upstream has been drained
+      if (!in.closed.load(std::memory_order_acquire)) {
+        continue;
+      }
+      if (!in.ring.tryPop(packet)) {
+        break;
+      }
+    }
+
+    int64_t startNs = monotonicNowNs();
+    try {
+      stage.fn(packet);
+    } catch (const std::exception &e) {
+      fail(stage.name, e);
+      break;
+    }
+    stage.busyNs += monotonicNowNs() - startNs;
+    stage.processed++;
+
+    out.ring.push(packet, out.config.policy, aborted_, out.dropped);
+  }
+
+  out.closed.store(true, std::memory_order_release);
+}
+
+void StagePipeline::fail(const std::string &stage, const std::exception &e) {
+  appLog(LogLevel::ERR, "Stage '" + stage + "' failed: " + e.what());
+  failed_ = true;
+  abort();
+}
+
+bool StagePipeline::poll(FramePacket &packet, int timeout_ms) {
+  if (!started_) {
+    return false;
+  }
+  Edge &out = *edges_.back();
+  const bool latestOnly = out.config.policy == OverflowPolicy::LATEST_ONLY;
+  if (out.ring.waitPop(packet, timeout_ms, latestOnly, out.dropped)) {
+    return true;
+  }
+  return out.closed.load(std::memory_order_acquire) && out.ring.tryPop(packet);
+}
+
+void StagePipeline::recycle(FramePacket &packet) {
+  // Zero-copy views would pin librealsense frames while pooled and starve
+  // its frame pool; only buffers of our own are worth keeping
+  if (isFrameView(packet.color)) {
+    packet.color.release();
+  }
+  if (isFrameView(packet.depth)) {
+    packet.depth.release();
+  }
+  // A full pool just lets this packet be freed
+  recycled_.tryPush(packet);
+}
+
+bool StagePipeline::isDrained() const {
+  if (!started_) {
+    return false;
+  }
+  const Edge &out = *edges_.back();
+  return out.closed.load(std::memory_order_acquire) && out.ring.size() == 0;
+}
+
+std::string StagePipeline::summary() const {
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << "Stages: " << sourceName_ << " " << sourceFrames_.load();
+  for (size_t i = 0; i < stages_.size(); i++) {
+    const Stage &stage = *stages_[i];
+    size_t processed = stage.processed.load();
+    double avgMs = processed > 0 ? stage.busyNs.load() / 1e6 / processed : 0.0;
+    ss << " | " << stage.name << " " << processed << " (" << avgMs << " ms";
+    size_t dropped = edges_[i]->dropped.load();
+    if (dropped > 0) {
+      ss << ", " << dropped << " dropped";
+    }
+    ss << ")";
+  }
+  if (started_ && edges_.back()->dropped.load() > 0) {
+    ss << " | output " << edges_.back()->dropped.load() << " dropped";
+  }
+  return ss.str();
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,202 @@
+// Pipelined stage executor: one thread per stage, bounded queues between
+
+#pragma once
+
+#include "FrameRing.h"
+#include "SkeletonBatch.h"
+#include "Utils.h"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief Everything known about one frame as it moves through the stages
+ */
+struct FramePacket {
+  cv::Mat color;
+  cv::Mat depth;
+  FrameInfo info;
+  SkeletonBatch skeletons;
+};
+
+/**
+ * @brief Runs source -> stage -> ... -> output on separate threads
+ *
+ * Each stage owns a thread and reads from a bounded FrameRing fed by the
+ * previous one, so frame N+1 can be captured while frame N is in inference
+ * and frame N-1 is being projected and sent; throughput is bounded by the
+ * slowest stage rather than the sum of all of them. Every edge has its own
+ * capacity and OverflowPolicy (e.g. LATEST_ONLY into inference so it always
+ * works on the freshest frame, BLOCK after it so no result is lost).
+ *
+ * The last edge is consumed by the caller through poll(), which keeps
+ * HighGUI on the main thread; packets handed back with recycle() are
+ * reused by the source. stop() stops pulling new frames and lets
+ * everything already in flight drain through the remaining stages.
+ */
+class StagePipeline {
+public:
+  /**
+   * @brief Outcome of one source call
+   */
+  enum class SourceResult {
+    FRAME,       // Packet filled
+    NO_FRAME,    // Nothing this time (timeout); try again
+    END_OF_INPUT // Source exhausted; drain and finish
+  };
+
+  using SourceFn = std::function<SourceResult(FramePacket &)>;
+  using StageFn = std::function<void(FramePacket &)>;
+
+  /**
+   * @brief Queue feeding a stage (or the output)
+   */
+  struct EdgeConfig {
+    size_t capacity = 2;
+    OverflowPolicy policy = OverflowPolicy::BLOCK;
+
+    EdgeConfig() {}
+    EdgeConfig(size_t cap, OverflowPolicy p) : capacity(cap), policy(p) {}
+  };
+
+  StagePipeline();
+
+  /**
+   * @brief Destructor (aborts without draining if still running)
+   */
+  ~StagePipeline();
+
+  StagePipeline(const StagePipeline &) = delete;
+  StagePipeline &operator=(const StagePipeline &) = delete;
+
+  /**
+   * @brief Set the producing stage (runs on its own thread)
+   */
+  void setSource(const std::string &name, SourceFn fn);
+
+  /**
+   * @brief Append a processing stage
+   * @param input Queue between the previous stage and this one
+   */
+  void addStage(const std::string &name, StageFn fn, const EdgeConfig &input);
+
+  /**
+   * @brief Configure the queue from the last stage to poll()
+   */
+  void setOutput(const EdgeConfig &output);
+
+  /**
+   * @brief Launch all stage threads
+   * @throws std::runtime_error if no source is set or already started
+   */
+  void start();
+
+  /**
+   * @brief Stop pulling from the source; queued frames still drain
+   */
+  void stop();
+
+  /**
+   * @brief Stop immediately, discarding frames in flight
+   */
+  void abort();
+
+  /**
+   * @brief Wait for all stage threads to exit
+   */
+  void join();
+
+  /**
+   * @brief Take the next finished packet (caller thread)
+   * @return false on timeout or once drained
+   */
+  bool poll(FramePacket &packet, int timeout_ms);
+
+  /**
+   * @brief Hand a displayed packet back for reuse (caller thread)
+   *
+   * The source fills recycled packets in place, so image buffers and other
+   * per-frame storage are reused instead of reallocated every frame. Images
+   * that are zero-copy views of librealsense frames are released first, so
+   * pooled packets never hold frames the camera needs back.
+   */
+  void recycle(FramePacket &packet);
+
+  /**
+   * @brief True once every stage has exited and the output is empty
+   */
+  bool isDrained() const;
+
+  /**
+   * @brief True if the source reported END_OF_INPUT
+   */
+  bool isEndOfInput() const { return endOfInput_.load(); }
+
+  /**
+   * @brief True if a stage threw; the pipeline aborted after logging it
+   */
+  bool hasFailed() const { return failed_.load(); }
+
+  /**
+   * @brief One-line per-stage throughput, service time and queue drops
+   */
+  std::string summary() const;
+
+private:
+  struct Edge {
+    FrameRing<FramePacket> ring;
+    EdgeConfig config;
+    std::atomic<bool> closed; // Producer has exited; nothing more will come
+    std::atomic<size_t> dropped;
+
+    explicit Edge(const EdgeConfig &cfg)
+        : ring(cfg.capacity), config(cfg), closed(false), dropped(0) {}
+  };
+
+  struct Stage {
+    std::string name;
+    StageFn fn;
+    std::thread thread;
+    std::atomic<size_t> processed;
+    std::atomic<int64_t> busyNs;
+
+    Stage(const std::string &n, StageFn f)
+        : name(n), fn(std::move(f)), processed(0), busyNs(0) {}
+  };
+
+  std::string sourceName_;
+  SourceFn source_;
+  std::thread sourceThread_;
+  std::atomic<size_t> sourceFrames_;
+
+  // edges_[i] feeds stages_[i]; the final edge feeds poll()
+  std::vector<std::unique_ptr<Stage>> stages_;
+  std::vector<std::unique_ptr<Edge>> edges_;
+  EdgeConfig outputConfig_;
+
+  // Finished packets returned by the caller, refilled by the source
+  FrameRing<FramePacket> recycled_;
+
+  std::atomic<bool> stopRequested_;
+  std::atomic<bool> aborted_;
+  std::atomic<bool> endOfInput_;
+  std::atomic<bool> failed_;
+  bool started_;
+
+  void sourceLoop();
+  void stageLoop(size_t index);
+
+  /**
+   * @brief Log a stage exception and abort the pipeline
+   */
+  void fail(const std::string &stage, const std::exception &e);
+};
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,124 @@
+// Synthetic Source Implementation
+
+#include "SyntheticSource.h"
+#include "SkeletonTopology.h"
+#include "Utils.h"
+#include <cmath>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Standing pose in units of body height, relative to the top of the head
+// (COCO order; a figure facing the camera has its left side on image right)
+const float kPoseTemplate[17][2] = {
+    {0.00f, 0.06f},  {0.02f, 0.04f},  {-0.02f, 0.04f}, {0.04f, 0.05f},
+    {-0.04f, 0.05f}, {0.11f, 0.18f},  {-0.11f, 0.18f}, {0.15f, 0.33f},
+    {-0.15f, 0.33f}, {0.17f, 0.47f},  {-0.17f, 0.47f}, {0.07f, 0.52f},
+    {-0.07f, 0.52f}, {0.08f, 0.74f},  {-0.08f, 0.74f}, {0.08f, 0.96f},
+    {-0.08f, 0.96f}};
+
+const uint16_t kBackgroundDepth = 4500; // Back wall at 4.5m (depth units)
+
+} // namespace
+
+SyntheticSource::SyntheticSource(const Config &config)
+    : config_(config), intrinsics_(), frameIndex_(0), running_(false),
+      pacer_(config.fps, config.realTime) {
+  // Pinhole model with a D4xx-like 69 degree horizontal field of view
+  const float hfov = 69.0f * static_cast<float>(CV_PI) / 180.0f;
+  intrinsics_.width = config_.width;
+  intrinsics_.height = config_.height;
+  intrinsics_.fx = intrinsics_.fy =
+      config_.width / (2.0f * std::tan(hfov / 2.0f));
+  intrinsics_.ppx = config_.width / 2.0f;
+  intrinsics_.ppy = config_.height / 2.0f;
+  intrinsics_.model = RS2_DISTORTION_NONE;
+}
+
+void SyntheticSource::start() {
+  frameIndex_ = 0;
+  running_ = true;
+  pacer_.reset();
+  appLog(LogLevel::INFO, "✅ Synthetic source ready: " +
+                             std::to_string(config_.width) + "x" +
+                             std::to_string(config_.height) + ", " +
+                             std::to_string(config_.people) + " people" +
+                             (config_.realTime ? " (real time)"
+                                               : " (as fast as possible)"));
+}
+
+void SyntheticSource::stop() { running_ = false; }
+
+bool SyntheticSource::isFinished() const {
+  return config_.frameCount > 0 && frameIndex_ >= config_.frameCount;
+}
+
+void SyntheticSource::renderPerson(cv::Mat &colorImage, cv::Mat &depthImage,
+                                   int person) {
+  const float phase = frameIndex_ * 0.05f + person * 1.7f;
+
+  // Each figure stands one meter further back than the previous one
+  const float distance = 1.5f + person * 1.0f;
+  const float bodyHeight = 1.7f * intrinsics_.fy / distance;
+  const float centerX =
+      config_.width * (0.5f + 0.3f * std::sin(phase * 0.4f));
+  const float top = config_.height * 0.5f - bodyHeight * 0.5f;
+  const uint16_t depth = static_cast<uint16_t>(distance * 1000.0f);
+
+  cv::Point joints[17];
+  for (int k = 0; k < 17; k++) {
+    float swing = 0.0f;
+    if (k >= 7 && k <= 10) {
+      swing = 0.04f * std::sin(phase) * ((k % 2) ? 1.0f : -1.0f);
+    } else if (k >= 13) {
+      swing = 0.03f * std::sin(phase) * ((k % 2) ? -1.0f : 1.0f);
+    }
+    joints[k] = cv::Point(
+        static_cast<int>(centerX + (kPoseTemplate[k][0] + swing) * bodyHeight),
+        static_cast<int>(top + kPoseTemplate[k][1] * bodyHeight));
+  }
+
+  const int limb = std::max(2, static_cast<int>(bodyHeight * 0.05f));
+  const cv::Scalar skin(150, 170, 210);
+  for (const Bone &bone : Coco17::kBones) {
+    cv::line(colorImage, joints[bone.from], joints[bone.to], skin, limb);
+    cv::line(depthImage, joints[bone.from], joints[bone.to],
+             cv::Scalar(depth), limb + 2);
+  }
+  const int head = std::max(3, static_cast<int>(bodyHeight * 0.06f));
+  cv::circle(colorImage, joints[0], head, skin, -1);
+  cv::circle(depthImage, joints[0], head + 1, cv::Scalar(depth), -1);
+}
+
+bool SyntheticSource::captureFrames(cv::Mat &colorImage, cv::Mat &depthImage,
+                                    int timeout_ms, FrameInfo *info) {
+  if (!running_ || isFinished()) {
+    return false;
+  }
+
+  pacer_.wait();
+
+  colorImage.create(config_.height, config_.width, CV_8UC3);
+  depthImage.create(config_.height, config_.width, CV_16UC1);
+  colorImage.setTo(cv::Scalar(70, 60, 50));
+  depthImage.setTo(cv::Scalar(kBackgroundDepth));
+
+  // Far figures first so nearer ones occlude them in both images
+  for (int person = config_.people - 1; person >= 0; person--) {
+    renderPerson(colorImage, depthImage, person);
+  }
+
+  if (info) {
+    *info = FrameInfo();
+    info->frameNumber = static_cast<unsigned long long>(frameIndex_);
+    info->stampCapture();
+  }
+
+  frameIndex_++;
+  return true;
+}
+
+std::string SyntheticSource::getName() const { return "Synthetic source"; }
+
+} // namespace RealsenseBodyPose
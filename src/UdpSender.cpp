@@ -1,102 +1,474 @@
 #include "UdpSender.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
 namespace RealsenseBodyPose {
 
+namespace {
+
+// Nose, shoulders, elbows, wrists (JointType in Utils.h)
+const int kKeyJointIds[] = {0, 5, 6, 7, 8, 9, 10};
+
+// Body joints shared by every topology (the COCO-17 prefix)
+const int kBodyJointCount = 17;
+
+// Queue fill fractions that trigger each degradation level
+const size_t kReducedBacklogNum = 1, kReducedBacklogDen = 2;
+const size_t kKeyJointsBacklogNum = 3, kKeyJointsBacklogDen = 4;
+
+// Consecutive sends with an empty queue before stepping back up one level
+const int kRecoverySends = 30;
+
+// Whole-string number parse for --udp specs
+template <typename T> bool parseNumber(const std::string &text, T &value) {
+  std::istringstream ss(text);
+  ss >> value;
+  return !ss.fail() && ss.eof();
+}
+
+} // namespace
+
+UdpSender::UdpSender(const Config &config)
+    : m_config(config), m_initialized(false), m_hasDelta(false),
+      m_sequence(0),
+      m_messageId(0), m_lastFrameNs(0), m_frameIntervalNs(0),
+      m_queue(config.queueCapacity), m_stopRequested(false),
+      m_level(static_cast<int>(Degradation::NONE)), m_idleSends(0),
+      m_sent(0), m_dropped(0), m_errors(0), m_degraded(0),
+      m_fragmented(0), m_suppressed(0), m_wireDelayNs(0) {}
+
 UdpSender::UdpSender(const std::string &ip, int port)
-    : m_ip(ip), m_port(port), m_socket(INVALID_SOCKET), m_initialized(false) {}
+    : UdpSender(Config(ip, port)) {}
 
 UdpSender::~UdpSender() {
-  if (m_socket != INVALID_SOCKET) {
-    closesocket(m_socket);
+  m_stopRequested = true;
+  if (m_thread.joinable()) {
+    m_thread.join();
   }
-  WSACleanup();
+  m_socket.close();
 }
 
 bool UdpSender::initialize() {
-  WSADATA wsaData;
-  int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-  if (result != 0) {
-    std::cerr << "WSAStartup failed with error: " << result << std::endl;
-    return false;
+  // Subsets each degradation level narrows the streams to
+  JointMask<kNumJoints> levelJoints[3];
+  levelJoints[0].setAll();
+  for (int j = 0; j < kBodyJointCount && j < kNumJoints; j++) {
+    levelJoints[1].set(j);
+  }
+  for (int id : kKeyJointIds) {
+    levelJoints[2].set(id);
   }
 
-  m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-  if (m_socket == INVALID_SOCKET) {
-    std::cerr << "socket failed with error: " << WSAGetLastError() << std::endl;
-    WSACleanup();
-    return false;
+  // One Format per distinct (encoding, joints); subscribers share them
+  m_formats.clear();
+  m_hasDelta = false;
+  m_targets.clear();
+  size_t maxDatagrams = 0;
+  for (const Subscriber &subscriber : m_config.subscribers) {
+    Target target;
+    if (!UdpEndpoint::resolve(subscriber.ip, subscriber.port,
+                              target.endpoint)) {
+      std::cerr << "Invalid UDP destination: " << subscriber.ip << ":"
+                << subscriber.port << std::endl;
+      return false;
+    }
+
+    size_t f = 0;
+    while (f < m_formats.size() &&
+           !(m_formats[f].encoding == subscriber.encoding &&
+             m_formats[f].joints[0] == subscriber.joints &&
+             (subscriber.encoding != Encoding::DELTA ||
+              m_formats[f].maxRateHz == subscriber.maxRateHz))) {
+      f++;
+    }
+    if (f == m_formats.size()) {
+      Format format;
+      format.encoding = subscriber.encoding;
+      format.maxRateHz = subscriber.maxRateHz;
+      for (int level = 0; level < 3; level++) {
+        format.joints[level] = subscriber.joints;
+        format.joints[level] &= levelJoints[level];
+      }
+      size_t maxPacket = kWireMaxPacketBytes;
+      if (subscriber.encoding == Encoding::BINARY) {
+        format.packet.resize(kWireMaxPacketBytes);
+      } else if (subscriber.encoding == Encoding::DELTA) {
+        format.packet.resize(kDeltaMaxPacketBytes);
+        format.delta.reset(new DeltaWireEncoder(m_config.delta));
+        maxPacket = kDeltaMaxPacketBytes;
+        m_hasDelta = true;
+      } else {
+        format.json.reset(new JsonSkeletonEncoder());
+        maxPacket = format.json->capacity();
+      }
+      // JSON goes out whole, for receivers that predate fragmentation
+      if (m_config.mtu > 0 && subscriber.encoding != Encoding::JSON) {
+        format.fragmenter.reset(
+            new PacketFragmenter(m_config.mtu, maxPacket));
+      }
+      format.data = nullptr;
+      format.size = 0;
+      format.fragments = 0;
+      m_formats.push_back(std::move(format));
+    }
+
+    target.format = f;
+    target.periodNs = subscriber.maxRateHz > 0.0
+                          ? static_cast<int64_t>(1e9 / subscriber.maxRateHz)
+                          : 0;
+    target.nextDueNs = 0;
+    m_targets.push_back(target);
+    maxDatagrams += m_formats[f].fragmenter
+                        ? m_formats[f].fragmenter->maxCount()
+                        : 1;
   }
+  m_datagrams.resize(maxDatagrams);
 
-  m_destAddr.sin_family = AF_INET;
-  m_destAddr.sin_port = htons(m_port);
-  inet_pton(AF_INET, m_ip.c_str(), &m_destAddr.sin_addr);
+  // Start message ids from the clock, so a restarted sender does not reuse
+  // the ids a receiver is still reassembling
+  m_messageId = static_cast<uint32_t>(
+      std::chrono::system_clock::now().time_since_epoch().count());
+
+  if (!m_socket.open(m_config.socket)) {
+    std::cerr << "socket failed with error: " << m_socket.lastError()
+              << std::endl;
+    return false;
+  }
 
   m_initialized = true;
-  std::cout << "[UDP] Sender initialized on " << m_ip << ":" << m_port
-            << std::endl;
+  if (m_config.asyncSend) {
+    m_thread = std::thread(&UdpSender::senderLoop, this);
+  }
+  std::cout << "[UDP] Sender initialized: " << m_targets.size()
+            << " subscriber(s), " << m_formats.size() << " format(s), send "
+            << "buffer " << m_socket.sendBufferBytes() / 1024 << " KB";
+  if (m_config.mtu > 0) {
+    std::cout << ", MTU " << m_config.mtu;
+  }
+  std::cout << (m_config.asyncSend ? ", async" : "") << std::endl;
+  for (const Subscriber &subscriber : m_config.subscribers) {
+    std::cout << "[UDP]   -> " << subscriber.describe() << std::endl;
+  }
   return true;
 }
 
-std::string UdpSender::formatFloat(float val) {
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(3) << val;
-  return ss.str();
+void UdpSender::send(const SkeletonBatch &skeletons, FrameInfo *info) {
+  // Only delta streams have anything to say about an empty frame
+  if (!m_initialized || (skeletons.empty() && !m_hasDelta))
+    return;
+
+  if (!m_config.asyncSend) {
+    sendNow(skeletons, info, Degradation::NONE);
+    return;
+  }
+
+  if (info) {
+    info->sendNs = monotonicNowNs();
+  }
+
+  // Copy into the staging frame and move it into the queue; a full queue
+  // evicts its oldest frame, which is the least useful one to send
+  m_pending.skeletons = skeletons;
+  m_pending.hasInfo = info != nullptr;
+  if (info) {
+    m_pending.info = *info;
+  }
+  m_queue.push(m_pending, OverflowPolicy::DROP_OLDEST, m_stopRequested,
+               m_dropped);
+}
+
+void UdpSender::senderLoop() {
+  std::atomic<size_t> skipped(0);
+  while (!m_stopRequested) {
+    if (!m_queue.waitPop(m_current, 100, false, skipped)) {
+      continue;
+    }
+    updateLevel(m_queue.size());
+    sendNow(m_current.skeletons, m_current.hasInfo ? &m_current.info : nullptr,
+            static_cast<Degradation>(m_level.load()));
+  }
 }
 
-void UdpSender::send(const std::vector<Skeleton> &skeletons) {
-  if (!m_initialized || skeletons.empty())
+void UdpSender::updateLevel(size_t backlog) {
+  const size_t capacity = m_queue.capacity();
+  int level = m_level.load();
+
+  if (backlog * kKeyJointsBacklogDen >= capacity * kKeyJointsBacklogNum) {
+    level = static_cast<int>(Degradation::KEY_JOINTS);
+    m_idleSends = 0;
+  } else if (backlog * kReducedBacklogDen >= capacity * kReducedBacklogNum) {
+    level = std::max(level, static_cast<int>(Degradation::REDUCED));
+    m_idleSends = 0;
+  } else if (backlog == 0 && level > 0 && ++m_idleSends >= kRecoverySends) {
+    // Step back up one level at a time so a short lull does not flap
+    level--;
+    m_idleSends = 0;
+  }
+  m_level = level;
+}
+
+void UdpSender::sendNow(const SkeletonBatch &skeletons, FrameInfo *info,
+                        Degradation level) {
+  // Decimate on the capture clock so queueing jitter does not skew rates
+  const int64_t now =
+      (info && info->captureNs > 0) ? info->captureNs : monotonicNowNs();
+  const int levelIndex = static_cast<int>(level);
+  const uint32_t sequence = m_sequence++;
+
+  // Smoothed input frame interval (1/8 EMA), for the rate slack below
+  if (m_lastFrameNs > 0 && now > m_lastFrameNs) {
+    const int64_t interval = now - m_lastFrameNs;
+    m_frameIntervalNs =
+        m_frameIntervalNs > 0
+            ? m_frameIntervalNs + (interval - m_frameIntervalNs) / 8
+            : interval;
+  }
+  m_lastFrameNs = now;
+
+  for (Format &format : m_formats) {
+    format.data = nullptr;
+  }
+
+  int count = 0;
+  for (Target &target : m_targets) {
+    if (skeletons.empty() &&
+        m_formats[target.format].encoding != Encoding::DELTA) {
+      continue; // Nobody to report, as before delta streams
+    }
+    if (target.periodNs > 0) {
+      // Send the frame closest to the due time: one arriving less than half
+      // a frame early is better than the next one, half a frame late.
+      // nextDueNs advances by whole periods so the average rate is exact
+      const int64_t slack =
+          std::min(m_frameIntervalNs, target.periodNs) / 2;
+      if (now < target.nextDueNs - slack) {
+        continue;
+      }
+      target.nextDueNs = (now - target.nextDueNs > target.periodNs)
+                             ? now + target.periodNs
+                             : target.nextDueNs + target.periodNs;
+    }
+
+    // Encode each format at most once per frame
+    Format &format = m_formats[target.format];
+    if (!format.data) {
+      const JointMask<kNumJoints> *joints = &format.joints[levelIndex];
+      if (format.encoding == Encoding::BINARY) {
+        format.size =
+            encodeWirePacket(skeletons, sequence, info, format.packet.data(),
+                             format.packet.size(), joints);
+        format.data = reinterpret_cast<const char *>(format.packet.data());
+      } else if (format.encoding == Encoding::DELTA) {
+        format.size = format.delta->encode(skeletons, sequence, info, now,
+                                           format.packet.data(),
+                                           format.packet.size(), joints);
+        format.data = reinterpret_cast<const char *>(format.packet.data());
+        if (format.size == 0) {
+          m_suppressed++;
+        }
+      } else {
+        format.size = format.json->encode(
+            skeletons, info, level == Degradation::NONE ? 3 : 2, joints);
+        format.data = format.json->data();
+      }
+      format.fragments = format.size == 0 ? 0 : 1;
+      if (format.fragmenter && format.size > 0) {
+        format.fragments =
+            format.fragmenter->split(format.data, format.size, m_messageId);
+        if (format.fragments > 1) {
+          m_messageId++;
+          m_fragmented++;
+        }
+      }
+    }
+    if (format.fragments == 0) {
+      continue; // Did not fit, or a delta stream with nothing new
+    }
+
+    for (int i = 0; i < format.fragments; i++) {
+      UdpDatagram &datagram = m_datagrams[count++];
+      if (format.fragmenter) {
+        datagram.data = format.fragmenter->datagram(i);
+        datagram.size = format.fragmenter->datagramSize(i);
+      } else {
+        datagram.data = format.data;
+        datagram.size = format.size;
+      }
+      datagram.to = &target.endpoint;
+    }
+  }
+  if (count == 0) {
     return;
+  }
+
+  const int sent = m_socket.sendBatch(m_datagrams.data(), count);
+  if (info) {
+    // In async mode sendNs holds the hand-off; fold in the time since
+    const int64_t wireNs = monotonicNowNs();
+    if (m_config.asyncSend && info->sendNs > 0) {
+      const int64_t delay = wireNs - info->sendNs;
+      const int64_t average = m_wireDelayNs.load();
+      m_wireDelayNs = average > 0 ? average + (delay - average) / 8 : delay;
+    }
+    info->sendNs = wireNs;
+  }
+  m_sent += static_cast<size_t>(sent);
+  m_errors += static_cast<size_t>(count - sent);
+  if (level != Degradation::NONE) {
+    m_degraded += static_cast<size_t>(sent);
+  }
+}
 
-  // Manual JSON construction
-  std::stringstream json;
-  json << "{\"skeletons\":[";
-
-  for (size_t i = 0; i < skeletons.size(); ++i) {
-    const auto &skel = skeletons[i];
-
-    if (i > 0)
-      json << ",";
-
-    // Use index as ID since Skeleton struct doesn't have one
-    json << "{\"id\":" << i << ",\"joints\":{";
-
-    // Only sending key joints for robot control (Wrists, Shoulders, Elbows,
-    // Nose) Indices match JointType in Utils.h
-    struct JointName {
-      int id;
-      std::string name;
-    };
-    std::vector<JointName> keyJoints = {
-        {0, "Nose"},   {5, "LShoulder"}, {6, "RShoulder"}, {7, "LElbow"},
-        {8, "RElbow"}, {9, "LWrist"},    {10, "RWrist"}};
-
-    bool firstJoint = true;
-    for (const auto &kj : keyJoints) {
-      int jId = kj.id;
-      // Check bounds
-      if (jId < (int)skel.keypoints3D.size()) {
-        const auto &k3d = skel.keypoints3D[jId];
-        if (k3d.isValid()) {
-          if (!firstJoint)
-            json << ",";
-          json << "\"" << kj.name << "\":{\"x\":" << formatFloat(k3d.x)
-               << ",\"y\":" << formatFloat(k3d.y)
-               << ",\"z\":" << formatFloat(k3d.z)
-               << ",\"conf\":" << formatFloat(k3d.confidence) << "}";
-          firstJoint = false;
+UdpSender::Stats UdpSender::getStats() const {
+  Stats stats;
+  stats.queued = m_queue.size();
+  stats.sent = m_sent.load();
+  stats.dropped = m_dropped.load();
+  stats.errors = m_errors.load();
+  stats.syscalls = m_socket.stats().syscalls;
+  stats.degraded = m_degraded.load();
+  stats.fragmented = m_fragmented.load();
+  stats.suppressed = m_suppressed.load();
+  stats.wireDelayMs = m_wireDelayNs.load() * 1e-6;
+  stats.level = static_cast<Degradation>(m_level.load());
+  return stats;
+}
+
+std::string UdpSender::summary() const {
+  static const char *const kLevelNames[] = {"full", "reduced", "key joints"};
+
+  Stats stats = getStats();
+  std::ostringstream ss;
+  ss << "UDP: " << stats.sent << " sent";
+  if (m_config.asyncSend) {
+    ss << " | " << stats.queued << " queued | " << stats.dropped
+       << " dropped | " << std::fixed << std::setprecision(2)
+       << stats.wireDelayMs << " ms to wire";
+  }
+  ss << " | " << stats.errors << " errors | " << stats.degraded
+     << " degraded (now " << kLevelNames[static_cast<int>(stats.level)]
+     << ")";
+  if (stats.fragmented > 0) {
+    ss << " | " << stats.fragmented << " fragmented";
+  }
+  if (stats.suppressed > 0) {
+    ss << " | " << stats.suppressed << " suppressed";
+  }
+  return ss.str();
+}
+
+bool UdpSender::Subscriber::parse(const std::string &spec) {
+  std::vector<std::string> fields;
+  std::stringstream ss(spec);
+  std::string field;
+  while (std::getline(ss, field, ',')) {
+    fields.push_back(field);
+  }
+  if (fields.empty()) {
+    return false;
+  }
+
+  const size_t colon = fields[0].rfind(':');
+  if (colon == std::string::npos || colon == 0 ||
+      !parseNumber(fields[0].substr(colon + 1), port) || port <= 0 ||
+      port > 65535) {
+    return false;
+  }
+  ip = fields[0].substr(0, colon);
+  UdpEndpoint endpoint;
+  if (!UdpEndpoint::resolve(ip, port, endpoint)) {
+    return false; // Not a dotted IPv4 address
+  }
+
+  for (size_t i = 1; i < fields.size(); i++) {
+    const size_t equals = fields[i].find('=');
+    if (equals == std::string::npos) {
+      return false;
+    }
+    const std::string key = fields[i].substr(0, equals);
+    const std::string value = fields[i].substr(equals + 1);
+
+    if (key == "format") {
+      if (value == "json") {
+        encoding = Encoding::JSON;
+      } else if (value == "binary") {
+        encoding = Encoding::BINARY;
+      } else if (value == "delta") {
+        encoding = Encoding::DELTA;
+      } else {
+        return false;
+      }
+    } else if (key == "rate") {
+      if (!parseNumber(value, maxRateHz) || maxRateHz < 0.0) {
+        return false;
+      }
+    } else if (key == "joints") {
+      joints.clear();
+      if (value == "all") {
+        joints.setAll();
+      } else if (value == "body") {
+        for (int j = 0; j < kBodyJointCount && j < kNumJoints; j++) {
+          joints.set(j);
+        }
+      } else if (value == "key") {
+        for (int id : kKeyJointIds) {
+          joints.set(id);
+        }
+      } else {
+        std::stringstream list(value);
+        std::string index;
+        while (std::getline(list, index, '+')) {
+          int joint = 0;
+          if (!parseNumber(index, joint) || joint < 0 ||
+              joint >= kNumJoints) {
+            return false;
+          }
+          joints.set(joint);
         }
       }
+      if (!joints.any()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  // JSON carries the key joints only; a set without any would send nothing
+  if (encoding == Encoding::JSON) {
+    bool anyKeyJoint = false;
+    for (int id : kKeyJointIds) {
+      anyKeyJoint = anyKeyJoint || joints.test(id);
+    }
+    if (!anyKeyJoint) {
+      return false;
     }
-    json << "}}";
   }
-  json << "]}";
+  return true;
+}
+
+std::string UdpSender::Subscriber::describe() const {
+  static const char *const kEncodingNames[] = {"json", "binary", "delta"};
 
-  std::string payload = json.str();
-  sendto(m_socket, payload.c_str(), (int)payload.length(), 0,
-         (sockaddr *)&m_destAddr, sizeof(m_destAddr));
+  std::ostringstream ss;
+  ss << ip << ":" << port << " "
+     << kEncodingNames[static_cast<int>(encoding)];
+  if (maxRateHz > 0.0) {
+    ss << " @ " << maxRateHz << " Hz";
+  }
+  const int count = joints.count();
+  if (count < kNumJoints) {
+    ss << ", " << count << " joint" << (count == 1 ? "" : "s");
+  }
+  UdpEndpoint endpoint;
+  if (UdpEndpoint::resolve(ip, port, endpoint) && endpoint.isMulticast()) {
+    ss << " (multicast)";
+  }
+  return ss.str();
 }
 
 } // namespace RealsenseBodyPose
@@ -1,39 +1,218 @@
 #pragma once
 
-#ifndef NOMINMAX
-#define NOMINMAX
-#endif
-
+#include "Fragmentation.h"
+#include "DeltaWireFormat.h"
+#include "FrameRing.h"
+#include "JsonEncoder.h"
+#include "SkeletonBatch.h"
+#include "UdpSocket.h"
 #include "Utils.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-#pragma comment(lib, "ws2_32.lib")
 
 namespace RealsenseBodyPose {
 
+/**
+ * @brief Streams skeletons to a table of UDP subscribers
+ *
+ * Each subscriber (unicast or multicast) has its own encoding, joint subset
+ * and maximum rate. Every frame is encoded once per distinct format and the
+ * same buffer is sent to all subscribers due for it, in one batched send.
+ * Packets larger than the MTU allows are split into numbered fragments
+ * (Fragmentation.h) rather than left to IP fragmentation, where losing any
+ * piece loses the frame without the receiver knowing why.
+ *
+ * By default send() only copies the batch into a bounded lock-free queue
+ * and returns; a dedicated I/O thread encodes and sends, so a
+ * stall in the network stack never holds up the pipeline. When the queue
+ * is full the oldest (stale) frame is dropped. While the queue is backing
+ * up the I/O thread sheds work: first it lowers the precision and sends
+ * only the body joints, then only the key joints, and it steps back up
+ * once the backlog has cleared.
+ */
 class UdpSender {
 public:
+  // Datagram payload format
+  enum class Encoding {
+    JSON,   // Text, key joints only (original format)
+    BINARY, // WireFormat.h packet, every valid joint
+    DELTA   // DeltaWireFormat.h stream: keyframes, then changes only
+  };
+
+  // Work shed by the I/O thread while its queue backs up
+  enum class Degradation {
+    NONE,      // Full output
+    REDUCED,   // JSON with 2 decimals; body joints only (no face/hands)
+    KEY_JOINTS // Additionally only the key joints (nose, arms)
+  };
+
+  /**
+   * @brief One destination and the stream it wants
+   */
+  struct Subscriber {
+    std::string ip = "127.0.0.1"; // Unicast or multicast (224.0.0.0/4)
+    int port = 8888;
+    Encoding encoding = Encoding::JSON;
+    double maxRateHz = 0.0;        // 0: every frame
+    JointMask<kNumJoints> joints;  // Joints to send (all by default)
+
+    Subscriber() { joints.setAll(); }
+    Subscriber(const std::string &ip_, int port_,
+               Encoding encoding_ = Encoding::JSON)
+        : ip(ip_), port(port_), encoding(encoding_) {
+      joints.setAll();
+    }
+
+    /**
+     * @brief Parse
+     *        "ip:port[,format=json|binary|delta][,rate=<hz>][,joints=<set>]"
+     *
+     * <set> is all, body, key, or joint indices joined by '+' (e.g. 9+10
+     * for the wrists). The encoding defaults to the one already set. JSON
+     * only ever carries the key joints (nose, shoulders, elbows, wrists), so
+     * with JSON a set narrows those: all and body send every key joint.
+     *
+     * @return false if the spec is malformed, ip is not a dotted IPv4
+     *         address, or a JSON set holds no key joint
+     */
+    bool parse(const std::string &spec);
+
+    std::string describe() const;
+  };
+
+  struct Config {
+    std::vector<Subscriber> subscribers;
+    bool asyncSend = true;    // Send from a dedicated I/O thread
+    size_t queueCapacity = 4; // Frames waiting for the I/O thread
+    size_t mtu = kDefaultMtu; // Binary / delta path MTU; 0 never fragments
+    UdpSocket::Config socket;
+    DeltaWireEncoder::Config delta; // For DELTA subscribers
+
+    Config() {}
+    Config(const std::string &ip, int port,
+           Encoding encoding = Encoding::JSON) {
+      subscribers.push_back(Subscriber(ip, port, encoding));
+    }
+  };
+
+  /**
+   * @brief Counters since initialize()
+   */
+  struct Stats {
+    size_t queued = 0;   // Frames currently waiting
+    size_t sent = 0;     // Datagrams handed to the socket
+    size_t dropped = 0;  // Stale frames evicted from a full queue
+    size_t errors = 0;   // Datagrams dropped or rejected by the socket
+    size_t syscalls = 0; // Send syscalls made
+    size_t degraded = 0; // Datagrams sent with reduced content
+    size_t fragmented = 0; // Packets split to fit the MTU
+    size_t suppressed = 0; // Delta frames not sent, nothing had changed
+    double wireDelayMs = 0.0; // Async: hand-off to sendBatch return (EMA)
+    Degradation level = Degradation::NONE;
+  };
+
+  explicit UdpSender(const Config &config);
   UdpSender(const std::string &ip = "127.0.0.1", int port = 8888);
   ~UdpSender();
 
-  // Initialize Winsock
+  // Resolve the subscribers and open the socket (and start the I/O thread
+  // in async mode)
   bool initialize();
 
-  // Send skeleton data as JSON string
-  void send(const std::vector<Skeleton> &skeletons);
+  // Send skeleton data to every subscriber due for a frame, tagging the
+  // packets with the frame number and device timestamp when info is given.
+  // Call for empty frames too: JSON and binary subscribers get nothing, but
+  // a delta stream sends one packet with nobody in it, then heartbeats, so
+  // its receivers drop the people who left.
+  // Stamps info->sendNs when the datagrams left (left 0 when none were due);
+  // in async mode that is only known on the I/O thread, so it stamps the
+  // hand-off instead, and Stats::wireDelayMs gives the time left to the wire
+  void send(const SkeletonBatch &skeletons, FrameInfo *info = nullptr);
+
+  Stats getStats() const;
+
+  // One-line summary of getStats() for the periodic log
+  std::string summary() const;
 
 private:
-  std::string m_ip;
-  int m_port;
-  SOCKET m_socket;
-  sockaddr_in m_destAddr;
+  // A frame waiting for the I/O thread
+  struct OutgoingFrame {
+    SkeletonBatch skeletons;
+    FrameInfo info;
+    bool hasInfo = false;
+  };
+
+  // A distinct (encoding, joint subset) pair and its packet buffer, shared
+  // by every subscriber asking for the same stream (for DELTA also the same
+  // rate, since the stream state assumes every receiver sees each packet)
+  struct Format {
+    Encoding encoding;
+    double maxRateHz;
+    // Joints per Degradation level: the subscriber's subset narrowed by
+    // the level's subset
+    JointMask<kNumJoints> joints[3];
+    std::unique_ptr<JsonSkeletonEncoder> json;
+    std::unique_ptr<DeltaWireEncoder> delta;
+    std::vector<uint8_t> packet;
+    std::unique_ptr<PacketFragmenter> fragmenter; // nullptr: mtu is 0
+    const char *data; // Encoded this frame, or nullptr
+    size_t size;
+    int fragments; // Datagrams for this frame's packet
+  };
+
+  struct Target {
+    UdpEndpoint endpoint;
+    size_t format;    // Index into m_formats
+    int64_t periodNs; // 0: every frame
+    int64_t nextDueNs;
+  };
+
+  Config m_config;
+  UdpSocket m_socket;
   bool m_initialized;
+  bool m_hasDelta; // Some subscriber takes a DELTA stream
+
+  uint32_t m_sequence;  // Frames sent, shared by every binary stream
+  uint32_t m_messageId; // Fragmented packets, stamped on their fragments
+
+  std::vector<Format> m_formats;
+  std::vector<Target> m_targets;
+  std::vector<UdpDatagram> m_datagrams; // One batch, reused every frame
+
+  // Rate decimation clock (I/O thread)
+  int64_t m_lastFrameNs;
+  int64_t m_frameIntervalNs;
+
+  // Async mode: queue, I/O thread and its degradation state
+  FrameRing<OutgoingFrame> m_queue;
+  OutgoingFrame m_pending; // Producer-side staging, avoids a stack copy
+  OutgoingFrame m_current; // I/O thread's frame being sent
+  std::thread m_thread;
+  std::atomic<bool> m_stopRequested;
+  std::atomic<int> m_level;
+  int m_idleSends; // Consecutive sends that found the queue empty
+
+  std::atomic<size_t> m_sent;
+  std::atomic<size_t> m_dropped;
+  std::atomic<size_t> m_errors;
+  std::atomic<size_t> m_degraded;
+  std::atomic<size_t> m_fragmented;
+  std::atomic<size_t> m_suppressed;
+  std::atomic<int64_t> m_wireDelayNs; // 1/8 EMA, async mode
+
+  void senderLoop();
+
+  // Pick the degradation level from the backlog left behind a frame
+  void updateLevel(size_t backlog);
 
-  // Helper to format float string
-  std::string formatFloat(float val);
+  // Encode each format due this frame with the given degradation and send
+  // it to its subscribers in one batch; stamps info->sendNs once sent
+  void sendNow(const SkeletonBatch &skeletons, FrameInfo *info,
+               Degradation level);
 };
 
 } // namespace RealsenseBodyPose
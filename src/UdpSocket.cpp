@@ -0,0 +1,383 @@
+// UDP Socket Implementation
+
+#include "UdpSocket.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+#ifdef _WIN32
+typedef SOCKET NativeSocket;
+const NativeSocket kInvalidSocket = INVALID_SOCKET;
+
+int lastSocketError() { return WSAGetLastError(); }
+bool isWouldBlock(int error) { return error == WSAEWOULDBLOCK; }
+bool isInterrupted(int error) { return error == WSAEINTR; }
+void closeNative(NativeSocket s) { closesocket(s); }
+#else
+typedef int NativeSocket;
+const NativeSocket kInvalidSocket = -1;
+
+int lastSocketError() { return errno; }
+bool isWouldBlock(int error) {
+  return error == EAGAIN || error == EWOULDBLOCK;
+}
+bool isInterrupted(int error) { return error == EINTR; }
+void closeNative(NativeSocket s) { ::close(s); }
+#endif
+
+// Datagrams per sendmmsg()/recvmmsg() call; larger batches are split
+const int kMaxBatch = 64;
+
+sockaddr_in toSockaddr(const UdpEndpoint &endpoint) {
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = endpoint.port;
+  addr.sin_addr.s_addr = endpoint.address;
+  return addr;
+}
+
+UdpEndpoint fromSockaddr(const sockaddr_in &addr) {
+  UdpEndpoint endpoint;
+  endpoint.address = addr.sin_addr.s_addr;
+  endpoint.port = addr.sin_port;
+  return endpoint;
+}
+
+} // namespace
+
+bool UdpEndpoint::resolve(const std::string &ip, int port,
+                          UdpEndpoint &endpoint) {
+  in_addr addr;
+  if (port < 0 || port > 65535 || inet_pton(AF_INET, ip.c_str(), &addr) != 1) {
+    return false;
+  }
+  endpoint.address = addr.s_addr;
+  endpoint.port = htons(static_cast<uint16_t>(port));
+  return true;
+}
+
+bool UdpEndpoint::isMulticast() const {
+  return (ntohl(address) & 0xF0000000u) == 0xE0000000u;
+}
+
+std::string UdpEndpoint::toString() const {
+  in_addr addr;
+  addr.s_addr = address;
+  char text[INET_ADDRSTRLEN] = {};
+  inet_ntop(AF_INET, &addr, text, sizeof(text));
+  return std::string(text) + ":" + std::to_string(ntohs(port));
+}
+
+UdpSocket::UdpSocket()
+    : m_handle(-1), m_lastError(0), m_syscalls(0), m_datagrams(0),
+      m_bytes(0), m_wouldBlock(0), m_errors(0) {}
+
+UdpSocket::~UdpSocket() { close(); }
+
+bool UdpSocket::open(const Config &config) {
+  close();
+
+#ifdef _WIN32
+  // Reference counted by Winsock; balanced by WSACleanup() in close()
+  WSADATA wsaData;
+  int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
+  if (result != 0) {
+    m_lastError = result;
+    return false;
+  }
+#endif
+
+  NativeSocket s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (s == kInvalidSocket) {
+    m_lastError = lastSocketError();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return false;
+  }
+  m_handle = static_cast<intptr_t>(s);
+
+  if (config.nonBlocking) {
+#ifdef _WIN32
+    u_long enabled = 1;
+    bool ok = ioctlsocket(s, FIONBIO, &enabled) == 0;
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    bool ok = flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+      m_lastError = lastSocketError();
+      close();
+      return false;
+    }
+  }
+
+  // Best effort: the OS may clamp the request (net.core.wmem_max)
+  if (config.sendBufferBytes > 0) {
+    setsockopt(s, SOL_SOCKET, SO_SNDBUF,
+               reinterpret_cast<const char *>(&config.sendBufferBytes),
+               sizeof(config.sendBufferBytes));
+  }
+  if (config.receiveBufferBytes > 0) {
+    setsockopt(s, SOL_SOCKET, SO_RCVBUF,
+               reinterpret_cast<const char *>(&config.receiveBufferBytes),
+               sizeof(config.receiveBufferBytes));
+  }
+  if (config.multicastTtl > 0) {
+    setsockopt(s, IPPROTO_IP, IP_MULTICAST_TTL,
+               reinterpret_cast<const char *>(&config.multicastTtl),
+               sizeof(config.multicastTtl));
+  }
+
+  m_syscalls = 0;
+  m_datagrams = 0;
+  m_bytes = 0;
+  m_wouldBlock = 0;
+  m_errors = 0;
+  return true;
+}
+
+bool UdpSocket::bind(int port) {
+  if (!isOpen()) {
+    return false;
+  }
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (::bind(static_cast<NativeSocket>(m_handle),
+             reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+    m_lastError = lastSocketError();
+    return false;
+  }
+  return true;
+}
+
+void UdpSocket::close() {
+  if (!isOpen()) {
+    return;
+  }
+  closeNative(static_cast<NativeSocket>(m_handle));
+  m_handle = -1;
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+bool UdpSocket::isOpen() const {
+  return static_cast<NativeSocket>(m_handle) != kInvalidSocket;
+}
+
+int UdpSocket::sendBatch(const UdpDatagram *datagrams, int count) {
+  if (!isOpen() || count <= 0) {
+    return 0;
+  }
+  const NativeSocket s = static_cast<NativeSocket>(m_handle);
+  int sent = 0;
+  size_t bytes = 0;
+  int next = 0;
+
+  while (next < count) {
+#if defined(__linux__)
+    // One syscall for up to kMaxBatch datagrams
+    mmsghdr messages[kMaxBatch];
+    iovec vectors[kMaxBatch];
+    sockaddr_in addresses[kMaxBatch];
+    const int chunk = std::min(count - next, kMaxBatch);
+    for (int i = 0; i < chunk; i++) {
+      const UdpDatagram &d = datagrams[next + i];
+      addresses[i] = toSockaddr(*d.to);
+      vectors[i].iov_base = const_cast<void *>(d.data);
+      vectors[i].iov_len = d.size;
+      std::memset(&messages[i], 0, sizeof(messages[i]));
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      messages[i].msg_hdr.msg_iov = &vectors[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    int result = sendmmsg(s, messages, chunk, 0);
+    m_syscalls++;
+    if (result > 0) {
+      for (int i = 0; i < result; i++) {
+        bytes += messages[i].msg_len;
+      }
+      sent += result;
+      next += result;
+      continue;
+    }
+#else
+    const UdpDatagram &d = datagrams[next];
+    sockaddr_in addr = toSockaddr(*d.to);
+    long long result =
+        ::sendto(s, static_cast<const char *>(d.data), (int)d.size, 0,
+                 reinterpret_cast<const sockaddr *>(&addr), sizeof(addr));
+    m_syscalls++;
+    if (result >= 0) {
+      bytes += d.size;
+      sent++;
+      next++;
+      continue;
+    }
+#endif
+    // The datagram at next failed
+    const int error = lastSocketError();
+    if (isInterrupted(error)) {
+      continue;
+    }
+    m_lastError = error;
+    if (isWouldBlock(error)) {
+      // Buffer full: drop the rest of the batch instead of waiting
+      m_wouldBlock += static_cast<size_t>(count - next);
+      break;
+    }
+    // Skip only the offending datagram (e.g. EMSGSIZE)
+    m_errors++;
+    next++;
+  }
+
+  m_datagrams += static_cast<size_t>(sent);
+  m_bytes += bytes;
+  return sent;
+}
+
+bool UdpSocket::sendTo(const void *data, size_t size, const UdpEndpoint &to) {
+  UdpDatagram datagram;
+  datagram.data = data;
+  datagram.size = size;
+  datagram.to = &to;
+  return sendBatch(&datagram, 1) == 1;
+}
+
+int UdpSocket::receiveBatch(UdpMessage *messages, int count) {
+  if (!isOpen() || count <= 0) {
+    return 0;
+  }
+  const NativeSocket s = static_cast<NativeSocket>(m_handle);
+  int received = 0;
+
+  while (received < count) {
+#if defined(__linux__)
+    mmsghdr headers[kMaxBatch];
+    iovec vectors[kMaxBatch];
+    sockaddr_in addresses[kMaxBatch];
+    const int chunk = std::min(count - received, kMaxBatch);
+    for (int i = 0; i < chunk; i++) {
+      UdpMessage &m = messages[received + i];
+      vectors[i].iov_base = m.buffer;
+      vectors[i].iov_len = m.capacity;
+      std::memset(&headers[i], 0, sizeof(headers[i]));
+      headers[i].msg_hdr.msg_name = &addresses[i];
+      headers[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      headers[i].msg_hdr.msg_iov = &vectors[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    int result = recvmmsg(s, headers, chunk, MSG_DONTWAIT, nullptr);
+    if (result > 0) {
+      for (int i = 0; i < result; i++) {
+        UdpMessage &m = messages[received + i];
+        m.size = headers[i].msg_len;
+        m.from = fromSockaddr(addresses[i]);
+      }
+      received += result;
+      if (result < chunk) {
+        break; // Queue drained
+      }
+      continue;
+    }
+#else
+    UdpMessage &m = messages[received];
+    sockaddr_in addr;
+#ifdef _WIN32
+    int addrLength = sizeof(addr);
+#else
+    socklen_t addrLength = sizeof(addr);
+#endif
+    long long result =
+        ::recvfrom(s, static_cast<char *>(m.buffer), (int)m.capacity, 0,
+                   reinterpret_cast<sockaddr *>(&addr), &addrLength);
+    if (result >= 0) {
+      m.size = static_cast<size_t>(result);
+      m.from = fromSockaddr(addr);
+      received++;
+      continue;
+    }
+#endif
+    const int error = lastSocketError();
+    if (isInterrupted(error)) {
+      continue;
+    }
+    if (!isWouldBlock(error)) {
+      m_lastError = error;
+    }
+    break;
+  }
+  return received;
+}
+
+bool UdpSocket::waitReadable(int timeout_ms) {
+  if (!isOpen()) {
+    return false;
+  }
+#ifdef _WIN32
+  WSAPOLLFD fd;
+  fd.fd = static_cast<NativeSocket>(m_handle);
+  fd.events = POLLRDNORM;
+  fd.revents = 0;
+  return WSAPoll(&fd, 1, timeout_ms) > 0;
+#else
+  pollfd fd;
+  fd.fd = static_cast<NativeSocket>(m_handle);
+  fd.events = POLLIN;
+  fd.revents = 0;
+  return poll(&fd, 1, timeout_ms) > 0;
+#endif
+}
+
+int UdpSocket::sendBufferBytes() const {
+  if (!isOpen()) {
+    return 0;
+  }
+  int value = 0;
+#ifdef _WIN32
+  int length = sizeof(value);
+#else
+  socklen_t length = sizeof(value);
+#endif
+  getsockopt(static_cast<NativeSocket>(m_handle), SOL_SOCKET, SO_SNDBUF,
+             reinterpret_cast<char *>(&value), &length);
+  return value;
+}
+
+UdpSocket::Stats UdpSocket::stats() const {
+  Stats stats;
+  stats.syscalls = m_syscalls.load();
+  stats.datagrams = m_datagrams.load();
+  stats.bytes = m_bytes.load();
+  stats.wouldBlock = m_wouldBlock.load();
+  stats.errors = m_errors.load();
+  return stats;
+}
+
+} // namespace RealsenseBodyPose
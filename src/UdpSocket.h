@@ -0,0 +1,153 @@
+// Portable UDP socket with batched send/receive
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RealsenseBodyPose {
+
+/**
+ * @brief IPv4 address and port, both in network byte order
+ *
+ * Kept free of platform headers so users of UdpSocket do not pull in
+ * winsock2.h or the BSD socket headers.
+ */
+struct UdpEndpoint {
+  uint32_t address = 0;
+  uint16_t port = 0;
+
+  /**
+   * @brief Parse a dotted IPv4 address
+   * @return false if ip is not a valid address
+   */
+  static bool resolve(const std::string &ip, int port, UdpEndpoint &endpoint);
+
+  // 224.0.0.0/4
+  bool isMulticast() const;
+
+  std::string toString() const;
+};
+
+/**
+ * @brief One outgoing datagram; the buffer must stay valid for the call
+ */
+struct UdpDatagram {
+  const void *data = nullptr;
+  size_t size = 0;
+  const UdpEndpoint *to = nullptr;
+};
+
+/**
+ * @brief One receive slot; size and from are filled in by receiveBatch()
+ */
+struct UdpMessage {
+  void *buffer = nullptr;
+  size_t capacity = 0;
+  size_t size = 0;
+  UdpEndpoint from;
+};
+
+/**
+ * @brief Non-blocking IPv4 UDP socket
+ *
+ * The POSIX backend hands a whole batch of datagrams (several destinations,
+ * or the fragments of one frame) to the kernel with a single sendmmsg() on
+ * Linux and receives with recvmmsg(); other POSIX systems and Winsock fall
+ * back to one sendto()/recvfrom() per datagram behind the same interface.
+ *
+ * The socket is non-blocking: when the send buffer is full the rest of the
+ * batch is dropped and counted rather than stalling the caller, which is the
+ * right trade for real-time pose data. A larger SO_SNDBUF absorbs bursts.
+ *
+ * Only one thread may send and one thread may receive; stats() may be read
+ * from any thread.
+ */
+class UdpSocket {
+public:
+  struct Config {
+    bool nonBlocking = true;
+    int sendBufferBytes = 1 << 20;   // SO_SNDBUF request, 0 keeps the default
+    int receiveBufferBytes = 0;      // SO_RCVBUF request, 0 keeps the default
+    int multicastTtl = 1;            // Hops for multicast sends (1: LAN only)
+    Config() {}
+  };
+
+  /**
+   * @brief Counters since open()
+   */
+  struct Stats {
+    size_t syscalls = 0;   // Send syscalls made (sendmmsg or sendto)
+    size_t datagrams = 0;  // Datagrams accepted by the kernel
+    size_t bytes = 0;      // Payload bytes accepted by the kernel
+    size_t wouldBlock = 0; // Datagrams dropped because the buffer was full
+    size_t errors = 0;     // Datagrams rejected with any other error
+  };
+
+  UdpSocket();
+  ~UdpSocket();
+
+  UdpSocket(const UdpSocket &) = delete;
+  UdpSocket &operator=(const UdpSocket &) = delete;
+
+  /**
+   * @brief Create the socket and apply the configuration
+   * @return false on failure (see lastError())
+   */
+  bool open(const Config &config = Config());
+
+  /**
+   * @brief Bind to a local port on all interfaces (receivers)
+   */
+  bool bind(int port);
+
+  void close();
+
+  bool isOpen() const;
+
+  /**
+   * @brief Send a batch of datagrams
+   * @return Number of datagrams accepted by the kernel; the rest were
+   *         dropped (buffer full) or rejected, and are counted in stats()
+   */
+  int sendBatch(const UdpDatagram *datagrams, int count);
+
+  /**
+   * @brief Send a single datagram
+   */
+  bool sendTo(const void *data, size_t size, const UdpEndpoint &to);
+
+  /**
+   * @brief Receive whatever is queued, up to count datagrams, without waiting
+   * @return Number of slots filled, 0 if nothing was pending
+   */
+  int receiveBatch(UdpMessage *messages, int count);
+
+  /**
+   * @brief Wait until a datagram can be read
+   * @return false on timeout or error
+   */
+  bool waitReadable(int timeout_ms);
+
+  // Effective SO_SNDBUF as reported by the OS (Linux doubles the request)
+  int sendBufferBytes() const;
+
+  // errno / WSAGetLastError() of the last failure
+  int lastError() const { return m_lastError; }
+
+  Stats stats() const;
+
+private:
+  intptr_t m_handle; // int fd or SOCKET, -1 when closed
+  int m_lastError;
+
+  std::atomic<size_t> m_syscalls;
+  std::atomic<size_t> m_datagrams;
+  std::atomic<size_t> m_bytes;
+  std::atomic<size_t> m_wouldBlock;
+  std::atomic<size_t> m_errors;
+};
+
+} // namespace RealsenseBodyPose
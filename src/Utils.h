@@ -3,13 +3,20 @@
 #pragma once
 
 #include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
 #include <opencv2/opencv.hpp>
+#include <sstream>
 #include <string>
 #include <vector>
 
 namespace RealsenseBodyPose {
 
-// Joint names for COCO 17-keypoint skeleton
+// COCO 17-keypoint body joints (the first joints of every topology in
+// SkeletonTopology.h)
 enum class JointType {
   NOSE = 0,
   LEFT_EYE = 1,
@@ -59,52 +66,48 @@ struct Keypoint3D {
   bool isValid() const { return confidence > 0.3f && z > 0.1f && z < 10.0f; }
 };
 
-// Person skeleton (17 keypoints)
-struct Skeleton {
-  std::vector<Keypoint2D> keypoints2D; // 2D keypoints from pose estimation
-  std::vector<Keypoint3D> keypoints3D; // 3D keypoints after depth projection
-  float bbox[4];                       // Bounding box [x, y, w, h]
-  float overallConfidence;             // Overall detection confidence
-
-  Skeleton() : overallConfidence(0.0f) {
-    keypoints2D.resize(17);
-    keypoints3D.resize(17);
-    bbox[0] = bbox[1] = bbox[2] = bbox[3] = 0;
-  }
-};
+// Monotonic clock in nanoseconds (for latency measurements)
+inline int64_t monotonicNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
 
-// Skeleton bone connections for visualization (COCO format)
-const std::vector<std::pair<int, int>> SKELETON_CONNECTIONS = {
-    // Face
-    {0, 1},
-    {0, 2}, // Nose to eyes
-    {1, 3},
-    {2, 4}, // Eyes to ears
-
-    // Torso
-    {5, 6}, // Shoulders
-    {5, 11},
-    {6, 12},  // Shoulders to hips
-    {11, 12}, // Hips
-
-    // Left arm
-    {5, 7},
-    {7, 9}, // Shoulder → Elbow → Wrist
-
-    // Right arm
-    {6, 8},
-    {8, 10}, // Shoulder → Elbow → Wrist
-
-    // Left leg
-    {11, 13},
-    {13, 15}, // Hip → Knee → Ankle
-
-    // Right leg
-    {12, 14},
-    {14, 16} // Hip → Knee → Ankle
+// Wall clock in milliseconds since epoch (comparable to global-time frame
+// timestamps)
+inline double systemNowMs() {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// Frame lineage: identity of a frameset and its timestamps through each stage
+struct FrameInfo {
+  unsigned long long frameNumber; // rs2 frame number (source sequence offline)
+  double sensorTimestampMs;       // Device frame timestamp
+  bool globalTimestamp; // sensorTimestampMs is in host time (global domain)
+  double captureSystemMs; // Wall clock when the frameset reached the host
+
+  // Monotonic timestamps (monotonicNowNs), 0 if the stage was not reached
+  int64_t captureNs;
+  int64_t inferenceNs;
+  int64_t projectionNs;
+  int64_t sendNs;
+
+  FrameInfo()
+      : frameNumber(0), sensorTimestampMs(0), globalTimestamp(false),
+        captureSystemMs(0), captureNs(0), inferenceNs(0), projectionNs(0),
+        sendNs(0) {}
+
+  // Stamp capture time on arrival of the frameset
+  void stampCapture() {
+    captureNs = monotonicNowNs();
+    captureSystemMs = systemNowMs();
+  }
 };
 
-// Color palette for visualization (BGR format for OpenCV)
+// Color palette for visualization (BGR format for OpenCV), one per COCO body
+// joint
 const std::vector<cv::Scalar> JOINT_COLORS = {
     cv::Scalar(255, 0, 0),   // Nose - Blue
     cv::Scalar(255, 85, 0),  // Left Eye
@@ -125,17 +128,6 @@ const std::vector<cv::Scalar> JOINT_COLORS = {
     cv::Scalar(255, 0, 170)  // Right Ankle
 };
 
-// Joint name lookup
-inline std::string getJointName(int index) {
-  const std::vector<std::string> names = {
-      "Nose",        "Left Eye",      "Right Eye",      "Left Ear",
-      "Right Ear",   "Left Shoulder", "Right Shoulder", "Left Elbow",
-      "Right Elbow", "Left Wrist",    "Right Wrist",    "Left Hip",
-      "Right Hip",   "Left Knee",     "Right Knee",     "Left Ankle",
-      "Right Ankle"};
-  return (index >= 0 && index < 17) ? names[index] : "Unknown";
-}
-
 // Performance timer utility
 class Timer {
 public:
@@ -180,6 +172,78 @@ private:
   std::chrono::time_point<std::chrono::high_resolution_clock> lastUpdate_;
 };
 
+// Startup timeline: records named spans (possibly from several threads)
+// relative to a common origin and renders them as a Gantt-style chart
+class StartupTimeline {
+public:
+  StartupTimeline() : origin_(std::chrono::steady_clock::now()) {}
+
+  // RAII span: records [construction, destruction) under the given name
+  class Span {
+  public:
+    Span(StartupTimeline &timeline, const std::string &name)
+        : timeline_(timeline), name_(name),
+          start_(std::chrono::steady_clock::now()) {}
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+    ~Span() { timeline_.add(name_, start_, std::chrono::steady_clock::now()); }
+
+  private:
+    StartupTimeline &timeline_;
+    std::string name_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  Span span(const std::string &name) { return Span(*this, name); }
+
+  void add(const std::string &name, std::chrono::steady_clock::time_point start,
+           std::chrono::steady_clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back({name, toMs(start), toMs(end)});
+  }
+
+  // Elapsed time since the timeline was created (milliseconds)
+  double elapsed() const { return toMs(std::chrono::steady_clock::now()); }
+
+  std::string format() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int barWidth = 40;
+    double total = 0.0;
+    for (const auto &e : entries_) {
+      total = std::max(total, e.endMs);
+    }
+
+    std::stringstream ss;
+    ss << "Startup timeline (total " << std::fixed << std::setprecision(0)
+       << total << " ms):";
+    for (const auto &e : entries_) {
+      int from = total > 0 ? static_cast<int>(e.startMs / total * barWidth) : 0;
+      int to = total > 0 ? static_cast<int>(e.endMs / total * barWidth) : 0;
+      to = std::max(to, from + 1);
+      ss << "\n  " << std::setw(16) << std::left << e.name << std::right << " "
+         << std::setw(6) << e.startMs << " -> " << std::setw(6) << e.endMs
+         << " ms  |" << std::string(from, ' ') << std::string(to - from, '#')
+         << std::string(std::max(0, barWidth - to), ' ') << "|";
+    }
+    return ss.str();
+  }
+
+private:
+  struct Entry {
+    std::string name;
+    double startMs;
+    double endMs;
+  };
+
+  double toMs(std::chrono::steady_clock::time_point t) const {
+    return std::chrono::duration<double, std::milli>(t - origin_).count();
+  }
+
+  std::chrono::steady_clock::time_point origin_;
+  mutable std::mutex mutex_;
+  std::vector<Entry> entries_;
+};
+
 // Logging utilities
 enum class LogLevel { INFO, WARNING, ERR };
 
@@ -200,6 +264,9 @@ inline void appLog(LogLevel level, const std::string &message) {
     prefix = "[ERROR] ";
     break;
   }
+  // Startup and capture threads log concurrently; keep lines whole
+  static std::mutex logMutex;
+  std::lock_guard<std::mutex> lock(logMutex);
   std::cout << prefix << message << std::endl;
 }
 
@@ -1,8 +1,8 @@
 // Visualizer Implementation
 
 #include "Visualizer.h"
+#include <cstdio>
 #include <iomanip>
-#include <sstream>
 
 namespace RealsenseBodyPose {
 
@@ -50,59 +50,70 @@ void Visualizer::drawBBox(cv::Mat &image, const float *bbox,
 }
 
 void Visualizer::drawFPS(cv::Mat &image, double fps) {
-  std::stringstream ss;
-  ss << std::fixed << std::setprecision(1) << "FPS: " << fps;
+  char text[32];
+  std::snprintf(text, sizeof(text), "FPS: %.1f", fps);
 
   // Draw background rectangle
   cv::Size textSize =
-      cv::getTextSize(ss.str(), cv::FONT_HERSHEY_SIMPLEX, 0.7, 2, nullptr);
+      cv::getTextSize(text, cv::FONT_HERSHEY_SIMPLEX, 0.7, 2, nullptr);
   cv::rectangle(image, cv::Point(10, 10),
                 cv::Point(20 + textSize.width, 40 + textSize.height),
                 cv::Scalar(0, 0, 0), -1);
 
   // Draw text
-  cv::putText(image, ss.str(), cv::Point(15, 35), cv::FONT_HERSHEY_SIMPLEX, 0.7,
+  cv::putText(image, text, cv::Point(15, 35), cv::FONT_HERSHEY_SIMPLEX, 0.7,
               cv::Scalar(0, 255, 0), 2);
 }
 
-void Visualizer::draw(cv::Mat &image, const std::vector<Skeleton> &skeletons,
+void Visualizer::draw(cv::Mat &image, const SkeletonBatch &skeletons,
                       double fps) {
   // Draw each detected person
-  for (size_t personIdx = 0; personIdx < skeletons.size(); personIdx++) {
-    const auto &skeleton = skeletons[personIdx];
+  for (int personIdx = 0; personIdx < skeletons.size(); personIdx++) {
+    const SkeletonView skeleton = skeletons[personIdx];
 
-    // Use different colors for different people
+    // Use different colors for different people, following the track so a
+    // person keeps their color
+    const int id = skeleton.publicId();
     cv::Scalar bboxColor = cv::Scalar(0, 255, 0); // Green
-    if (personIdx == 1)
+    if (id % 3 == 1)
       bboxColor = cv::Scalar(255, 0, 0); // Blue
-    if (personIdx == 2)
+    if (id % 3 == 2)
       bboxColor = cv::Scalar(0, 0, 255); // Red
 
     // Draw bounding box
-    drawBBox(image, skeleton.bbox, bboxColor);
-
-    // Draw confidence score
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(2) << skeleton.overallConfidence;
-    cv::putText(image, ss.str(),
-                cv::Point(skeleton.bbox[0], skeleton.bbox[1] - 5),
+    drawBBox(image, skeleton.bbox(), bboxColor);
+
+    // Draw track ID and confidence score
+    char text[32];
+    if (skeleton.trackId() >= 0) {
+      std::snprintf(text, sizeof(text), "#%d %.2f", skeleton.trackId(),
+                    skeleton.confidence());
+    } else {
+      std::snprintf(text, sizeof(text), "%.2f", skeleton.confidence());
+    }
+    cv::putText(image, text,
+                cv::Point(skeleton.bbox()[0], skeleton.bbox()[1] - 5),
                 cv::FONT_HERSHEY_SIMPLEX, 0.5, bboxColor, 2);
 
     // Draw skeleton bones
-    for (const auto &connection : SKELETON_CONNECTIONS) {
-      int idx1 = connection.first;
-      int idx2 = connection.second;
+    for (const Bone &bone : ActiveTopology::kBones) {
+      int idx1 = bone.from;
+      int idx2 = bone.to;
 
-      const Keypoint2D &kpt1 = skeleton.keypoints2D[idx1];
-      const Keypoint2D &kpt2 = skeleton.keypoints2D[idx2];
+      const Keypoint2D kpt1 = skeleton.keypoint2D(idx1);
+      const Keypoint2D kpt2 = skeleton.keypoint2D(idx2);
 
       // Use cyan color for bones
       drawBone(image, kpt1, kpt2, cv::Scalar(255, 255, 0));
     }
 
-    // Draw keypoints (on top of bones)
-    for (size_t i = 0; i < skeleton.keypoints2D.size(); i++) {
-      drawKeypoint(image, skeleton.keypoints2D[i], JOINT_COLORS[i]);
+    // Draw keypoints (on top of bones); joints beyond the COCO body (feet,
+    // face, hands) share one color
+    for (int i = 0; i < kNumJoints; i++) {
+      const cv::Scalar color = i < static_cast<int>(JOINT_COLORS.size())
+                                   ? JOINT_COLORS[i]
+                                   : cv::Scalar(255, 255, 255);
+      drawKeypoint(image, skeleton.keypoint2D(i), color);
     }
   }
 
@@ -144,22 +155,27 @@ int Visualizer::show(const cv::Mat &image) {
   return cv::waitKey(1);
 }
 
-void Visualizer::print3DCoordinates(const std::vector<Skeleton> &skeletons) {
+void Visualizer::print3DCoordinates(const SkeletonBatch &skeletons) {
   if (!config_.show3DCoords || skeletons.empty()) {
     return;
   }
 
   std::cout << "\n========== 3D Skeleton Coordinates ==========\n";
 
-  for (size_t personIdx = 0; personIdx < skeletons.size(); personIdx++) {
-    const auto &skeleton = skeletons[personIdx];
+  for (int personIdx = 0; personIdx < skeletons.size(); personIdx++) {
+    const SkeletonView skeleton = skeletons[personIdx];
 
-    std::cout << "\nPerson " << (personIdx + 1)
-              << " (Confidence: " << std::fixed << std::setprecision(2)
-              << skeleton.overallConfidence << "):\n";
+    std::cout << "\nPerson ";
+    if (skeleton.trackId() >= 0) {
+      std::cout << "#" << skeleton.trackId();
+    } else {
+      std::cout << (personIdx + 1);
+    }
+    std::cout << " (Confidence: " << std::fixed << std::setprecision(2)
+              << skeleton.confidence() << "):\n";
 
     // Print major joints only for clarity
-    std::vector<int> majorJoints = {
+    static const int majorJoints[] = {
         0,      // Nose (Head)
         5,  6,  // Shoulders
         9,  10, // Wrists (Hands)
@@ -168,7 +184,7 @@ void Visualizer::print3DCoordinates(const std::vector<Skeleton> &skeletons) {
     };
 
     for (int jointIdx : majorJoints) {
-      const Keypoint3D &kpt3D = skeleton.keypoints3D[jointIdx];
+      const Keypoint3D kpt3D = skeleton.keypoint3D(jointIdx);
 
       if (kpt3D.isValid()) {
         std::cout << "  " << std::setw(15) << std::left
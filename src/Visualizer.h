@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "SkeletonBatch.h"
 #include "Utils.h"
 #include <opencv2/opencv.hpp>
 #include <string>
@@ -26,7 +27,7 @@ public:
     int boneThickness = 2;
     float confidenceThreshold = 0.3f;
 
-    Config() = default;
+    Config() {}
   };
 
   /**
@@ -46,7 +47,7 @@ public:
    * @param skeletons Detected skeletons with 2D and 3D keypoints
    * @param fps Current FPS (optional)
    */
-  void draw(cv::Mat &image, const std::vector<Skeleton> &skeletons,
+  void draw(cv::Mat &image, const SkeletonBatch &skeletons,
             double fps = 0.0);
 
   /**
@@ -67,7 +68,7 @@ public:
    * @brief Print 3D skeleton coordinates to console
    * @param skeletons Skeletons to print
    */
-  void print3DCoordinates(const std::vector<Skeleton> &skeletons);
+  void print3DCoordinates(const SkeletonBatch &skeletons);
 
   /**
    * @brief Check if user wants to quit (ESC key)
@@ -0,0 +1,163 @@
+// Wire Format Implementation
+
+#include "WireFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace RealsenseBodyPose {
+
+namespace {
+
+// Explicit byte order so the packet is the same on any host
+inline uint8_t *put16(uint8_t *p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  return p + 2;
+}
+
+inline uint8_t *put32(uint8_t *p, uint32_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+  p[2] = static_cast<uint8_t>(v >> 16);
+  p[3] = static_cast<uint8_t>(v >> 24);
+  return p + 4;
+}
+
+inline uint8_t *put64(uint8_t *p, uint64_t v) {
+  p = put32(p, static_cast<uint32_t>(v));
+  return put32(p, static_cast<uint32_t>(v >> 32));
+}
+
+inline uint16_t get16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t get64(const uint8_t *p) {
+  return get32(p) | (static_cast<uint64_t>(get32(p + 4)) << 32);
+}
+
+// Meters -> millimetres, saturated to int16
+inline uint16_t quantizeMm(float meters) {
+  float mm = std::round(meters * 1000.0f);
+  mm = std::min(32767.0f, std::max(-32768.0f, mm));
+  return static_cast<uint16_t>(static_cast<int16_t>(mm));
+}
+
+// [0, 1] -> [0, 255]
+inline uint8_t quantizeUnit(float value) {
+  float scaled = std::round(value * 255.0f);
+  return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, scaled)));
+}
+
+} // namespace
+
+size_t encodeWirePacket(const SkeletonBatch &skeletons, uint32_t sequence,
+                        const FrameInfo *info, uint8_t *out, size_t capacity,
+                        const JointMask<kNumJoints> *joints) {
+  if (capacity < kWireHeaderBytes) {
+    return 0;
+  }
+  uint8_t *const end = out + capacity;
+
+  uint8_t *p = put32(out, kWireMagic);
+  *p++ = kWireVersion;
+  *p++ = static_cast<uint8_t>(kNumJoints);
+  *p++ = static_cast<uint8_t>(skeletons.size());
+  *p++ = 0; // flags
+  p = put32(p, sequence);
+  p = put32(p, info ? static_cast<uint32_t>(info->frameNumber) : 0);
+  p = put64(p, info ? static_cast<uint64_t>(static_cast<int64_t>(
+                          std::llround(info->sensorTimestampMs * 1000.0)))
+                    : 0);
+
+  for (int i = 0; i < skeletons.size(); i++) {
+    const SkeletonView skel = skeletons[i];
+    if (static_cast<size_t>(end - p) < kWirePersonHeaderBytes) {
+      return 0;
+    }
+
+    p = put32(p, static_cast<uint32_t>(skel.publicId()));
+    *p++ = quantizeUnit(skel.confidence());
+    uint8_t *mask = p;
+    std::memset(mask, 0, kWireMaskBytes);
+    p += kWireMaskBytes;
+
+    for (int j = 0; j < kNumJoints; j++) {
+      if (!skel.hasKeypoint3D(j) || (joints && !joints->test(j))) {
+        continue;
+      }
+      const Keypoint3D k3d = skel.keypoint3D(j);
+      if (!k3d.isValid()) {
+        continue;
+      }
+      if (static_cast<size_t>(end - p) < kWireJointBytes) {
+        return 0;
+      }
+      mask[j >> 3] |= static_cast<uint8_t>(1u << (j & 7));
+      p = put16(p, quantizeMm(k3d.x));
+      p = put16(p, quantizeMm(k3d.y));
+      p = put16(p, quantizeMm(k3d.z));
+      *p++ = quantizeUnit(k3d.confidence);
+    }
+  }
+
+  return static_cast<size_t>(p - out);
+}
+
+bool decodeWirePacket(const uint8_t *data, size_t size, WirePacket &packet) {
+  if (size < kWireHeaderBytes || get32(data) != kWireMagic ||
+      data[4] != kWireVersion) {
+    return false;
+  }
+
+  packet.version = data[4];
+  packet.jointCount = data[5];
+  const int personCount = data[6];
+  packet.sequence = get32(data + 8);
+  packet.frameNumber = get32(data + 12);
+  packet.timestampUs = static_cast<int64_t>(get64(data + 16));
+  packet.people.clear();
+
+  const size_t maskBytes = (packet.jointCount + 7) / 8;
+  const uint8_t *p = data + kWireHeaderBytes;
+  const uint8_t *const end = data + size;
+
+  for (int i = 0; i < personCount; i++) {
+    if (static_cast<size_t>(end - p) < 5 + maskBytes) {
+      return false;
+    }
+    WirePerson person;
+    person.id = static_cast<int32_t>(get32(p));
+    person.confidence = p[4] / 255.0f;
+    const uint8_t *mask = p + 5;
+    p += 5 + maskBytes;
+
+    for (int j = 0; j < packet.jointCount; j++) {
+      if (!((mask[j >> 3] >> (j & 7)) & 1u)) {
+        continue;
+      }
+      if (static_cast<size_t>(end - p) < kWireJointBytes) {
+        return false;
+      }
+      WireJoint joint;
+      joint.joint = j;
+      joint.x = static_cast<int16_t>(get16(p)) / 1000.0f;
+      joint.y = static_cast<int16_t>(get16(p + 2)) / 1000.0f;
+      joint.z = static_cast<int16_t>(get16(p + 4)) / 1000.0f;
+      joint.confidence = p[6] / 255.0f;
+      person.joints.push_back(joint);
+      p += kWireJointBytes;
+    }
+    packet.people.push_back(person);
+  }
+  return true;
+}
+
+} // namespace RealsenseBodyPose
@@ -0,0 +1,104 @@
+// Compact binary skeleton packet (versioned, little-endian)
+
+#pragma once
+
+#include "SkeletonBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RealsenseBodyPose {
+
+/*
+ * Packet layout, all fields little-endian, no padding:
+ *
+ *   Header (24 bytes)
+ *     uint32  magic          'R' 'B' 'P' 'S'
+ *     uint8   version        kWireVersion
+ *     uint8   jointCount     Joints per person in this topology
+ *     uint8   personCount
+ *     uint8   flags          Reserved, 0
+ *     uint32  sequence       Frames handed to the sender, wraps (a rate
+ *                            limited subscriber sees regular gaps)
+ *     uint32  frameNumber    Low 32 bits of FrameInfo::frameNumber
+ *     int64   timestampUs    Device timestamp (FrameInfo::sensorTimestampMs)
+ *
+ *   Per person
+ *     int32   id             Track id, or index in the frame when untracked
+ *     uint8   confidence     Detection score * 255
+ *     uint8   mask[(jointCount + 7) / 8]
+ *                            Bit j (LSB first): joint j has a valid 3D point
+ *     Per set bit, in joint order (7 bytes)
+ *       int16 x, y, z        Millimetres, camera frame
+ *       uint8 confidence     Keypoint confidence * 255
+ *
+ * Joints without a valid 3D position take one mask bit and nothing else.
+ */
+const uint32_t kWireMagic = 0x53504252; // "RBPS" on the wire
+const uint8_t kWireVersion = 1;
+const size_t kWireHeaderBytes = 24;
+const size_t kWireJointBytes = 7;
+const size_t kWireMaskBytes = (kNumJoints + 7) / 8;
+const size_t kWirePersonHeaderBytes = 5 + kWireMaskBytes;
+
+// Largest packet a full batch can produce
+const size_t kWireMaxPacketBytes =
+    kWireHeaderBytes +
+    kMaxPeople * (kWirePersonHeaderBytes + kNumJoints * kWireJointBytes);
+
+/**
+ * @brief Encode a batch into a binary packet
+ * @param skeletons People to send; joints are included when their
+ *        Keypoint3D::isValid()
+ * @param sequence Packet sequence number
+ * @param info Frame lineage for the header, or nullptr (fields left 0)
+ * @param out Output buffer
+ * @param capacity Size of out (kWireMaxPacketBytes always suffices)
+ * @param joints Only include joints in this subset, or nullptr for all
+ * @return Bytes written, or 0 if the packet does not fit
+ */
+size_t encodeWirePacket(const SkeletonBatch &skeletons, uint32_t sequence,
+                        const FrameInfo *info, uint8_t *out, size_t capacity,
+                        const JointMask<kNumJoints> *joints = nullptr);
+
+/**
+ * @brief One decoded joint (meters, as sent after quantization)
+ */
+struct WireJoint {
+  int joint;
+  float x, y, z;
+  float confidence;
+};
+
+/**
+ * @brief One decoded person
+ */
+struct WirePerson {
+  int id;
+  float confidence;
+  std::vector<WireJoint> joints; // Valid joints only, in joint order
+};
+
+/**
+ * @brief A decoded packet
+ */
+struct WirePacket {
+  uint8_t version = 0;
+  int jointCount = 0;
+  uint32_t sequence = 0;
+  uint32_t frameNumber = 0;
+  int64_t timestampUs = 0;
+  std::vector<WirePerson> people;
+};
+
+/**
+ * @brief Reference decoder for encodeWirePacket()
+ *
+ * Not used on the hot path; documents the format for receivers and checks
+ * round trips.
+ *
+ * @return false if the data is truncated or not a version 1 packet
+ */
+bool decodeWirePacket(const uint8_t *data, size_t size, WirePacket &packet);
+
+} // namespace RealsenseBodyPose
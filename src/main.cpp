@@ -1,18 +1,30 @@
 #define NOMINMAX
 // Main Application - Real-Time 3D Skeletal Tracking
 
+#include "AllocationStats.h"
 #include "DataRecorder.h"
+#include "ImageDirectorySource.h"
+#include "LatencyReport.h"
 #include "PoseEstimator.h"
+#include "PoseTracker.h"
 #include "RealSenseCamera.h"
 #include "SkeletonProjector.h"
+#include "SkeletonShmWriter.h"
+#include "StagePipeline.h"
+#include "SyntheticSource.h"
 #include "UdpSender.h"
 #include "Utils.h"
 #include "Visualizer.h"
 
+#include <atomic>
 #include <exception>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <signal.h>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace RealsenseBodyPose;
 
@@ -34,6 +46,51 @@ void printUsage(const char *programName) {
   std::cout << "  --fps <int>         Camera FPS (default: 30)\n";
   std::cout << "  --confidence <f>    Detection confidence threshold (default: "
                "0.5)\n";
+  std::cout << "  --oks-nms           Suppress duplicate people by keypoint "
+               "similarity (OKS) instead of box IoU\n";
+  std::cout << "  --no-tracking       Report people by detection index instead "
+               "of persistent track IDs\n";
+  std::cout << "  --track-birth <n>   Frames a new person must be seen before "
+               "being reported (default: 3)\n";
+  std::cout << "  --track-hold <n>    Frames a lost person keeps their ID "
+               "(default: 15)\n";
+  std::cout << "  --wire <format>     UDP payload: json (key joints), binary "
+               "(all joints, compact) or delta (keyframes + changes) "
+               "(default: json)\n";
+  std::cout << "  --udp <spec>        Add a UDP subscriber (repeatable): "
+               "ip:port[,format=json|binary|delta][,rate=<hz>][,joints=all|"
+               "body|key|9+10] (default: 172.31.69.131:8888); json only "
+               "sends key joints, so its set narrows them\n";
+  std::cout << "  --keyframe-interval <n> Delta stream: frames between "
+               "keyframes of a person (default: 60)\n";
+  std::cout << "  --delta-epsilon <mm> Delta stream: joint moves smaller than "
+               "this are not sent (default: 5)\n";
+  std::cout << "  --heartbeat-ms <ms> Delta stream: longest silence while "
+               "nothing changes (default: 200)\n";
+  std::cout << "  --mtu <bytes>       Split binary and delta packets into "
+               "fragments that fit this MTU, 0 to never split (JSON is never "
+               "split) (default: 1500)\n";
+  std::cout << "  --shm               Also publish skeletons to shared memory "
+               "for same-host readers (SkeletonShm.h)\n";
+  std::cout << "  --async-capture     Acquire frames on a dedicated thread\n";
+  std::cout << "  --capture-policy <p> Ring policy for async capture: latest, "
+               "drop-oldest, block (default: latest)\n";
+  std::cout << "  --sparse-align      Map keypoints into raw depth instead of "
+               "aligning every depth pixel\n";
+  std::cout << "  --adaptive-depth    Scale the depth sampling window with "
+               "each person's size and joint\n";
+  std::cout << "  --bag <file>        Play back a .bag recording instead of "
+               "the camera\n";
+  std::cout << "  --images <dir>      Read color_*.png / depth_*.png pairs "
+               "from a directory\n";
+  std::cout << "  --synthetic         Generate synthetic frames (no camera "
+               "needed)\n";
+  std::cout << "  --frames <n>        Stop offline sources after n frames "
+               "(synthetic)\n";
+  std::cout << "  --no-realtime       Feed offline frames as fast as the "
+               "pipeline consumes them\n";
+  std::cout << "  --loop              Restart bag/image playback at end of "
+               "input\n";
   std::cout << "  --help              Show this help message\n\n";
   std::cout << "Example:\n";
   std::cout << "  " << programName << " --model models/yolov8n-pose.onnx\n\n";
@@ -50,25 +107,116 @@ int main(int argc, char *argv[]) {
   int cameraHeight = 480;
   int cameraFPS = 60;
   float confidenceThreshold = 0.3f;
+  bool oksNms = false;
+  bool tracking = true;
+  PoseTracker::Config trackerConfig;
+  bool asyncCapture = false;
+  bool sparseAlignment = false;
+  bool adaptiveDepth = false;
+  OverflowPolicy capturePolicy = OverflowPolicy::LATEST_ONLY;
+  std::string bagFile;
+  std::string imageDirectory;
+  bool synthetic = false;
+  long long frameLimit = 0;
+  bool realTime = true;
+  bool loopPlayback = false;
+  UdpSender::Encoding wireEncoding = UdpSender::Encoding::JSON;
+  std::vector<std::string> udpSpecs;
+  size_t udpMtu = kDefaultMtu;
+  DeltaWireEncoder::Config deltaConfig;
+  bool sharedMemory = false;
 
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
-
-    if (arg == "--help" || arg == "-h") {
-      printUsage(argv[0]);
-      return 0;
-    } else if (arg == "--model" && i + 1 < argc) {
-      modelPath = argv[++i];
-    } else if (arg == "--width" && i + 1 < argc) {
-      cameraWidth = std::stoi(argv[++i]);
-    } else if (arg == "--height" && i + 1 < argc) {
-      cameraHeight = std::stoi(argv[++i]);
-    } else if (arg == "--fps" && i + 1 < argc) {
-      cameraFPS = std::stoi(argv[++i]);
-    } else if (arg == "--confidence" && i + 1 < argc) {
-      confidenceThreshold = std::stof(argv[++i]);
-    } else {
-      std::cerr << "Unknown argument: " << arg << "\n";
+    try {
+      if (arg == "--help" || arg == "-h") {
+        printUsage(argv[0]);
+        return 0;
+      } else if (arg == "--model" && i + 1 < argc) {
+        modelPath = argv[++i];
+      } else if (arg == "--width" && i + 1 < argc) {
+        cameraWidth = std::stoi(argv[++i]);
+      } else if (arg == "--height" && i + 1 < argc) {
+        cameraHeight = std::stoi(argv[++i]);
+      } else if (arg == "--fps" && i + 1 < argc) {
+        cameraFPS = std::stoi(argv[++i]);
+      } else if (arg == "--confidence" && i + 1 < argc) {
+        confidenceThreshold = std::stof(argv[++i]);
+      } else if (arg == "--oks-nms") {
+        oksNms = true;
+      } else if (arg == "--no-tracking") {
+        tracking = false;
+      } else if (arg == "--track-birth" && i + 1 < argc) {
+        trackerConfig.birthFrames = std::stoi(argv[++i]);
+      } else if (arg == "--track-hold" && i + 1 < argc) {
+        trackerConfig.maxMissedFrames = std::stoi(argv[++i]);
+      } else if (arg == "--bag" && i + 1 < argc) {
+        bagFile = argv[++i];
+      } else if (arg == "--images" && i + 1 < argc) {
+        imageDirectory = argv[++i];
+      } else if (arg == "--synthetic") {
+        synthetic = true;
+      } else if (arg == "--frames" && i + 1 < argc) {
+        frameLimit = std::stoll(argv[++i]);
+      } else if (arg == "--no-realtime") {
+        realTime = false;
+      } else if (arg == "--loop") {
+        loopPlayback = true;
+      } else if (arg == "--sparse-align") {
+        sparseAlignment = true;
+      } else if (arg == "--adaptive-depth") {
+        adaptiveDepth = true;
+      } else if (arg == "--shm") {
+        sharedMemory = true;
+      } else if (arg == "--async-capture") {
+        asyncCapture = true;
+      } else if (arg == "--wire" && i + 1 < argc) {
+        std::string format = argv[++i];
+        if (format == "json") {
+          wireEncoding = UdpSender::Encoding::JSON;
+        } else if (format == "binary") {
+          wireEncoding = UdpSender::Encoding::BINARY;
+        } else if (format == "delta") {
+          wireEncoding = UdpSender::Encoding::DELTA;
+        } else {
+          std::cerr << "Unknown wire format: " << format << "\n";
+          printUsage(argv[0]);
+          return 1;
+        }
+      } else if (arg == "--udp" && i + 1 < argc) {
+        udpSpecs.push_back(argv[++i]);
+      } else if (arg == "--keyframe-interval" && i + 1 < argc) {
+        deltaConfig.keyframeInterval = std::stoi(argv[++i]);
+      } else if (arg == "--delta-epsilon" && i + 1 < argc) {
+        deltaConfig.epsilonMm = std::stof(argv[++i]);
+      } else if (arg == "--heartbeat-ms" && i + 1 < argc) {
+        deltaConfig.heartbeatMs = std::stoi(argv[++i]);
+      } else if (arg == "--mtu" && i + 1 < argc) {
+        const long mtu = std::stol(argv[++i]);
+        if (mtu < 0) {
+          throw std::invalid_argument("negative MTU");
+        }
+        udpMtu = static_cast<size_t>(mtu);
+      } else if (arg == "--capture-policy" && i + 1 < argc) {
+        std::string policy = argv[++i];
+        if (policy == "latest") {
+          capturePolicy = OverflowPolicy::LATEST_ONLY;
+        } else if (policy == "drop-oldest") {
+          capturePolicy = OverflowPolicy::DROP_OLDEST;
+        } else if (policy == "block") {
+          capturePolicy = OverflowPolicy::BLOCK;
+        } else {
+          std::cerr << "Unknown capture policy: " << policy << "\n";
+          printUsage(argv[0]);
+          return 1;
+        }
+      } else {
+        std::cerr << "Unknown argument: " << arg << "\n";
+        printUsage(argv[0]);
+        return 1;
+      }
+    } catch (const std::logic_error &) { // std::stoi and friends
+      std::cerr << "Invalid value for " << arg << "\n";
       printUsage(argv[0]);
       return 1;
     }
@@ -81,124 +229,342 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
+  // UDP subscribers; --wire is the default format for each of them
+  UdpSender::Config udpConfig;
+  udpConfig.mtu = udpMtu;
+  udpConfig.delta = deltaConfig;
+  if (udpSpecs.empty()) {
+    udpSpecs.push_back("172.31.69.131:8888");
+  }
+  for (const std::string &spec : udpSpecs) {
+    UdpSender::Subscriber subscriber;
+    subscriber.encoding = wireEncoding;
+    if (!subscriber.parse(spec)) {
+      std::cerr << "Invalid --udp subscriber: " << spec << "\n";
+      printUsage(argv[0]);
+      return 1;
+    }
+    udpConfig.subscribers.push_back(subscriber);
+  }
+
   try {
     appLog(LogLevel::INFO, "=== RealSense 3D Skeletal Tracking ===");
     appLog(LogLevel::INFO, "Starting initialization...");
+    StartupTimeline timeline;
+
+    // 1. Create frame source (RealSense camera or offline input)
+    std::unique_ptr<FrameSource> source;
+    RealSenseCamera *captureRing = nullptr; // Camera with --async-capture
+    if (synthetic) {
+      SyntheticSource::Config syntheticConfig;
+      syntheticConfig.width = cameraWidth;
+      syntheticConfig.height = cameraHeight;
+      syntheticConfig.fps = cameraFPS;
+      syntheticConfig.realTime = realTime;
+      syntheticConfig.frameCount = frameLimit;
+      source = std::make_unique<SyntheticSource>(syntheticConfig);
+    } else if (!imageDirectory.empty()) {
+      ImageDirectorySource::Config imageConfig(imageDirectory);
+      imageConfig.fps = cameraFPS;
+      imageConfig.realTime = realTime;
+      imageConfig.loop = loopPlayback;
+      source = std::make_unique<ImageDirectorySource>(imageConfig);
+    } else {
+      RealSenseCamera::Config cameraConfig;
+      cameraConfig.colorWidth = cameraWidth;
+      cameraConfig.colorHeight = cameraHeight;
+      cameraConfig.colorFPS = cameraFPS;
+      cameraConfig.depthWidth = cameraWidth;
+      cameraConfig.depthHeight = cameraHeight;
+      cameraConfig.depthFPS = cameraFPS;
+      cameraConfig.enableAlignment = true;
+      cameraConfig.sparseAlignment = sparseAlignment;
+      cameraConfig.asyncCapture = asyncCapture;
+      cameraConfig.overflowPolicy = capturePolicy;
+      cameraConfig.playbackFile = bagFile;
+      cameraConfig.realTime = realTime;
+      cameraConfig.loopPlayback = loopPlayback;
+      auto camera = std::make_unique<RealSenseCamera>(cameraConfig);
+      captureRing = asyncCapture ? camera.get() : nullptr;
+      source = std::move(camera);
+    }
 
-    // 1. Initialize RealSense Camera
-    appLog(LogLevel::INFO, "\n[1/4] Initializing RealSense Camera...");
-    RealSenseCamera::Config cameraConfig;
-    cameraConfig.colorWidth = cameraWidth;
-    cameraConfig.colorHeight = cameraHeight;
-    cameraConfig.colorFPS = cameraFPS;
-    cameraConfig.depthWidth = cameraWidth;
-    cameraConfig.depthHeight = cameraHeight;
-    cameraConfig.depthFPS = cameraFPS;
-    cameraConfig.enableAlignment = true;
-
-    RealSenseCamera camera(cameraConfig);
-    camera.start();
-
-    // 2. Initialize Pose Estimator
-    appLog(LogLevel::INFO, "\n[2/4] Initializing GPU Pose Estimator...");
+    // 2. Create Pose Estimator
     PoseEstimator::Config poseConfig(modelPath);
     poseConfig.confidenceThreshold = confidenceThreshold;
+    poseConfig.oksNms = oksNms;
     PoseEstimator poseEstimator(poseConfig);
-    poseEstimator.initialize();
-
-    // 3. Initialize Skeleton Projector
-    appLog(LogLevel::INFO, "\n[3/4] Initializing 3D Projector...");
-    SkeletonProjector projector(camera.getColorIntrinsics(),
-                                camera.getDepthScale());
-    appLog(LogLevel::INFO, "✅ 3D Projector initialized");
 
-    // 4. Initialize Visualizer
-    appLog(LogLevel::INFO, "\n[4/4] Initializing Visualizer...");
+    // Camera start (auto-exposure settling) and model load + warm-up are
+    // independent and each take seconds, so run them concurrently while the
+    // main thread brings up the lightweight components
+    appLog(LogLevel::INFO,
+           "\n[1/2] Starting frame source and GPU Pose Estimator...");
+    std::future<void> sourceReady = std::async(std::launch::async, [&]() {
+      auto span = timeline.span("frame source");
+      source->start();
+    });
+    std::future<void> modelReady = std::async(std::launch::async, [&]() {
+      {
+        auto span = timeline.span("model load");
+        poseEstimator.initialize();
+      }
+      auto span = timeline.span("model warm-up");
+      poseEstimator.warmup();
+    });
+
+    // 3. Initialize Visualizer (HighGUI windows belong to the main thread)
+    appLog(LogLevel::INFO, "\n[2/2] Initializing Visualizer, Network Bridge "
+                           "and Data Recorder...");
+    auto stepStart = std::chrono::steady_clock::now();
     Visualizer visualizer;
+    timeline.add("visualizer", stepStart, std::chrono::steady_clock::now());
     appLog(LogLevel::INFO, "✅ Visualizer initialized");
 
-    // 5. Initialize UDP Sender (Network Bridge)
-    appLog(LogLevel::INFO, "\n[5/5] Initializing Network Bridge (UDP)...");
-    UdpSender udpSender("172.31.69.131", 8888);
-    if (udpSender.initialize()) {
-      appLog(LogLevel::INFO, "✅ UDP Sender ready on 172.31.69.131:8888");
-    } else {
-      appLog(LogLevel::WARNING,
-             "⚠️ UDP Sender failed to initialize. Network features disabled.");
+    // 4. Initialize UDP Sender (Network Bridge)
+    UdpSender udpSender(udpConfig);
+    {
+      auto span = timeline.span("udp sender");
+      if (udpSender.initialize()) {
+        appLog(LogLevel::INFO,
+               "✅ UDP Sender ready for " +
+                   std::to_string(udpConfig.subscribers.size()) +
+                   " subscriber(s)");
+      } else {
+        appLog(LogLevel::WARNING, "⚠️ UDP Sender failed to initialize. "
+                                  "Network features disabled.");
+      }
     }
 
-    // 6. Initialize Data Recorder
-    appLog(LogLevel::INFO, "\n[6/6] Initializing Data Recorder...");
+    // 4b. Shared-memory publisher for same-host consumers
+    SkeletonShmWriter shmWriter;
+    if (sharedMemory) {
+      auto span = timeline.span("shared memory");
+      if (shmWriter.initialize()) {
+        appLog(LogLevel::INFO,
+               "✅ Shared-memory ring ready: " + shmWriter.name());
+      } else {
+        appLog(LogLevel::WARNING, "⚠️ Shared-memory ring failed to "
+                                  "initialize. Local publishing disabled.");
+      }
+    }
+
+    // 5. Initialize Data Recorder
+    stepStart = std::chrono::steady_clock::now();
     DataRecorder recorder;
+    timeline.add("data recorder", stepStart, std::chrono::steady_clock::now());
     appLog(LogLevel::INFO, "✅ Data Recorder initialized");
 
+    // Wait for the background initializations (rethrows their errors)
+    sourceReady.get();
+    modelReady.get();
+    appLog(LogLevel::INFO, "✅ Frame source: " + source->getName());
+
+    // 6. Initialize Skeleton Projector (needs the source intrinsics)
+    SkeletonProjector projector(source->getColorIntrinsics(),
+                                source->getDepthScale());
+    if (!source->isDepthAlignedToColor()) {
+      projector.enableSparseAlignment(source->getDepthIntrinsics(),
+                                      source->getColorToDepthExtrinsics(),
+                                      source->getDepthToColorExtrinsics());
+      appLog(LogLevel::INFO, "  Sparse keypoint-only depth alignment");
+    }
+    if (adaptiveDepth) {
+      projector.enableAdaptiveRadius();
+      appLog(LogLevel::INFO, "  Adaptive depth sampling radius");
+    }
+    appLog(LogLevel::INFO, "✅ 3D Projector initialized");
+
+    // 7. Person tracker (persistent IDs for every output)
+    PoseTracker tracker(trackerConfig);
+    if (tracking) {
+      appLog(LogLevel::INFO, "✅ Tracker: IDs after " +
+                                 std::to_string(trackerConfig.birthFrames) +
+                                 " frame(s), held for " +
+                                 std::to_string(trackerConfig.maxMissedFrames) +
+                                 " missed frame(s)");
+    }
+
+    appLog(LogLevel::INFO, "\n" + timeline.format());
     appLog(LogLevel::INFO, "\n✅✅✅ All systems ready! ✅✅✅");
     appLog(LogLevel::INFO, "Press ESC to quit\n");
 
     // Performance monitoring
     FPSCounter fpsCounter;
-    Timer frameTimer;
-
-    // Main loop
-    while (g_running) {
-      frameTimer.reset();
-
-      // Step 1: Capture frames from camera
-      cv::Mat colorImage, depthImage;
-      if (!camera.captureFrames(colorImage, depthImage, 5000)) {
-        appLog(LogLevel::WARNING, "Failed to capture frames");
-        continue;
+    LatencyReport latencyReport;
+    AllocationReport allocationReport;
+    long long frameCount = 0;
+
+    // Recording is toggled from the UI thread but the recorder is driven by
+    // the output stage, which applies the request before each frame. The
+    // indicator shows the recorder's own state, so it stays off if the file
+    // could not be created
+    std::atomic<bool> recordingRequested(false);
+
+    // Pipeline: capture -> estimate -> project -> output, one thread each,
+    // then display on this thread. Inference always takes the freshest
+    // frame; everything after it keeps every result.
+    using Edge = StagePipeline::EdgeConfig;
+    StagePipeline pipeline;
+
+    // Step 1: Capture frames from camera
+    pipeline.setSource("capture", [&](FramePacket &packet) {
+      bool captured;
+      {
+        AllocationZone zone(AllocZone::CAPTURE);
+        captured = source->captureFrames(packet.color, packet.depth, 5000,
+                                         &packet.info);
+      }
+      if (captured) {
+        return StagePipeline::SourceResult::FRAME;
+      }
+      if (source->isFinished()) {
+        appLog(LogLevel::INFO, "End of input reached. Draining...");
+        return StagePipeline::SourceResult::END_OF_INPUT;
+      }
+      appLog(LogLevel::WARNING, "Failed to capture frames");
+      return StagePipeline::SourceResult::NO_FRAME;
+    });
+
+    // Step 2: Run pose estimation (GPU)
+    pipeline.addStage(
+        "estimate",
+        [&](FramePacket &packet) {
+          {
+            AllocationZone zone(AllocZone::ESTIMATE);
+            poseEstimator.estimate(packet.color, packet.skeletons);
+          }
+          packet.info.inferenceNs = monotonicNowNs();
+        },
+        Edge(2, OverflowPolicy::LATEST_ONLY));
+
+    // Step 3: Project 2D keypoints to 3D using depth, then track. Every
+    // frame inference finishes reaches the tracker, empty ones included, so
+    // lost people age out; but captures dropped at the LATEST_ONLY estimate
+    // edge never do, so its per-frame gate, velocity and --track-hold count
+    // inferred frames, not camera frames
+    pipeline.addStage(
+        "project",
+        [&](FramePacket &packet) {
+          if (!packet.skeletons.empty()) {
+            {
+              AllocationZone zone(AllocZone::PROJECT);
+              projector.project(packet.skeletons, packet.depth);
+            }
+            packet.info.projectionNs = monotonicNowNs();
+          }
+          if (tracking) {
+            {
+              AllocationZone zone(AllocZone::TRACK);
+              tracker.update(packet.skeletons);
+            }
+            // Logged from this thread, which owns the tracker
+            if (tracker.stats().frames % 100 == 0) {
+              appLog(LogLevel::INFO, tracker.summary());
+            }
+          }
+        },
+        Edge(2, OverflowPolicy::BLOCK));
+
+    // Step 3b/3c: Send data via UDP and record it
+    pipeline.addStage(
+        "output",
+        [&](FramePacket &packet) {
+          bool wantRecording = recordingRequested.load();
+          if (wantRecording != recorder.isRecording()) {
+            if (wantRecording) {
+              if (!recorder.start()) {
+                recordingRequested = false; // Do not retry every frame
+              }
+            } else {
+              recorder.stop();
+            }
+          }
+
+          if (shmWriter.isInitialized()) {
+            AllocationZone zone(AllocZone::SEND);
+            shmWriter.publish(packet.skeletons, &packet.info);
+          }
+          {
+            // Empty frames too: delta receivers learn that everyone left
+            AllocationZone zone(AllocZone::SEND);
+            udpSender.send(packet.skeletons, &packet.info);
+          }
+          if (!packet.skeletons.empty() && recorder.isRecording()) {
+            AllocationZone zone(AllocZone::RECORD);
+            recorder.record(packet.skeletons, &packet.info);
+          }
+          latencyReport.addFrame(packet.info);
+
+          // Log performance metrics
+          if (++frameCount % 100 == 0) {
+            appLog(LogLevel::INFO, latencyReport.summary());
+            appLog(LogLevel::INFO, pipeline.summary());
+            appLog(LogLevel::INFO, udpSender.summary());
+            if (captureRing) {
+              appLog(LogLevel::INFO,
+                     "Capture ring: " +
+                         std::to_string(captureRing->getDroppedFrames()) +
+                         " framesets dropped");
+            }
+            if (kAllocationStatsEnabled) {
+              appLog(LogLevel::INFO, allocationReport.summary());
+            }
+          }
+        },
+        Edge(2, OverflowPolicy::BLOCK));
+
+    // Display only ever needs the newest result
+    pipeline.setOutput(Edge(2, OverflowPolicy::LATEST_ONLY));
+    pipeline.start();
+
+    // Main loop: display, and drain the pipeline on ESC / SIGINT / end of
+    // input so every frame already captured is still sent and recorded
+    FramePacket packet;
+    cv::Mat display; // Drawn on instead of the frame, which may be a view
+    while (!pipeline.isDrained()) {
+      if (!g_running) {
+        pipeline.stop();
       }
 
-      // Step 2: Run pose estimation (GPU)
-      std::vector<Skeleton> skeletons = poseEstimator.estimate(colorImage);
-
-      // Step 3: Project 2D keypoints to 3D using depth
-      if (!skeletons.empty()) {
-        projector.project(skeletons, depthImage);
-        // Step 3b: Send data via UDP
-        udpSender.send(skeletons);
-
-        // Step 3c: Record data
-        if (recorder.isRecording()) {
-          recorder.record(skeletons);
-        }
+      if (!pipeline.poll(packet, 100)) {
+        continue;
       }
 
       // Step 4: Visualize results
       fpsCounter.tick();
-      visualizer.draw(colorImage, skeletons, fpsCounter.getFPS());
-      visualizer.drawRecordingStatus(colorImage, recorder.isRecording());
+      {
+        AllocationZone zone(AllocZone::DRAW);
+        packet.color.copyTo(display);
+        visualizer.draw(display, packet.skeletons, fpsCounter.getFPS());
+      }
+      visualizer.drawRecordingStatus(display, recorder.isRecording());
 
-      visualizer.print3DCoordinates(skeletons);
+      visualizer.print3DCoordinates(packet.skeletons);
 
       // Step 6: Display and check for quit
-      int key = visualizer.show(colorImage);
+      int key = visualizer.show(display);
       if (visualizer.shouldQuit(key)) {
         appLog(LogLevel::INFO, "ESC pressed. Exiting...");
-        break;
+        pipeline.stop();
       }
 
       // Handle 'r' key for recording (key code 114 is 'r')
       if (key == 'r' || key == 'R') {
-        if (recorder.isRecording()) {
-          recorder.stop();
-        } else {
-          recorder.start();
-        }
+        recordingRequested = !recordingRequested.load();
       }
 
-      // Log performance metrics (Disabled for build stability)
-      /*
-      static int frameCount = 0;
-      if (++frameCount % 100 == 0) {
-          // ...
-      }
-      */
+      pipeline.recycle(packet);
+    }
+
+    pipeline.join();
+    appLog(LogLevel::INFO, pipeline.summary());
+    if (pipeline.hasFailed()) {
+      throw std::runtime_error("Pipeline stage failed");
     }
 
     appLog(LogLevel::INFO, "\n=== Shutting down ===");
-    camera.stop();
+    source->stop();
     appLog(LogLevel::INFO, "✅ Shutdown complete");
 
     return 0;
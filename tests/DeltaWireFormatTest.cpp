@@ -0,0 +1,171 @@
+// Delta stream receivers must drop people who leave
+//
+// Encodes people walking out of view one by one and checks what
+// DeltaWireDecoder holds after every packet: people absent from a packet
+// are gone, an empty frame still produces one packet (then heartbeats), and
+// a receiver that lost that packet is cleared by the next heartbeat. Then
+// sends empty frames through a UdpSender to loopback delta and JSON
+// receivers: the delta one must hear that nobody is left, the JSON one
+// nothing at all.
+
+#include "DeltaWireFormat.h"
+#include "Fragmentation.h"
+#include "TestCheck.h"
+#include "UdpSender.h"
+#include "UdpSocket.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kDeltaPort = 47301;
+const int kJsonPort = 47302;
+const int64_t kFrameNs = 33333333;
+
+void fillBatch(int people, int frame, SkeletonBatch &batch) {
+  batch.clear();
+  for (int p = 0; p < people; p++) {
+    const float box[4] = {100.0f * p, 0.0f, 80.0f, 200.0f};
+    const int person = batch.addPerson(0.9f, box);
+    batch.trackId[person] = 10 + p;
+    for (int j = 0; j < kNumJoints; j++) {
+      batch.setKeypoint3D(person, j, 0.2f * p + 0.01f * frame,
+                          -0.5f + 0.05f * j, 2.0f);
+      batch.conf[j][person] = 0.8f;
+    }
+  }
+}
+
+bool holds(const WirePacket &packet, int id) {
+  for (const WirePerson &person : packet.people) {
+    if (person.id == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void checkDeparture() {
+  DeltaWireEncoder::Config config;
+  config.heartbeatMs = 200;
+  DeltaWireEncoder encoder(config);
+  DeltaWireDecoder decoder;
+  DeltaWireDecoder lateDecoder; // Will lose the "nobody" packet
+  std::vector<uint8_t> buffer(kDeltaMaxPacketBytes);
+  SkeletonBatch batch;
+  WirePacket packet;
+
+  // Three people, then the last two walk out one at a time
+  int frame = 0;
+  for (int people : {3, 3, 2, 1}) {
+    fillBatch(people, frame, batch);
+    const size_t size =
+        encoder.encode(batch, frame, nullptr, frame * kFrameNs, buffer.data(),
+                       buffer.size());
+    CHECK(size > 0);
+    CHECK(lateDecoder.decode(buffer.data(), size, packet));
+    CHECK(decoder.decode(buffer.data(), size, packet));
+    CHECK(packet.people.size() == static_cast<size_t>(people));
+    CHECK(holds(packet, 10));
+    CHECK(holds(packet, 11) == (people >= 2));
+    CHECK(holds(packet, 12) == (people >= 3));
+    frame++;
+  }
+
+  // Nobody left: one packet says so, then silence until the heartbeat
+  batch.clear();
+  size_t size = encoder.encode(batch, frame, nullptr, frame * kFrameNs,
+                               buffer.data(), buffer.size());
+  CHECK(size > 0);
+  CHECK(decoder.decode(buffer.data(), size, packet));
+  CHECK(packet.people.empty());
+  frame++;
+
+  int silent = 0;
+  int heartbeats = 0;
+  for (int i = 0; i < 12; i++, frame++) {
+    size = encoder.encode(batch, frame, nullptr, frame * kFrameNs,
+                          buffer.data(), buffer.size());
+    if (size == 0) {
+      silent++;
+      continue;
+    }
+    heartbeats++;
+    CHECK(decoder.decode(buffer.data(), size, packet));
+    CHECK(packet.people.empty());
+    CHECK(lateDecoder.decode(buffer.data(), size, packet));
+    CHECK(packet.people.empty());
+  }
+  std::cout << "Empty frames: " << silent << " suppressed, " << heartbeats
+            << " heartbeats" << std::endl;
+  CHECK(silent > 0);
+  CHECK(heartbeats > 0);
+}
+
+// Packets received, after reassembly: with many joints (WHOLEBODY133) a
+// keyframe is larger than the default MTU and arrives in fragments
+size_t receiveAll(UdpSocket &socket, PacketReassembler &reassembler,
+                  WirePacket *packet, DeltaWireDecoder *decoder) {
+  static uint8_t buffer[65536];
+  UdpMessage message;
+  message.buffer = buffer;
+  message.capacity = sizeof(buffer);
+  size_t count = 0;
+  while (socket.receiveBatch(&message, 1) > 0) {
+    if (!reassembler.add(buffer, message.size, 0)) {
+      continue;
+    }
+    count++;
+    if (decoder) {
+      CHECK(decoder->decode(reassembler.data(), reassembler.size(), *packet));
+    }
+  }
+  return count;
+}
+
+void checkSender() {
+  UdpSocket deltaSocket;
+  UdpSocket jsonSocket;
+  CHECK(deltaSocket.open() && deltaSocket.bind(kDeltaPort));
+  CHECK(jsonSocket.open() && jsonSocket.bind(kJsonPort));
+
+  UdpSender::Config config;
+  config.asyncSend = false;
+  config.subscribers.push_back(UdpSender::Subscriber(
+      "127.0.0.1", kDeltaPort, UdpSender::Encoding::DELTA));
+  config.subscribers.push_back(UdpSender::Subscriber(
+      "127.0.0.1", kJsonPort, UdpSender::Encoding::JSON));
+  UdpSender sender(config);
+  CHECK(sender.initialize());
+
+  PacketReassembler deltaReassembler;
+  PacketReassembler jsonReassembler;
+  DeltaWireDecoder decoder;
+  WirePacket packet;
+  SkeletonBatch batch;
+  FrameInfo info;
+  fillBatch(2, 0, batch);
+  info.captureNs = kFrameNs;
+  sender.send(batch, &info);
+  CHECK(receiveAll(deltaSocket, deltaReassembler, &packet, &decoder) == 1);
+  CHECK(packet.people.size() == 2);
+  CHECK(receiveAll(jsonSocket, jsonReassembler, nullptr, nullptr) == 1);
+
+  batch.clear();
+  info.captureNs = 2 * kFrameNs;
+  sender.send(batch, &info);
+  CHECK(receiveAll(deltaSocket, deltaReassembler, &packet, &decoder) == 1);
+  CHECK(packet.people.empty());
+  CHECK(receiveAll(jsonSocket, jsonReassembler, nullptr, nullptr) == 0);
+}
+
+} // namespace
+
+int main() {
+  checkDeparture();
+  checkSender();
+  return test::report("DeltaWireFormatTest");
+}
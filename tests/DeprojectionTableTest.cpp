@@ -0,0 +1,155 @@
+// DeprojectionTable against rs2_deproject_pixel_to_point, per distortion model
+//
+// Realistic D4xx / T265-like intrinsics for every model librealsense can
+// deproject (modified Brown-Conrady is forward-only). Sub-pixel positions
+// inside the image are interpolated from the table; positions outside it
+// and pinhole intrinsics must match exactly. Tiles must only be built where
+// lookups land. Fisheye models are checked inside their image circle: past
+// 90 degrees off axis the ray is infinite and nothing can interpolate it.
+
+#include "DeprojectionTable.h"
+#include "TestCheck.h"
+#include <librealsense2/rsutil.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// Normalized ray units; 1e-4 is under 0.1 pixel at these focal lengths
+const float kMaxInterpolationError = 1e-4f;
+
+struct Case {
+  const char *name;
+  rs2_intrinsics intrinsics;
+  bool pinhole;       // Expected to skip the table
+  float maxRadius = 0; // Fisheye: image circle, normalized (0: whole image)
+};
+
+rs2_intrinsics makeIntrinsics(int width, int height, float f,
+                              rs2_distortion model, float k0, float k1,
+                              float k2, float k3, float k4) {
+  rs2_intrinsics intrinsics = {};
+  intrinsics.width = width;
+  intrinsics.height = height;
+  intrinsics.fx = f;
+  intrinsics.fy = f * 1.002f;
+  intrinsics.ppx = width / 2.0f + 3.7f;
+  intrinsics.ppy = height / 2.0f - 2.1f;
+  intrinsics.model = model;
+  intrinsics.coeffs[0] = k0;
+  intrinsics.coeffs[1] = k1;
+  intrinsics.coeffs[2] = k2;
+  intrinsics.coeffs[3] = k3;
+  intrinsics.coeffs[4] = k4;
+  return intrinsics;
+}
+
+float rayError(DeprojectionTable &table, const rs2_intrinsics &intrinsics,
+               float u, float v) {
+  const float pixel[2] = {u, v};
+  float point[3];
+  table.deproject(point, pixel, 2.0f);
+  float expected[3];
+  rs2_deproject_pixel_to_point(expected, &intrinsics, pixel, 2.0f);
+  return std::max(std::fabs(point[0] - expected[0]),
+                  std::fabs(point[1] - expected[1])) /
+         2.0f;
+}
+
+} // namespace
+
+int main() {
+  const Case cases[] = {
+      {"none", makeIntrinsics(640, 480, 615.0f, RS2_DISTORTION_NONE, 0, 0, 0,
+                              0, 0),
+       true},
+      {"brown-conrady (zero)",
+       makeIntrinsics(848, 480, 425.0f, RS2_DISTORTION_BROWN_CONRADY, 0, 0, 0,
+                      0, 0),
+       true},
+      {"inverse brown-conrady (zero)",
+       makeIntrinsics(1280, 720, 910.0f, RS2_DISTORTION_INVERSE_BROWN_CONRADY,
+                      0, 0, 0, 0, 0),
+       true},
+      {"brown-conrady",
+       makeIntrinsics(1280, 720, 640.0f, RS2_DISTORTION_BROWN_CONRADY, -0.055f,
+                      0.066f, 0.0004f, -0.0007f, -0.021f),
+       false},
+      {"inverse brown-conrady",
+       makeIntrinsics(1280, 720, 910.0f, RS2_DISTORTION_INVERSE_BROWN_CONRADY,
+                      -0.056f, 0.067f, 0.0002f, 0.0006f, -0.021f),
+       false},
+      {"kannala-brandt4",
+       makeIntrinsics(848, 800, 285.0f, RS2_DISTORTION_KANNALA_BRANDT4,
+                      -0.0047f, 0.0397f, -0.0373f, 0.0062f, 0),
+       false, 1.0f},
+      {"f-theta", makeIntrinsics(848, 800, 285.0f, RS2_DISTORTION_FTHETA,
+                                 0.92f, 0, 0, 0, 0),
+       false, 1.0f},
+  };
+
+  std::mt19937 rng(11);
+  for (const Case &c : cases) {
+    const rs2_intrinsics &intrinsics = c.intrinsics;
+    DeprojectionTable table(intrinsics);
+    CHECK(table.builtTiles() == 0); // Nothing computed up front
+
+    std::uniform_real_distribution<float> u(0.0f, intrinsics.width - 1e-3f);
+    std::uniform_real_distribution<float> v(0.0f, intrinsics.height - 1e-3f);
+    auto inside = [&](float x, float y) {
+      const float dx = (x - intrinsics.ppx) / intrinsics.fx;
+      const float dy = (y - intrinsics.ppy) / intrinsics.fy;
+      return c.maxRadius <= 0 || dx * dx + dy * dy <= c.maxRadius * c.maxRadius;
+    };
+    float worst = 0.0f;
+    for (int i = 0; i < 20000; i++) {
+      const float x = u(rng);
+      const float y = v(rng);
+      if (inside(x, y)) {
+        worst = std::max(worst, rayError(table, intrinsics, x, y));
+      }
+    }
+    // Image corners and edges, where distortion is strongest
+    const float w = static_cast<float>(intrinsics.width);
+    const float h = static_cast<float>(intrinsics.height);
+    const float edges[][2] = {{0, 0},         {w - 0.5f, 0},   {0, h - 0.5f},
+                              {w - 0.5f, h - 0.5f}, {w / 2, 0}, {0, h / 2}};
+    for (const auto &p : edges) {
+      if (inside(p[0], p[1])) {
+        worst = std::max(worst, rayError(table, intrinsics, p[0], p[1]));
+      }
+    }
+
+    // Outside the image: librealsense's own result, exactly
+    const float outside[][2] = {{-5.0f, 10.0f}, {w + 3.0f, h / 2}};
+    for (const auto &p : outside) {
+      CHECK(rayError(table, intrinsics, p[0], p[1]) == 0.0f);
+    }
+
+    std::cout << c.name << ": max ray error " << worst << ", "
+              << table.builtTiles() << " tiles" << std::endl;
+    if (c.pinhole) {
+      CHECK(table.builtTiles() == 0);
+      CHECK(worst <= 1e-6f); // Closed form, to float rounding
+    } else {
+      CHECK(table.builtTiles() > 0);
+      CHECK(worst <= kMaxInterpolationError);
+    }
+  }
+
+  // One lookup builds one tile
+  DeprojectionTable lazy(cases[3].intrinsics);
+  float point[3];
+  const float pixel[2] = {100.5f, 100.5f};
+  lazy.deproject(point, pixel, 1.0f);
+  CHECK(lazy.builtTiles() == 1);
+  lazy.deproject(point, pixel, 3.0f);
+  CHECK(lazy.builtTiles() == 1);
+  CHECK(point[2] == 3.0f);
+
+  return test::report("DeprojectionTableTest");
+}
@@ -0,0 +1,90 @@
+// sampleMedianDepth against the sort-based median it replaced
+//
+// Random depth with a third of the pixels invalid, window centers on, near
+// and off every image edge, every radius 0 to kMaxDepthSampleRadius (plus
+// out-of-range ones, which clamp). The results must be identical.
+
+#include "DepthSampler.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// The original SkeletonProjector::sampleDepth()
+uint16_t sortedMedian(const cv::Mat &depthImage, int x, int y, int radius) {
+  if (x < 0 || x >= depthImage.cols || y < 0 || y >= depthImage.rows) {
+    return 0;
+  }
+  std::vector<uint16_t> values;
+  for (int dy = -radius; dy <= radius; dy++) {
+    for (int dx = -radius; dx <= radius; dx++) {
+      const int sx = x + dx;
+      const int sy = y + dy;
+      if (sx >= 0 && sx < depthImage.cols && sy >= 0 &&
+          sy < depthImage.rows) {
+        const uint16_t depth = depthImage.at<uint16_t>(sy, sx);
+        if (depth > 0) {
+          values.push_back(depth);
+        }
+      }
+    }
+  }
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(3);
+  std::vector<uint16_t> pixels(64 * 48);
+  for (uint16_t &pixel : pixels) {
+    pixel = rng() % 3 == 0 ? 0 : static_cast<uint16_t>(rng() % 5000);
+  }
+  const cv::Mat depth(48, 64, CV_16UC1, pixels.data());
+
+  // Single windows, including clamped radii
+  int mismatches = 0;
+  const int trials = 200000;
+  std::vector<DepthQuery> queries;
+  std::vector<uint16_t> expected;
+  for (int t = 0; t < trials; t++) {
+    const int x = static_cast<int>(rng() % 80) - 8;
+    const int y = static_cast<int>(rng() % 64) - 8;
+    const int radius = static_cast<int>(rng() % (kMaxDepthSampleRadius + 1));
+    const uint16_t reference = sortedMedian(depth, x, y, radius);
+    mismatches += sampleMedianDepth(depth, x, y, radius) != reference;
+    if (queries.size() < 1000) {
+      queries.push_back({x, y, radius});
+      expected.push_back(reference);
+    }
+  }
+  std::cout << mismatches << " of " << trials << " windows differ"
+            << std::endl;
+  CHECK(mismatches == 0);
+
+  CHECK(sampleMedianDepth(depth, 10, 10, -3) ==
+        sortedMedian(depth, 10, 10, 0));
+  CHECK(sampleMedianDepth(depth, 10, 10, kMaxDepthSampleRadius + 5) ==
+        sortedMedian(depth, 10, 10, kMaxDepthSampleRadius));
+
+  // The batched call gives the same answers as one window at a time
+  std::vector<uint16_t> batched(queries.size());
+  sampleMedianDepths(depth, queries.data(), queries.size(), batched.data());
+  CHECK(batched == expected);
+
+  // A window without valid depth has no median
+  std::vector<uint16_t> holes(16 * 16, 0);
+  const cv::Mat empty(16, 16, CV_16UC1, holes.data());
+  CHECK(sampleMedianDepth(empty, 8, 8, kMaxDepthSampleRadius) == 0);
+
+  return test::report("DepthSamplerTest");
+}
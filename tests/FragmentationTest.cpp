@@ -0,0 +1,232 @@
+// PacketFragmenter / PacketReassembler, alone and behind UdpSender
+//
+// Random packets split at random MTUs must reassemble byte for byte from
+// fragments in any order, duplicated. Then a UdpSender sends 32 people as
+// binary and JSON to loopback receivers that lose, duplicate and reorder
+// datagrams: every reassembled binary packet must decode, about (1 - p)^k of
+// them must complete (k fragments per packet), the rest must expire, JSON
+// must go out whole, and a restarted sender must pick new message ids.
+
+#include "Fragmentation.h"
+#include "TestCheck.h"
+#include "UdpSender.h"
+#include "UdpSocket.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kBinaryPort = 47201;
+const int kJsonPort = 47202;
+const double kLossRate = 0.05;
+const int kFrames = 600;
+
+typedef std::vector<uint8_t> Datagram;
+
+void checkRoundTrips(std::mt19937 &rng) {
+  int completed = 0;
+  for (int run = 0; run < 2000; run++) {
+    const size_t mtu = 100 + rng() % 9000;
+    const size_t size = 1 + rng() % 65536;
+    PacketFragmenter fragmenter(mtu, 65536);
+    std::vector<char> packet(size);
+    for (char &c : packet) {
+      c = static_cast<char>(rng());
+    }
+
+    const int count = fragmenter.split(packet.data(), size, run);
+    std::vector<Datagram> datagrams;
+    for (int i = 0; i < count; i++) {
+      CHECK(fragmenter.datagramSize(i) <= maxDatagramBytes(mtu));
+      const uint8_t *data =
+          reinterpret_cast<const uint8_t *>(fragmenter.datagram(i));
+      datagrams.emplace_back(data, data + fragmenter.datagramSize(i));
+      if (count > 1 && rng() % 10 == 0) {
+        datagrams.push_back(datagrams.back());
+      }
+    }
+    std::shuffle(datagrams.begin(), datagrams.end(), rng);
+
+    PacketReassembler reassembler;
+    int done = 0;
+    for (const Datagram &datagram : datagrams) {
+      if (reassembler.add(datagram.data(), datagram.size(), 0)) {
+        done++;
+        CHECK(reassembler.size() == size);
+        CHECK(std::memcmp(reassembler.data(), packet.data(), size) == 0);
+      }
+    }
+    CHECK(done == 1);
+    completed += done == 1 ? 1 : 0;
+  }
+  std::cout << "Round trips: " << completed << "/2000" << std::endl;
+}
+
+void receiveAll(UdpSocket &socket, std::vector<Datagram> &out) {
+  static char buffers[16][65536]; // Whole JSON packets too
+  UdpMessage messages[16];
+  for (int i = 0; i < 16; i++) {
+    messages[i].buffer = buffers[i];
+    messages[i].capacity = sizeof(buffers[i]);
+  }
+  int count;
+  while ((count = socket.receiveBatch(messages, 16)) > 0) {
+    for (int i = 0; i < count; i++) {
+      const uint8_t *data = reinterpret_cast<const uint8_t *>(buffers[i]);
+      out.emplace_back(data, data + messages[i].size);
+    }
+  }
+}
+
+bool isFragment(const Datagram &datagram) {
+  uint32_t magic = 0;
+  if (datagram.size() >= 4) {
+    std::memcpy(&magic, datagram.data(), 4); // Little-endian hosts only
+  }
+  return magic == kFragmentMagic;
+}
+
+uint32_t messageIdOf(const Datagram &datagram) {
+  uint32_t id = 0;
+  std::memcpy(&id, datagram.data() + 12, 4);
+  return id;
+}
+
+void fillBatch(SkeletonBatch &batch) {
+  batch.clear();
+  for (int p = 0; p < kMaxPeople; p++) {
+    const float box[4] = {10.0f * p, 0.0f, 50.0f, 100.0f};
+    const int person = batch.addPerson(0.9f, box);
+    batch.trackId[person] = p;
+    for (int j = 0; j < kNumJoints; j++) {
+      batch.setKeypoint3D(person, j, 0.1f * j - p, 0.05f * p, 1.5f + j);
+      batch.conf[j][person] = 0.8f;
+    }
+  }
+}
+
+UdpSender::Config senderConfig() {
+  UdpSender::Config config;
+  config.asyncSend = false;
+  config.mtu = kDefaultMtu;
+  config.subscribers.push_back(UdpSender::Subscriber(
+      "127.0.0.1", kBinaryPort, UdpSender::Encoding::BINARY));
+  config.subscribers.push_back(UdpSender::Subscriber(
+      "127.0.0.1", kJsonPort, UdpSender::Encoding::JSON));
+  return config;
+}
+
+void checkLossyLoopback(std::mt19937 &rng) {
+  UdpSocket::Config socketConfig;
+  socketConfig.receiveBufferBytes = 4 << 20;
+  UdpSocket binarySocket;
+  UdpSocket jsonSocket;
+  CHECK(binarySocket.open(socketConfig) && binarySocket.bind(kBinaryPort));
+  CHECK(jsonSocket.open(socketConfig) && jsonSocket.bind(kJsonPort));
+
+  UdpSender sender(senderConfig());
+  CHECK(sender.initialize());
+  SkeletonBatch batch;
+  fillBatch(batch);
+
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  PacketReassembler reassembler;
+  std::vector<Datagram> received;
+  std::vector<Datagram> window;
+  std::vector<Datagram> json;
+  int completed = 0;
+  int corrupt = 0;
+  size_t fragmentsPerPacket = 0;
+  uint32_t firstMessageId = 0;
+  int64_t nowNs = 0;
+  for (int f = 0; f < kFrames; f++) {
+    FrameInfo info;
+    info.frameNumber = f;
+    info.captureNs = 1000000000LL + f * 33333333LL;
+    nowNs = info.captureNs;
+    sender.send(batch, &info);
+
+    received.clear();
+    receiveAll(binarySocket, received);
+    fragmentsPerPacket = std::max(fragmentsPerPacket, received.size());
+    for (const Datagram &datagram : received) {
+      CHECK(isFragment(datagram));
+      CHECK(datagram.size() <= maxDatagramBytes(kDefaultMtu));
+      firstMessageId = f == 0 ? messageIdOf(datagram) : firstMessageId;
+      if (uniform(rng) < kLossRate) {
+        continue;
+      }
+      window.push_back(datagram);
+      if (uniform(rng) < 0.05) {
+        window.push_back(datagram);
+      }
+    }
+    receiveAll(jsonSocket, json);
+
+    // Reorder across two frames' worth of datagrams
+    if (f % 2 == 1) {
+      std::shuffle(window.begin(), window.end(), rng);
+      for (const Datagram &datagram : window) {
+        if (!reassembler.add(datagram.data(), datagram.size(), nowNs)) {
+          continue;
+        }
+        completed++;
+        WirePacket packet;
+        if (!decodeWirePacket(reassembler.data(), reassembler.size(),
+                              packet) ||
+            packet.people.size() != static_cast<size_t>(kMaxPeople)) {
+          corrupt++;
+        }
+      }
+      window.clear();
+    }
+  }
+  reassembler.expire(nowNs + 1000000000LL);
+
+  const double expected = std::pow(1.0 - kLossRate, fragmentsPerPacket);
+  const double rate = static_cast<double>(completed) / kFrames;
+  std::cout << "Lossy loopback: " << fragmentsPerPacket
+            << " fragments per packet, " << completed << "/" << kFrames
+            << " complete (expected about " << expected << "), "
+            << reassembler.stats().expired << " expired, "
+            << reassembler.stats().duplicates << " duplicates" << std::endl;
+  CHECK(fragmentsPerPacket > 1);
+  CHECK(corrupt == 0);
+  CHECK(std::fabs(rate - expected) < 0.06);
+
+  // Packets that lost every fragment leave no trace
+  const size_t seen = completed + reassembler.stats().expired;
+  CHECK(seen <= static_cast<size_t>(kFrames) && seen >= kFrames * 99 / 100);
+  CHECK(reassembler.stats().duplicates > 0);
+
+  // JSON is never fragmented, whatever the MTU
+  CHECK(json.size() == static_cast<size_t>(kFrames));
+  for (const Datagram &datagram : json) {
+    CHECK(!datagram.empty() && datagram[0] == '{');
+  }
+
+  // A restarted sender must not reuse the ids still being reassembled
+  UdpSender restarted(senderConfig());
+  CHECK(restarted.initialize());
+  restarted.send(batch, nullptr);
+  received.clear();
+  receiveAll(binarySocket, received);
+  CHECK(!received.empty() && messageIdOf(received[0]) != firstMessageId);
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 rng(7);
+  checkRoundTrips(rng);
+  checkLossyLoopback(rng);
+  return test::report("FragmentationTest");
+}
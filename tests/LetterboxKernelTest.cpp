@@ -0,0 +1,83 @@
+// LetterboxKernel against the resize -> pad -> blobFromImage reference
+//
+// Random images at camera, odd and upscaled sizes, landscape and portrait,
+// run through one kernel and one tensor (so geometry changes are covered).
+// Every tensor value must be within one 8-bit step of the reference.
+
+#include "LetterboxKernel.h"
+#include "TestCheck.h"
+#include <opencv2/dnn.hpp>
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <iostream>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kInputWidth = 640;
+const int kInputHeight = 640;
+
+// cv::resize rounds differently in its SIMD/IPP paths than in scalar code
+const double kTolerance = 1.0 / 255.0 + 1e-6;
+
+// PoseEstimator::preprocess(), the path the kernel replaces
+cv::Mat reference(const cv::Mat &image, float &scale, float &padX,
+                  float &padY) {
+  scale = std::min(static_cast<float>(kInputWidth) / image.cols,
+                   static_cast<float>(kInputHeight) / image.rows);
+  const int newW = static_cast<int>(image.cols * scale);
+  const int newH = static_cast<int>(image.rows * scale);
+  padX = (kInputWidth - newW) / 2.0f;
+  padY = (kInputHeight - newH) / 2.0f;
+
+  cv::Mat resized;
+  cv::resize(image, resized, cv::Size(newW, newH));
+  cv::Mat padded = cv::Mat::zeros(kInputHeight, kInputWidth, CV_8UC3);
+  resized.copyTo(padded(cv::Rect(static_cast<int>(padX),
+                                 static_cast<int>(padY), newW, newH)));
+  return cv::dnn::blobFromImage(padded, 1.0 / 255.0,
+                                cv::Size(kInputWidth, kInputHeight),
+                                cv::Scalar(0, 0, 0), true, false);
+}
+
+} // namespace
+
+int main() {
+  const cv::Size sizes[] = {{640, 480}, {1280, 720}, {848, 480},
+                            {320, 240}, {333, 517},  {480, 640},
+                            {640, 480}};
+
+  LetterboxKernel kernel(kInputWidth, kInputHeight);
+  cv::Mat tensor;
+  cv::RNG rng(7);
+  for (const cv::Size &size : sizes) {
+    cv::Mat image(size, CV_8UC3);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+
+    float scale = 0.0f;
+    float padX = 0.0f;
+    float padY = 0.0f;
+    const cv::Mat expected = reference(image, scale, padX, padY);
+    kernel.run(image, tensor);
+
+    CHECK(tensor.dims == 4 && tensor.type() == CV_32F);
+    CHECK(tensor.total() == expected.total());
+    CHECK(kernel.scale() == scale);
+    CHECK(kernel.padX() == padX);
+    CHECK(kernel.padY() == padY);
+    if (tensor.total() != expected.total()) {
+      continue;
+    }
+
+    const cv::Mat a(1, static_cast<int>(tensor.total()), CV_32F,
+                    tensor.ptr<float>());
+    const cv::Mat b(1, static_cast<int>(expected.total()), CV_32F,
+                    const_cast<float *>(expected.ptr<float>()));
+    const double maxError = cv::norm(a, b, cv::NORM_INF);
+    std::cout << size.width << "x" << size.height << ": max error "
+              << maxError * 255.0 << " / 255" << std::endl;
+    CHECK(maxError <= kTolerance);
+  }
+  return test::report("LetterboxKernelTest");
+}
@@ -0,0 +1,230 @@
+// PoseTracker identity over a crowd, and track eviction with a full table
+//
+// Twenty simulated people walk around a room seen by a 1080p camera, in a
+// shuffled order every frame, with 5% of the detections missed and a
+// one-frame false positive in 5% of the frames. Each person must keep a
+// single ID, false positives must never be published and no ID may appear
+// twice in a frame; ID switches (two people swapping tracks as they cross)
+// are counted and bounded, and the update cost is printed.
+//
+// Then the track table is filled with coasting tracks, and a frame brings
+// back the longest-coasting person after a new one: the new person must not
+// take the returning person's track.
+
+#include "PoseTracker.h"
+#include "TestCheck.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// COCO joint offsets (x right, y down) in meters from the hip centre
+const float kBody[17][2] = {
+    {0.0f, -0.75f},   {-0.03f, -0.78f}, {0.03f, -0.78f}, {-0.07f, -0.76f},
+    {0.07f, -0.76f},  {-0.2f, -0.5f},   {0.2f, -0.5f},   {-0.25f, -0.25f},
+    {0.25f, -0.25f},  {-0.27f, 0.0f},   {0.27f, 0.0f},   {-0.12f, 0.0f},
+    {0.12f, 0.0f},    {-0.12f, 0.45f},  {0.12f, 0.45f},  {-0.12f, 0.9f},
+    {0.12f, 0.9f}};
+
+const float kFx = 900.0f;
+const float kCx = 960.0f;
+const float kCy = 540.0f;
+const int kBodyJoints = std::min(kNumJoints, 17);
+
+struct Walker {
+  float x, z, vx, vz;
+};
+
+// A person standing at (x, z), hips 0.2 m below the camera axis; noise in
+// pixels and meters is drawn from noise() when given
+template <typename Noise>
+int addPerson(SkeletonBatch &batch, float x, float z, float score,
+              Noise noise) {
+  float u[17];
+  float v[17];
+  float box[4] = {1e9f, 1e9f, -1e9f, -1e9f};
+  for (int j = 0; j < kBodyJoints; j++) {
+    u[j] = kCx + kFx * (x + kBody[j][0]) / z + 2.0f * noise();
+    v[j] = kCy + kFx * (0.2f + kBody[j][1]) / z + 2.0f * noise();
+    box[0] = std::min(box[0], u[j]);
+    box[1] = std::min(box[1], v[j]);
+    box[2] = std::max(box[2], u[j]);
+    box[3] = std::max(box[3], v[j]);
+  }
+  const float bbox[4] = {box[0], box[1], box[2] - box[0], box[3] - box[1]};
+  const int p = batch.addPerson(score, bbox);
+  for (int j = 0; j < kBodyJoints && p >= 0; j++) {
+    batch.setKeypoint2D(p, j, u[j], v[j], score);
+    batch.setKeypoint3D(p, j, x + kBody[j][0] + 0.01f * noise(),
+                        0.2f + kBody[j][1] + 0.01f * noise(),
+                        z + 0.01f * noise());
+  }
+  return p;
+}
+
+float noNoise() { return 0.0f; }
+
+void checkCrowd() {
+  const int people = 20;
+  const int frames = 1500;
+  const float missRate = 0.05f;
+  const float falsePositiveRate = 0.05f;
+  const float speed = 0.03f; // Meters per frame
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  auto noise = [&] { return normal(rng); };
+
+  std::vector<Walker> walkers(people);
+  for (Walker &w : walkers) {
+    w.x = -3.0f + 6.0f * uniform(rng);
+    w.z = 2.5f + 4.0f * uniform(rng);
+    w.vx = speed * (uniform(rng) - 0.5f) * 2.0f;
+    w.vz = speed * (uniform(rng) - 0.5f);
+  }
+
+  PoseTracker tracker;
+  std::map<int, int> idOf; // Walker -> last track ID seen
+  long switches = 0;
+  long published = 0;
+  long truth = 0;
+  long falsePositives = 0;
+  long duplicates = 0;
+  double totalNs = 0.0;
+  double maxNs = 0.0;
+  SkeletonBatch batch;
+  SkeletonBatch input;
+  std::vector<int> order(people);
+  std::vector<int> walkerOf; // Per person in the input, -1: false positive
+  for (int f = 0; f < frames; f++) {
+    batch.clear();
+    walkerOf.clear();
+    for (int i = 0; i < people; i++) {
+      order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    for (int i : order) {
+      Walker &w = walkers[i];
+      w.x += w.vx;
+      w.z += w.vz;
+      w.vx = (w.x < -3.0f || w.x > 3.0f) ? -w.vx : w.vx;
+      w.vz = (w.z < 2.0f || w.z > 7.0f) ? -w.vz : w.vz;
+      truth++;
+      if (uniform(rng) < missRate) {
+        continue;
+      }
+      addPerson(batch, w.x, w.z, 0.9f, noise);
+      walkerOf.push_back(i);
+    }
+    if (uniform(rng) < falsePositiveRate) {
+      addPerson(batch, 6.0f * uniform(rng) - 3.0f, 2.0f + 5.0f * uniform(rng),
+                0.5f, noise);
+      walkerOf.push_back(-1);
+    }
+
+    input = batch;
+    const auto start = std::chrono::steady_clock::now();
+    tracker.update(batch);
+    const double ns = std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    totalNs += ns;
+    maxNs = std::max(maxNs, ns);
+
+    // The tracker removes people but keeps the order of the rest
+    std::map<int, int> seen;
+    int k = 0;
+    for (int q = 0; q < input.size() && k < batch.size(); q++) {
+      if (input.bbox[q][0] != batch.bbox[k][0] ||
+          input.bbox[q][1] != batch.bbox[k][1]) {
+        continue;
+      }
+      const int id = batch.trackId[k++];
+      published++;
+      duplicates += seen[id]++ > 0 ? 1 : 0;
+      if (walkerOf[q] < 0) {
+        falsePositives++;
+        continue;
+      }
+      auto it = idOf.find(walkerOf[q]);
+      if (it == idOf.end()) {
+        idOf[walkerOf[q]] = id;
+      } else if (it->second != id) {
+        switches++;
+        it->second = id;
+      }
+    }
+  }
+
+  std::cout << people << " people, " << frames << " frames: " << published
+            << "/" << truth << " person-frames published, " << switches
+            << " ID switches, " << tracker.stats().births << " IDs given, "
+            << falsePositives << " false positives published" << std::endl;
+  std::cout << "update(): mean " << totalNs / frames / 1000.0 << " us, max "
+            << maxNs / 1000.0 << " us" << std::endl;
+  CHECK(tracker.stats().births == static_cast<size_t>(people));
+  CHECK(falsePositives == 0);
+  CHECK(duplicates == 0);
+  CHECK(published >= truth * 9 / 10);
+  CHECK(switches < truth / 500);
+}
+
+void checkFullTable() {
+  const int group = kMaxPeople;
+  PoseTracker tracker;
+  SkeletonBatch batch;
+
+  // Group A, one meter apart, confirmed over three frames
+  auto frameA = [&](int from) {
+    batch.clear();
+    for (int p = from; p < group; p++) {
+      addPerson(batch, -15.0f + p, 3.0f, 0.9f, noNoise);
+    }
+  };
+  for (int f = 0; f < 3; f++) {
+    frameA(0);
+    tracker.update(batch);
+  }
+  CHECK(batch.size() == group);
+  const int returningId = batch.trackId[0]; // A[0], first in the batch
+
+  // A[0] leaves two frames before the rest of A
+  for (int f = 0; f < 2; f++) {
+    frameA(1);
+    tracker.update(batch);
+  }
+
+  // Group B, far behind A, fills the other half of the table
+  for (int f = 0; f < 3; f++) {
+    batch.clear();
+    for (int p = 0; p < group; p++) {
+      addPerson(batch, -15.0f + p, 9.0f, 0.9f, noNoise);
+    }
+    tracker.update(batch);
+  }
+  CHECK(tracker.activeTracks() == PoseTracker::kMaxTracks);
+
+  // A stranger, then A[0] back where it left: A[0] has coasted longest, and
+  // must keep its track rather than lose it to the stranger
+  batch.clear();
+  addPerson(batch, 40.0f, 20.0f, 0.9f, noNoise);
+  addPerson(batch, -15.0f, 3.0f, 0.9f, noNoise);
+  tracker.update(batch);
+  CHECK(batch.size() == 1);
+  CHECK(batch.size() == 1 && batch.trackId[0] == returningId);
+}
+
+} // namespace
+
+int main() {
+  checkCrowd();
+  checkFullTable();
+  return test::report("PoseTrackerTest");
+}
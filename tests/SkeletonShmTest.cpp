@@ -0,0 +1,307 @@
+// SkeletonShmWriter / SkeletonShmReader: records, seqlock and attach checks
+//
+// Publishes frames and reads them back field by field, empty frames
+// included. Checks that the seqlock rejects a slot held odd by the writer
+// and a slot rewritten during visitLatest(), that attach() refuses missing,
+// unfinished, truncated or foreign rings, and that a writer restarting on a
+// ring whose slot was left odd by a crash steps it to the next even value
+// and keeps the attached readers working. Then a writer thread publishes
+// into a two-slot ring under a reader thread, and no accepted record may be
+// torn.
+
+#include "SkeletonShm.h"
+#include "SkeletonShmWriter.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const char *const kRingName = "rbp_shm_test";
+
+// Every coordinate of person p in frame f encodes (f, p), so a torn record
+// (halves of two frames) shows up as a mismatch
+void fillBatch(int people, int frame, SkeletonBatch &batch) {
+  batch.clear();
+  for (int p = 0; p < people; p++) {
+    const float box[4] = {10.0f * p, 20.0f, 30.0f, 40.0f + frame};
+    const int person = batch.addPerson(0.9f, box);
+    batch.trackId[person] = p == 1 ? -1 : 100 + p;
+    for (int j = 0; j < kNumJoints; j++) {
+      if (j == 2) {
+        continue; // Left unprojected
+      }
+      batch.setKeypoint3D(person, j, static_cast<float>(frame),
+                          static_cast<float>(p), 0.5f + 0.01f * j);
+      batch.conf[j][person] = 0.8f;
+    }
+  }
+}
+
+bool isConsistent(const SkeletonShmFrame &frame) {
+  for (uint32_t p = 0; p < frame.personCount; p++) {
+    const SkeletonShmPerson &person = frame.people[p];
+    for (int j = 0; j < kNumJoints; j++) {
+      if (j != 2 && (person.joints[j].x != static_cast<float>(frame.index) ||
+                     person.joints[j].y != static_cast<float>(p))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+SkeletonShmWriter::Config writerConfig(uint32_t slotCount) {
+  SkeletonShmWriter::Config config;
+  config.name = kRingName;
+  config.slotCount = slotCount;
+  return config;
+}
+
+SkeletonShmSlot *slotsOf(SharedMemoryRegion &region) {
+  return reinterpret_cast<SkeletonShmSlot *>(
+      static_cast<char *>(region.data()) + sizeof(SkeletonShmHeader));
+}
+
+void checkRoundTrip() {
+  SharedMemoryRegion::remove(kRingName);
+  SkeletonShmReader reader(kRingName);
+  CHECK(!reader.attach()); // No writer yet
+
+  SkeletonShmWriter writer(writerConfig(4));
+  CHECK(writer.initialize());
+  CHECK(reader.attach());
+  std::unique_ptr<SkeletonShmFrame> frame(new SkeletonShmFrame);
+  CHECK(!reader.readLatest(*frame)); // Nothing published
+
+  SkeletonBatch batch;
+  FrameInfo info;
+  for (int f = 0; f < 6; f++) {
+    fillBatch(3, f, batch);
+    info.frameNumber = 1000 + f;
+    info.captureNs = 5000 + f;
+    writer.publish(batch, &info);
+  }
+  CHECK(reader.published() == 6);
+  CHECK(reader.readLatest(*frame));
+  CHECK(frame->index == 5);
+  CHECK(frame->frameNumber == 1005);
+  CHECK(frame->captureNs == 5005);
+  CHECK(frame->publishNs >= frame->captureNs);
+  CHECK(frame->personCount == 3);
+  CHECK(frame->people[0].id == 100);
+  CHECK(frame->people[1].id == 1); // Untracked: index in the frame
+  CHECK(frame->people[2].id == 102);
+  CHECK(frame->people[2].bbox[3] == 45.0f);
+  CHECK(frame->people[2].hasJoint(0));
+  CHECK(!frame->people[2].hasJoint(2));
+  CHECK(frame->people[2].joints[2].confidence == 0.0f);
+  CHECK(frame->people[2].joints[1].confidence == 0.8f);
+  CHECK(isConsistent(*frame));
+
+  uint32_t visited = 0;
+  CHECK(reader.visitLatest(
+      [&](const SkeletonShmFrame &slot) { visited = slot.personCount; }));
+  CHECK(visited == 3);
+
+  // People leaving: the empty frame is published too
+  batch.clear();
+  writer.publish(batch, nullptr);
+  CHECK(reader.readLatest(*frame));
+  CHECK(frame->index == 6);
+  CHECK(frame->personCount == 0);
+  CHECK(reader.waitForFrame(6, 0));
+  CHECK(!reader.waitForFrame(7, 1));
+}
+
+void checkSeqlock() {
+  SkeletonShmWriter writer(writerConfig(2));
+  CHECK(writer.initialize());
+  SkeletonShmReader reader(kRingName);
+  CHECK(reader.attach());
+  SharedMemoryRegion region;
+  CHECK(region.open(kRingName, true));
+  SkeletonShmSlot *slots = slotsOf(region);
+
+  SkeletonBatch batch;
+  fillBatch(2, 0, batch);
+  writer.publish(batch, nullptr);
+  const uint64_t newest = (reader.published() - 1) % 2;
+
+  // A writer in the slot: the reader must not accept it
+  std::unique_ptr<SkeletonShmFrame> frame(new SkeletonShmFrame);
+  const uint32_t sequence = slots[newest].sequence.load();
+  CHECK((sequence & 1u) == 0);
+  slots[newest].sequence.store(sequence + 1);
+  CHECK(!reader.readLatest(*frame));
+  CHECK(!reader.visitLatest([](const SkeletonShmFrame &) {}));
+  slots[newest].sequence.store(sequence);
+  CHECK(reader.readLatest(*frame));
+
+  // The slot rewritten while a visitor is in it (the ring wraps twice)
+  bool visited = false;
+  CHECK(!reader.visitLatest([&](const SkeletonShmFrame &) {
+    visited = true;
+    writer.publish(batch, nullptr);
+    writer.publish(batch, nullptr);
+  }));
+  CHECK(visited);
+  CHECK(reader.readLatest(*frame));
+}
+
+// Writes a ring header by hand; the layout is valid until a field is broken
+void writeHeader(SharedMemoryRegion &region, uint32_t slotCount) {
+  SkeletonShmHeader *header = static_cast<SkeletonShmHeader *>(region.data());
+  header->version = kSkeletonShmVersion;
+  header->jointCount = static_cast<uint16_t>(kNumJoints);
+  header->maxPeople = kSkeletonShmMaxPeople;
+  header->slotCount = slotCount;
+  header->slotBytes = sizeof(SkeletonShmSlot);
+  header->magic.store(kSkeletonShmMagic);
+}
+
+void checkAttach() {
+  SkeletonShmReader reader(kRingName);
+  SharedMemoryRegion region;
+
+  SharedMemoryRegion::remove(kRingName);
+  CHECK(!reader.attach());
+
+  // Created but not yet initialized (magic still 0)
+  CHECK(region.create(kRingName, skeletonShmBytes(2)));
+  CHECK(!reader.attach());
+  writeHeader(region, 2);
+  CHECK(reader.attach());
+  reader.detach();
+
+  SkeletonShmHeader *header = static_cast<SkeletonShmHeader *>(region.data());
+  header->version = kSkeletonShmVersion + 1;
+  CHECK(!reader.attach());
+  writeHeader(region, 2);
+  header->jointCount = static_cast<uint16_t>(kNumJoints + 1);
+  CHECK(!reader.attach());
+  writeHeader(region, 2);
+  header->maxPeople = kSkeletonShmMaxPeople / 2;
+  CHECK(!reader.attach());
+  writeHeader(region, 2);
+  header->slotBytes = sizeof(SkeletonShmSlot) + 64;
+  CHECK(!reader.attach());
+  writeHeader(region, 0);
+  CHECK(!reader.attach());
+
+  // More slots than the object holds
+  writeHeader(region, 3);
+  CHECK(!reader.attach());
+  region.close();
+
+  // Too small for even the header
+  SharedMemoryRegion::remove(kRingName);
+  CHECK(region.create(kRingName, sizeof(SkeletonShmHeader) / 2));
+  CHECK(!reader.attach());
+  region.close();
+  SharedMemoryRegion::remove(kRingName);
+
+  // The writer replaces an incompatible ring instead of reusing it
+  CHECK(region.create(kRingName, skeletonShmBytes(2)));
+  writeHeader(region, 2);
+  header = static_cast<SkeletonShmHeader *>(region.data());
+  header->jointCount = static_cast<uint16_t>(kNumJoints + 1);
+  region.close();
+  SkeletonShmWriter writer(writerConfig(2));
+  CHECK(writer.initialize());
+  CHECK(reader.attach());
+}
+
+void checkRestart() {
+  SharedMemoryRegion::remove(kRingName);
+  std::unique_ptr<SkeletonShmWriter> writer(
+      new SkeletonShmWriter(writerConfig(4)));
+  CHECK(writer->initialize());
+  SkeletonShmReader reader(kRingName);
+  CHECK(reader.attach());
+
+  SkeletonBatch batch;
+  for (int f = 0; f < 3; f++) {
+    fillBatch(1, f, batch);
+    writer->publish(batch, nullptr);
+  }
+
+  // The writer dies in the middle of the fourth publish: its slot stays odd
+  SharedMemoryRegion region;
+  CHECK(region.open(kRingName, true));
+  SkeletonShmSlot *slots = slotsOf(region);
+  const uint32_t torn = slots[3].sequence.load();
+  slots[3].sequence.store(torn + 1);
+  writer.reset();
+
+  // A new writer reuses the ring: the slot is even again, past the torn
+  // value, and the reader attached before the restart keeps reading
+  writer.reset(new SkeletonShmWriter(writerConfig(4)));
+  CHECK(writer->initialize());
+  CHECK(slots[3].sequence.load() == torn + 2);
+  CHECK(reader.published() == 3);
+  std::unique_ptr<SkeletonShmFrame> frame(new SkeletonShmFrame);
+  for (int f = 3; f < 8; f++) {
+    fillBatch(1, f, batch);
+    writer->publish(batch, nullptr);
+    CHECK(reader.readLatest(*frame));
+    CHECK(frame->index == static_cast<uint64_t>(f));
+    CHECK(isConsistent(*frame));
+  }
+  for (int i = 0; i < 4; i++) {
+    CHECK((slots[i].sequence.load() & 1u) == 0);
+  }
+}
+
+void checkConcurrent() {
+  SharedMemoryRegion::remove(kRingName);
+  SkeletonShmWriter writer(writerConfig(2));
+  CHECK(writer.initialize());
+
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> accepted(0);
+  std::atomic<size_t> torn(0);
+  std::thread thread([&] {
+    SkeletonShmReader reader(kRingName);
+    if (!reader.attach()) {
+      return;
+    }
+    std::unique_ptr<SkeletonShmFrame> frame(new SkeletonShmFrame);
+    while (!stop) {
+      if (reader.readLatest(*frame)) {
+        accepted++;
+        torn += isConsistent(*frame) ? 0 : 1;
+      }
+    }
+  });
+
+  SkeletonBatch batch;
+  for (int f = 0; f < 20000; f++) {
+    fillBatch(kMaxPeople, f, batch);
+    writer.publish(batch, nullptr);
+  }
+  stop = true;
+  thread.join();
+
+  std::cout << "Concurrent: " << accepted << " reads accepted, " << torn
+            << " torn" << std::endl;
+  CHECK(accepted > 0);
+  CHECK(torn == 0);
+}
+
+} // namespace
+
+int main() {
+  checkRoundTrip();
+  checkSeqlock();
+  checkAttach();
+  checkRestart();
+  checkConcurrent();
+  SharedMemoryRegion::remove(kRingName);
+  return test::report("SkeletonShmTest");
+}
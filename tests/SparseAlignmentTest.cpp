@@ -0,0 +1,230 @@
+// Sparse keypoint-only alignment against full-frame rs2::align
+//
+// Renders a smooth synthetic scene into a raw depth frame, pushes it with a
+// color frame through an rs2::software_device (no camera needed), and
+// projects a grid of keypoints twice: through rs2::align + the aligned
+// depth, and through sparse alignment on the raw depth. Both must give the
+// same 3D points; the time per frame of each path is printed.
+
+#include "SkeletonBatch.h"
+#include "SkeletonProjector.h"
+#include "TestCheck.h"
+#include <librealsense2/rs.hpp>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kWidth = 640;
+const int kHeight = 480;
+const float kDepthUnits = 0.001f;
+const float kBaselineM = 0.015f; // Depth to color, along x
+
+// Both paths project the same keypoint; they may differ by the window
+// median over slightly different pixels on a sloped surface
+const float kMaxRelativeError = 0.02f;
+
+rs2_intrinsics makeIntrinsics(float fx, float ppx, float ppy,
+                              rs2_distortion model) {
+  rs2_intrinsics intrinsics = {};
+  intrinsics.width = kWidth;
+  intrinsics.height = kHeight;
+  intrinsics.fx = intrinsics.fy = fx;
+  intrinsics.ppx = ppx;
+  intrinsics.ppy = ppy;
+  intrinsics.model = model;
+  return intrinsics;
+}
+
+rs2_extrinsics translation(float x) {
+  rs2_extrinsics extrinsics = {{1, 0, 0, 0, 1, 0, 0, 0, 1}, {x, 0, 0}};
+  return extrinsics;
+}
+
+// Tilted plane z = 2.5 + 0.3 x - 0.2 y (meters, depth camera frame), so the
+// depth varies everywhere but has no edges where the two paths may disagree
+void renderDepth(const rs2_intrinsics &intrinsics,
+                 std::vector<uint16_t> &depth) {
+  depth.resize(kWidth * kHeight);
+  for (int v = 0; v < kHeight; v++) {
+    for (int u = 0; u < kWidth; u++) {
+      const float rx = (u - intrinsics.ppx) / intrinsics.fx;
+      const float ry = (v - intrinsics.ppy) / intrinsics.fy;
+      const float z = 2.5f / (1.0f - 0.3f * rx + 0.2f * ry);
+      depth[v * kWidth + u] = static_cast<uint16_t>(z / kDepthUnits + 0.5f);
+    }
+  }
+}
+
+// A grid of keypoints over the color image, 17 joints per "person"
+void fillKeypoints(SkeletonBatch &batch) {
+  batch.clear();
+  const float box[4] = {0, 0, 100, 200};
+  int person = -1;
+  int joint = kNumJoints;
+  for (int y = 30; y < kHeight - 30; y += 24) {
+    for (int x = 30; x < kWidth - 30; x += 24) {
+      if (joint == kNumJoints) {
+        person = batch.addPerson(0.9f, box);
+        joint = 0;
+        if (person < 0) {
+          return;
+        }
+      }
+      batch.setKeypoint2D(person, joint++, static_cast<float>(x),
+                          static_cast<float>(y), 0.9f);
+    }
+  }
+}
+
+void keepBuffer(void *) {}
+
+} // namespace
+
+int main() {
+  const rs2_intrinsics depthIntrinsics =
+      makeIntrinsics(385.0f, 320.5f, 239.5f, RS2_DISTORTION_BROWN_CONRADY);
+  const rs2_intrinsics colorIntrinsics =
+      makeIntrinsics(615.0f, 322.0f, 238.0f, RS2_DISTORTION_NONE);
+  const rs2_extrinsics depthToColor = translation(kBaselineM);
+  const rs2_extrinsics colorToDepth = translation(-kBaselineM);
+
+  // Software device with a depth and a color sensor, matched into framesets
+  rs2::software_device device;
+  rs2::software_sensor depthSensor = device.add_sensor("Depth");
+  rs2::software_sensor colorSensor = device.add_sensor("Color");
+  depthSensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, kDepthUnits);
+
+  rs2_video_stream depthStream = {RS2_STREAM_DEPTH, 0, 0, kWidth, kHeight,
+                                  30, 2, RS2_FORMAT_Z16, depthIntrinsics};
+  rs2_video_stream colorStream = {RS2_STREAM_COLOR, 0, 1, kWidth, kHeight,
+                                  30, 3, RS2_FORMAT_BGR8, colorIntrinsics};
+  rs2::stream_profile depthProfile = depthSensor.add_video_stream(depthStream);
+  rs2::stream_profile colorProfile = colorSensor.add_video_stream(colorStream);
+  depthProfile.register_extrinsics_to(colorProfile, depthToColor);
+  colorProfile.register_extrinsics_to(depthProfile, colorToDepth);
+  device.create_matcher(RS2_MATCHER_DLR_C);
+
+  rs2::syncer sync;
+  depthSensor.open(depthProfile);
+  colorSensor.open(colorProfile);
+  depthSensor.start(sync);
+  colorSensor.start(sync);
+
+  std::vector<uint16_t> depthPixels;
+  renderDepth(depthIntrinsics, depthPixels);
+  std::vector<uint8_t> colorPixels(kWidth * kHeight * 3, 128);
+
+  rs2::frameset frames;
+  for (int i = 0; i < 10 && frames.size() < 2; i++) {
+    rs2_software_video_frame depthFrame = {};
+    depthFrame.pixels = depthPixels.data();
+    depthFrame.deleter = keepBuffer;
+    depthFrame.stride = kWidth * 2;
+    depthFrame.bpp = 2;
+    depthFrame.timestamp = i * 33.3;
+    depthFrame.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+    depthFrame.frame_number = i;
+    depthFrame.profile = depthProfile.get();
+    depthFrame.depth_units = kDepthUnits;
+    depthSensor.on_video_frame(depthFrame);
+
+    rs2_software_video_frame colorFrame = depthFrame;
+    colorFrame.pixels = colorPixels.data();
+    colorFrame.stride = kWidth * 3;
+    colorFrame.bpp = 3;
+    colorFrame.profile = colorProfile.get();
+    colorSensor.on_video_frame(colorFrame);
+
+    frames = sync.wait_for_frames(1000);
+  }
+  CHECK(frames.size() == 2);
+  if (frames.size() != 2) {
+    return test::report("SparseAlignmentTest");
+  }
+
+  rs2::align aligner(RS2_STREAM_COLOR);
+  const rs2::frameset aligned = aligner.process(frames);
+  const rs2::depth_frame alignedDepth = aligned.get_depth_frame();
+  const cv::Mat alignedMat(kHeight, kWidth, CV_16UC1,
+                           const_cast<void *>(alignedDepth.get_data()),
+                           alignedDepth.get_stride_in_bytes());
+  const cv::Mat rawMat(kHeight, kWidth, CV_16UC1, depthPixels.data());
+
+  SkeletonProjector full(colorIntrinsics, kDepthUnits);
+  SkeletonProjector sparse(colorIntrinsics, kDepthUnits);
+  sparse.enableSparseAlignment(depthIntrinsics, colorToDepth, depthToColor);
+
+  SkeletonBatch viaAlign;
+  SkeletonBatch viaSparse;
+  fillKeypoints(viaAlign);
+  fillKeypoints(viaSparse);
+  full.project(viaAlign, alignedMat);
+  sparse.project(viaSparse, rawMat);
+
+  int total = 0;
+  int both = 0;
+  float worst = 0.0f;
+  for (int p = 0; p < viaAlign.size(); p++) {
+    for (int j = 0; j < kNumJoints; j++) {
+      if (!viaAlign.valid2D[p].test(j)) {
+        continue;
+      }
+      total++;
+      if (!viaAlign.valid3D[p].test(j) || !viaSparse.valid3D[p].test(j)) {
+        continue;
+      }
+      both++;
+      const Keypoint3D a = viaAlign[p].keypoint3D(j);
+      const Keypoint3D b = viaSparse[p].keypoint3D(j);
+      const float error = std::sqrt((a.x - b.x) * (a.x - b.x) +
+                                    (a.y - b.y) * (a.y - b.y) +
+                                    (a.z - b.z) * (a.z - b.z));
+      worst = std::max(worst, error / a.z);
+    }
+  }
+  std::cout << both << "/" << total
+            << " keypoints with depth on both paths, worst error "
+            << worst * 100.0f << "% of depth" << std::endl;
+  CHECK(total > 0);
+  CHECK(both >= total * 95 / 100);
+  CHECK(worst <= kMaxRelativeError);
+
+  // Per-frame cost: full-frame alignment + lookup vs sparse mapping
+  const int runs = 50;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++) {
+    const rs2::frameset again = aligner.process(frames);
+    const rs2::depth_frame depth = again.get_depth_frame();
+    const cv::Mat mat(kHeight, kWidth, CV_16UC1,
+                      const_cast<void *>(depth.get_data()),
+                      depth.get_stride_in_bytes());
+    full.project(viaAlign, mat);
+  }
+  const double alignMs = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count() /
+                         runs;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++) {
+    sparse.project(viaSparse, rawMat);
+  }
+  const double sparseMs = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count() /
+                          runs;
+  std::cout << "Per frame (" << total << " keypoints): rs2::align + project "
+            << alignMs << " ms, sparse project " << sparseMs << " ms"
+            << std::endl;
+
+  depthSensor.stop();
+  colorSensor.stop();
+  return test::report("SparseAlignmentTest");
+}
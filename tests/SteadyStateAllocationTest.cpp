@@ -0,0 +1,266 @@
+// No heap allocations per frame once the pipeline has warmed up
+//
+// Runs the synthetic source through the same stages as main(): pose
+// decoding (from a fixed synthetic model output, since inference needs a
+// model), 3D projection, tracking and UDP output in every encoding to
+// loopback, with packets recycled by the caller. Then hands librealsense
+// frames from a software device to packets as zero-copy views, the way
+// RealSenseCamera::captureFrames() does on a live camera. Built with
+// RBP_ALLOC_STATS, so operator new is counted per AllocationZone; after
+// warm-up every zone a stage runs in must stay at zero. DNN inference itself
+// (Net::forward), librealsense's own frame handling and packets evicted by
+// LATEST_ONLY queues are outside this test.
+
+#include "AllocationStats.h"
+#include "FrameMat.h"
+#include "PoseEstimator.h"
+#include "PoseTracker.h"
+#include "SkeletonProjector.h"
+#include "StagePipeline.h"
+#include "SyntheticSource.h"
+#include "TestCheck.h"
+#include "UdpSender.h"
+#include <librealsense2/rs.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kWarmupFrames = 50;
+const int kMeasuredFrames = 200;
+const int kAnchors = 8400;
+
+const AllocZone kStageZones[] = {AllocZone::CAPTURE, AllocZone::ESTIMATE,
+                                 AllocZone::PROJECT, AllocZone::TRACK,
+                                 AllocZone::SEND};
+
+// Three people standing still, as the model would report them (letterboxed
+// input coordinates), over background anchors below the threshold
+cv::Mat makeModelOutput() {
+  const int sizes[3] = {1, kPoseOutputChannels<ActiveTopology>, kAnchors};
+  cv::Mat output(3, sizes, CV_32F, cv::Scalar(0));
+  float *data = output.ptr<float>();
+  const float centers[3][2] = {{180, 300}, {330, 320}, {480, 310}};
+  for (int p = 0; p < 3; p++) {
+    const int a = 1000 + p * 2000;
+    data[0 * kAnchors + a] = centers[p][0];
+    data[1 * kAnchors + a] = centers[p][1];
+    data[2 * kAnchors + a] = 90.0f;
+    data[3 * kAnchors + a] = 260.0f;
+    data[4 * kAnchors + a] = 0.9f;
+    for (int j = 0; j < kNumJoints; j++) {
+      data[(5 + 3 * j) * kAnchors + a] = centers[p][0] + (j % 3 - 1) * 20.0f;
+      data[(6 + 3 * j) * kAnchors + a] = centers[p][1] - 120.0f + j * 14.0f;
+      data[(7 + 3 * j) * kAnchors + a] = 0.8f;
+    }
+  }
+  return output;
+}
+
+void checkAllocations(const char *what, AllocZone zone,
+                      const AllocationCounters &before) {
+  const AllocationCounters now = allocationCounters(zone);
+  const uint64_t allocations = now.allocations - before.allocations;
+  std::cout << what << ", zone " << static_cast<int>(zone) << ": "
+            << allocations << " allocations, " << now.bytes - before.bytes
+            << " bytes after warm-up" << std::endl;
+  CHECK(allocations == 0);
+}
+
+void checkPipeline() {
+  SyntheticSource::Config sourceConfig;
+  sourceConfig.realTime = false;
+  sourceConfig.people = 3;
+  sourceConfig.frameCount = kWarmupFrames + kMeasuredFrames;
+  SyntheticSource source(sourceConfig);
+  source.start();
+
+  PoseEstimator::Config estimatorConfig;
+  PoseEstimator estimator(estimatorConfig);
+  const cv::Mat modelOutput = makeModelOutput();
+
+  SkeletonProjector projector(source.getColorIntrinsics(),
+                              source.getDepthScale());
+  projector.enableAdaptiveRadius();
+  PoseTracker tracker;
+
+  UdpSender::Config senderConfig;
+  senderConfig.asyncSend = false; // Encode and send inside the SEND zone
+  senderConfig.subscribers.push_back(
+      UdpSender::Subscriber("127.0.0.1", 47001, UdpSender::Encoding::JSON));
+  senderConfig.subscribers.push_back(
+      UdpSender::Subscriber("127.0.0.1", 47002, UdpSender::Encoding::BINARY));
+  senderConfig.subscribers.push_back(
+      UdpSender::Subscriber("127.0.0.1", 47003, UdpSender::Encoding::DELTA));
+  UdpSender sender(senderConfig);
+  CHECK(sender.initialize());
+
+  // BLOCK edges of one packet each, so every packet stays in circulation
+  using Edge = StagePipeline::EdgeConfig;
+  StagePipeline pipeline;
+  pipeline.setSource("capture", [&](FramePacket &packet) {
+    AllocationZone zone(AllocZone::CAPTURE);
+    if (source.captureFrames(packet.color, packet.depth, 5000,
+                             &packet.info)) {
+      return StagePipeline::SourceResult::FRAME;
+    }
+    return StagePipeline::SourceResult::END_OF_INPUT;
+  });
+  pipeline.addStage(
+      "estimate",
+      [&](FramePacket &packet) {
+        AllocationZone zone(AllocZone::ESTIMATE);
+        estimator.decode(modelOutput, packet.color.size(), packet.skeletons);
+      },
+      Edge(1, OverflowPolicy::BLOCK));
+  pipeline.addStage(
+      "project",
+      [&](FramePacket &packet) {
+        {
+          AllocationZone zone(AllocZone::PROJECT);
+          projector.project(packet.skeletons, packet.depth);
+        }
+        AllocationZone zone(AllocZone::TRACK);
+        tracker.update(packet.skeletons);
+      },
+      Edge(1, OverflowPolicy::BLOCK));
+  pipeline.addStage(
+      "output",
+      [&](FramePacket &packet) {
+        AllocationZone zone(AllocZone::SEND);
+        sender.send(packet.skeletons, &packet.info);
+      },
+      Edge(1, OverflowPolicy::BLOCK));
+  pipeline.setOutput(Edge(1, OverflowPolicy::BLOCK));
+  pipeline.start();
+
+  // Let every queue fill before taking anything out, so all the packets the
+  // pipeline will ever hold at once are created during warm-up (there are
+  // at most 8 of them, which the recycle pool keeps)
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  AllocationCounters warm[static_cast<int>(AllocZone::COUNT)];
+  int frames = 0;
+  int people = 0;
+  FramePacket packet;
+  while (!pipeline.isDrained()) {
+    if (!pipeline.poll(packet, 100)) {
+      continue;
+    }
+    people = packet.skeletons.size();
+    if (++frames == kWarmupFrames) {
+      for (AllocZone zone : kStageZones) {
+        warm[static_cast<int>(zone)] = allocationCounters(zone);
+      }
+    }
+    pipeline.recycle(packet);
+  }
+  pipeline.join();
+
+  CHECK(!pipeline.hasFailed());
+  CHECK(frames == kWarmupFrames + kMeasuredFrames);
+  CHECK(people == 3); // Tracks confirmed, people published
+  for (AllocZone zone : kStageZones) {
+    checkAllocations("Pipeline", zone, warm[static_cast<int>(zone)]);
+  }
+}
+
+// The pixel buffers outlive every frame, so frames need no deleter
+void keepBuffer(void *) {}
+
+void checkFrameViews() {
+  const int width = 640;
+  const int height = 480;
+  rs2::software_device device;
+  rs2::software_sensor colorSensor = device.add_sensor("Color");
+  rs2::software_sensor depthSensor = device.add_sensor("Depth");
+
+  rs2_intrinsics intrinsics = {};
+  intrinsics.width = width;
+  intrinsics.height = height;
+  intrinsics.ppx = width / 2.0f;
+  intrinsics.ppy = height / 2.0f;
+  intrinsics.fx = intrinsics.fy = 600.0f;
+  intrinsics.model = RS2_DISTORTION_NONE;
+  rs2_video_stream colorStream = {RS2_STREAM_COLOR, 0, 0, width, height,
+                                  30, 3, RS2_FORMAT_BGR8, intrinsics};
+  rs2_video_stream depthStream = {RS2_STREAM_DEPTH, 0, 1, width, height,
+                                  30, 2, RS2_FORMAT_Z16, intrinsics};
+  rs2::stream_profile colorProfile = colorSensor.add_video_stream(colorStream);
+  rs2::stream_profile depthProfile = depthSensor.add_video_stream(depthStream);
+
+  rs2::frame_queue colorQueue(1);
+  rs2::frame_queue depthQueue(1);
+  colorSensor.open(colorProfile);
+  depthSensor.open(depthProfile);
+  colorSensor.start(colorQueue);
+  depthSensor.start(depthQueue);
+
+  std::vector<uint8_t> colorPixels(static_cast<size_t>(width) * height * 3);
+  std::vector<uint16_t> depthPixels(static_cast<size_t>(width) * height);
+
+  // As many packets as the pipeline above keeps in circulation, refilled in
+  // turn, so views are released by being overwritten as in captureFrames()
+  std::vector<FramePacket> packets(8);
+  AllocationCounters warm;
+  int views = 0;
+  for (int i = 0; i < kWarmupFrames + kMeasuredFrames; i++) {
+    rs2_software_video_frame colorFrame = {};
+    colorFrame.pixels = colorPixels.data();
+    colorFrame.deleter = keepBuffer;
+    colorFrame.stride = width * 3;
+    colorFrame.bpp = 3;
+    colorFrame.timestamp = i * 33.3;
+    colorFrame.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+    colorFrame.frame_number = i;
+    colorFrame.profile = colorProfile.get();
+    colorSensor.on_video_frame(colorFrame);
+
+    rs2_software_video_frame depthFrame = colorFrame;
+    depthFrame.pixels = depthPixels.data();
+    depthFrame.stride = width * 2;
+    depthFrame.bpp = 2;
+    depthFrame.profile = depthProfile.get();
+    depthSensor.on_video_frame(depthFrame);
+
+    const rs2::video_frame color = colorQueue.wait_for_frame();
+    const rs2::video_frame depth = depthQueue.wait_for_frame();
+    if (i == kWarmupFrames) {
+      warm = allocationCounters(AllocZone::CAPTURE);
+    }
+
+    FramePacket &packet = packets[i % packets.size()];
+    AllocationZone zone(AllocZone::CAPTURE);
+    CHECK(exportFrame(color, CV_8UC3, true, packet.color) == 0);
+    CHECK(exportFrame(depth, CV_16UC1, true, packet.depth) == 0);
+    views += isFrameView(packet.color) && isFrameView(packet.depth) ? 1 : 0;
+  }
+  CHECK(views == kWarmupFrames + kMeasuredFrames);
+  checkAllocations("Frame views", AllocZone::CAPTURE, warm);
+
+  // Release the frame views before the device goes away
+  packets.clear();
+  colorSensor.stop();
+  depthSensor.stop();
+  colorSensor.close();
+  depthSensor.close();
+}
+
+} // namespace
+
+int main() {
+  if (!kAllocationStatsEnabled) {
+    std::cerr << "Build with RBP_ALLOC_STATS to count allocations"
+              << std::endl;
+    return 1;
+  }
+
+  checkPipeline();
+  checkFrameViews();
+  return test::report("SteadyStateAllocationTest");
+}
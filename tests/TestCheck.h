@@ -0,0 +1,42 @@
+// Minimal checks for the standalone unit tests (no test framework)
+
+#pragma once
+
+#include <iostream>
+
+namespace RealsenseBodyPose {
+namespace test {
+
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+inline void check(bool ok, const char *expression, const char *file,
+                  int line) {
+  if (!ok) {
+    failures()++;
+    std::cerr << file << ":" << line << ": CHECK failed: " << expression
+              << std::endl;
+  }
+}
+
+/**
+ * @brief Print the outcome and return main()'s exit code (0 if all passed)
+ */
+inline int report(const char *name) {
+  if (failures() > 0) {
+    std::cerr << name << ": " << failures() << " check(s) failed"
+              << std::endl;
+    return 1;
+  }
+  std::cout << name << ": passed" << std::endl;
+  return 0;
+}
+
+} // namespace test
+} // namespace RealsenseBodyPose
+
+#define CHECK(expression)                                                      \
+  ::RealsenseBodyPose::test::check((expression), #expression, __FILE__,        \
+                                   __LINE__)
@@ -0,0 +1,312 @@
+// Delta stream report: replays recorded CSV sessions through the UDP encoders
+//
+// Usage: RealsenseBodyPoseDeltaReport [options] recording.csv [...]
+//
+// For each DataRecorder CSV, encodes every frame as the JSON packet, the
+// binary packet and the delta stream (all joints and key joints), and prints
+// the bytes sent, the compression against the binary packet, the encode cost
+// per frame and, for the delta stream, the error of what a receiver holds.
+
+#include "DeltaWireFormat.h"
+#include "JsonEncoder.h"
+#include "SkeletonBatch.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// Nose, shoulders, elbows, wrists, as UdpSender's key joints
+const int kKeyJointIds[] = {0, 5, 6, 7, 8, 9, 10};
+
+// Encoding runs per stream; the fastest is reported
+const int kTimingRuns = 5;
+
+struct Frame {
+  SkeletonBatch batch;
+  FrameInfo info;
+  int64_t nowNs;
+};
+
+struct StreamResult {
+  std::string name;
+  size_t packets = 0;
+  size_t bytes = 0;
+  double nsPerFrame = 0.0;
+  DeltaWireEncoder::Stats delta;
+  double meanErrorMm = 0.0;
+  double maxErrorMm = 0.0;
+  size_t missing = 0; // Person-frames the receiver did not hold
+};
+
+std::vector<std::string> splitCsv(const std::string &line) {
+  std::vector<std::string> fields;
+  std::stringstream ss(line);
+  std::string field;
+  while (std::getline(ss, field, ',')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+/**
+ * @brief Load a DataRecorder CSV, one SkeletonBatch per FrameIndex
+ */
+bool loadRecording(const std::string &path, std::vector<Frame> &frames) {
+  std::ifstream file(path);
+  std::string line;
+  if (!file || !std::getline(file, line)) {
+    std::cerr << "Cannot read " << path << std::endl;
+    return false;
+  }
+  const std::vector<std::string> header = splitCsv(line);
+  const size_t firstJoint =
+      std::find(header.begin(), header.end(), "J0_X") - header.begin();
+  if (firstJoint + kNumJoints * 4 != header.size()) {
+    std::cerr << path << ": expected " << kNumJoints
+              << " joints per row (RBP_SKELETON_TOPOLOGY)" << std::endl;
+    return false;
+  }
+
+  std::string lastIndex;
+  double firstTimestampMs = -1.0;
+  while (std::getline(file, line)) {
+    const std::vector<std::string> f = splitCsv(line);
+    if (f.size() != header.size()) {
+      continue;
+    }
+    if (frames.empty() || f[1] != lastIndex) {
+      frames.emplace_back();
+      Frame &frame = frames.back();
+      frame.info.frameNumber = f[2].empty() ? frames.size() : std::stoull(f[2]);
+      frame.info.sensorTimestampMs = f[3].empty() ? 0.0 : std::stod(f[3]);
+
+      // Device clock for the heartbeat; wall clock when it was not recorded
+      const double ms = f[3].empty() ? std::stod(f[0]) : std::stod(f[3]);
+      firstTimestampMs = firstTimestampMs < 0.0 ? ms : firstTimestampMs;
+      frame.nowNs = static_cast<int64_t>((ms - firstTimestampMs) * 1e6);
+      lastIndex = f[1];
+    }
+
+    SkeletonBatch &batch = frames.back().batch;
+    const float bbox[4] = {0, 0, 0, 0};
+    const int p = batch.addPerson(std::stof(f[firstJoint - 1]), bbox);
+    if (p < 0) {
+      continue;
+    }
+    batch.trackId[p] = std::stoi(f[firstJoint - 2]);
+    for (int j = 0; j < kNumJoints; j++) {
+      const size_t c = firstJoint + j * 4;
+      const Keypoint3D k3d(std::stof(f[c]), std::stof(f[c + 1]),
+                           std::stof(f[c + 2]), std::stof(f[c + 3]));
+      batch.conf[j][p] = k3d.confidence;
+      if (k3d.isValid()) {
+        batch.setKeypoint3D(p, j, k3d.x, k3d.y, k3d.z);
+      }
+    }
+  }
+  return true;
+}
+
+// Encode the whole session kTimingRuns times; encode(frame, index) returns
+// the packet size, 0 when nothing is sent
+template <typename Encode>
+StreamResult timeStream(const std::string &name,
+                        const std::vector<Frame> &frames, Encode encode) {
+  StreamResult result;
+  result.name = name;
+  double best = 1e30;
+  for (int run = 0; run < kTimingRuns; run++) {
+    size_t packets = 0, bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames.size(); i++) {
+      const size_t size = encode(frames[i], static_cast<uint32_t>(i));
+      packets += size > 0 ? 1 : 0;
+      bytes += size;
+    }
+    const double ns = std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+    best = std::min(best, ns / std::max<size_t>(frames.size(), 1));
+    result.packets = packets;
+    result.bytes = bytes;
+  }
+  result.nsPerFrame = best;
+  return result;
+}
+
+StreamResult runDelta(const std::string &name,
+                      const std::vector<Frame> &frames,
+                      const DeltaWireEncoder::Config &config,
+                      const JointMask<kNumJoints> *joints) {
+  std::vector<uint8_t> packet(kDeltaMaxPacketBytes);
+
+  // Cost, with fresh stream state every run
+  std::unique_ptr<DeltaWireEncoder> timed;
+  StreamResult result = timeStream(
+      name, frames, [&](const Frame &frame, uint32_t sequence) {
+        if (sequence == 0) {
+          timed.reset(new DeltaWireEncoder(config));
+        }
+        return timed->encode(frame.batch, sequence, &frame.info, frame.nowNs,
+                             packet.data(), packet.size(), joints);
+      });
+
+  // Fidelity: what a receiver holds after every frame against the input
+  DeltaWireEncoder encoder(config);
+  DeltaWireDecoder decoder;
+  WirePacket held;
+  double errorSum = 0.0;
+  size_t errorCount = 0;
+  for (size_t i = 0; i < frames.size(); i++) {
+    const Frame &frame = frames[i];
+    const size_t size =
+        encoder.encode(frame.batch, static_cast<uint32_t>(i), &frame.info,
+                       frame.nowNs, packet.data(), packet.size(), joints);
+    if (size > 0) {
+      decoder.decode(packet.data(), size, held);
+    }
+
+    for (int p = 0; p < frame.batch.size(); p++) {
+      const SkeletonView skel = frame.batch[p];
+      const WirePerson *person = nullptr;
+      for (const WirePerson &candidate : held.people) {
+        person = candidate.id == skel.publicId() ? &candidate : person;
+      }
+      if (!person) {
+        result.missing++;
+        continue;
+      }
+      for (const WireJoint &joint : person->joints) {
+        const Keypoint3D k3d = skel.keypoint3D(joint.joint);
+        const double error =
+            1000.0 * std::max({std::fabs(joint.x - k3d.x),
+                               std::fabs(joint.y - k3d.y),
+                               std::fabs(joint.z - k3d.z)});
+        errorSum += error;
+        errorCount++;
+        result.maxErrorMm = std::max(result.maxErrorMm, error);
+      }
+    }
+  }
+  result.delta = encoder.stats();
+  result.meanErrorMm = errorCount ? errorSum / errorCount : 0.0;
+  return result;
+}
+
+void printUsage(const char *program) {
+  std::cout << "Usage: " << program << " [options] recording.csv [...]\n\n";
+  std::cout << "Options:\n";
+  std::cout << "  --keyframe-interval <n> Frames between keyframes (default: "
+               "60)\n";
+  std::cout << "  --delta-epsilon <mm>    Joint moves not sent (default: 5)\n";
+  std::cout << "  --quantum <mm>          Delta resolution (default: 2)\n";
+  std::cout << "  --heartbeat-ms <ms>     Longest silence (default: 200)\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  DeltaWireEncoder::Config config;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      printUsage(argv[0]);
+      return 0;
+    } else if (arg == "--keyframe-interval" && i + 1 < argc) {
+      config.keyframeInterval = std::stoi(argv[++i]);
+    } else if (arg == "--delta-epsilon" && i + 1 < argc) {
+      config.epsilonMm = std::stof(argv[++i]);
+    } else if (arg == "--quantum" && i + 1 < argc) {
+      config.quantumMm = std::stoi(argv[++i]);
+    } else if (arg == "--heartbeat-ms" && i + 1 < argc) {
+      config.heartbeatMs = std::stoi(argv[++i]);
+    } else if (!arg.empty() && arg[0] != '-') {
+      paths.push_back(arg);
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (paths.empty()) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  JointMask<kNumJoints> keyJoints;
+  for (int id : kKeyJointIds) {
+    keyJoints.set(id);
+  }
+
+  for (const std::string &path : paths) {
+    std::vector<Frame> frames;
+    if (!loadRecording(path, frames) || frames.empty()) {
+      continue;
+    }
+    size_t personFrames = 0;
+    for (const Frame &frame : frames) {
+      personFrames += frame.batch.size();
+    }
+
+    std::vector<StreamResult> results;
+    JsonSkeletonEncoder json;
+    results.push_back(timeStream(
+        "json (key joints)", frames,
+        [&](const Frame &frame, uint32_t) {
+          return json.encode(frame.batch, &frame.info);
+        }));
+    std::vector<uint8_t> packet(kWireMaxPacketBytes);
+    results.push_back(timeStream(
+        "binary", frames, [&](const Frame &frame, uint32_t sequence) {
+          return encodeWirePacket(frame.batch, sequence, &frame.info,
+                                  packet.data(), packet.size());
+        }));
+    results.push_back(timeStream(
+        "binary (key joints)", frames,
+        [&](const Frame &frame, uint32_t sequence) {
+          return encodeWirePacket(frame.batch, sequence, &frame.info,
+                                  packet.data(), packet.size(), &keyJoints);
+        }));
+    results.push_back(runDelta("delta", frames, config, nullptr));
+    results.push_back(runDelta("delta (key joints)", frames, config,
+                               &keyJoints));
+
+    std::cout << "\n" << path << ": " << frames.size() << " frames, "
+              << personFrames << " person-frames\n";
+    std::cout << std::left << std::setw(22) << "stream" << std::right
+              << std::setw(9) << "packets" << std::setw(12) << "bytes"
+              << std::setw(10) << "B/frame" << std::setw(10) << "vs bin"
+              << std::setw(10) << "ns/frame" << "\n";
+    const double binaryBytes = static_cast<double>(results[1].bytes);
+    for (const StreamResult &r : results) {
+      std::cout << std::left << std::setw(22) << r.name << std::right
+                << std::setw(9) << r.packets << std::setw(12) << r.bytes
+                << std::fixed << std::setprecision(1) << std::setw(10)
+                << static_cast<double>(r.bytes) / frames.size()
+                << std::setw(9) << binaryBytes / std::max<size_t>(r.bytes, 1)
+                << "x" << std::setw(10) << r.nsPerFrame << "\n";
+    }
+    for (size_t i = 3; i < results.size(); i++) {
+      const StreamResult &r = results[i];
+      std::cout << r.name << ": " << r.delta.keyframes << " keyframes, "
+                << r.delta.updates << " updates, " << r.delta.suppressed
+                << " frames suppressed, " << r.delta.heartbeats
+                << " heartbeats; receiver error mean " << std::setprecision(2)
+                << r.meanErrorMm << " mm, max " << r.maxErrorMm << " mm, "
+                << r.missing << " person-frames missing\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Depth sampling benchmark: batched median kernel vs vector + sort
+//
+// Usage: RealsenseBodyPoseDepthSamplerBenchmark [iterations]
+//
+// Samples every keypoint of 1, 10 and 32 people on a 1280x720 depth frame
+// (10% invalid pixels) at radius 2 (5x5, the default) and 5 (11x11), the
+// way SkeletonProjector::project() does.
+
+#include "DepthSampler.h"
+#include "SkeletonBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// The original per-keypoint SkeletonProjector::sampleDepth()
+uint16_t sortedMedian(const cv::Mat &depthImage, int x, int y, int radius) {
+  if (x < 0 || x >= depthImage.cols || y < 0 || y >= depthImage.rows) {
+    return 0;
+  }
+  std::vector<uint16_t> values;
+  for (int dy = -radius; dy <= radius; dy++) {
+    for (int dx = -radius; dx <= radius; dx++) {
+      const int sx = x + dx;
+      const int sy = y + dy;
+      if (sx >= 0 && sx < depthImage.cols && sy >= 0 &&
+          sy < depthImage.rows) {
+        const uint16_t depth = depthImage.at<uint16_t>(sy, sx);
+        if (depth > 0) {
+          values.push_back(depth);
+        }
+      }
+    }
+  }
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+template <typename Fn> double usPerRun(int iterations, Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int iterations = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 2000;
+  const int width = 1280;
+  const int height = 720;
+
+  std::mt19937 rng(5);
+  std::vector<uint16_t> pixels(static_cast<size_t>(width) * height);
+  for (uint16_t &pixel : pixels) {
+    pixel = rng() % 10 == 0 ? 0 : static_cast<uint16_t>(800 + rng() % 3000);
+  }
+  const cv::Mat depth(height, width, CV_16UC1, pixels.data());
+
+  std::cout << std::left << std::setw(8) << "people" << std::setw(8)
+            << "radius" << std::right << std::setw(12) << "sort us"
+            << std::setw(12) << "kernel us" << std::setw(10) << "speedup"
+            << "  result\n";
+  int exitCode = 0;
+  for (int people : {1, 10, kMaxPeople}) {
+    for (int radius : {2, 5}) {
+      std::vector<DepthQuery> queries(people * kNumJoints);
+      for (DepthQuery &query : queries) {
+        query = {static_cast<int>(rng() % width),
+                 static_cast<int>(rng() % height), radius};
+      }
+      std::vector<uint16_t> sorted(queries.size());
+      std::vector<uint16_t> batched(queries.size());
+
+      const double sortUs = usPerRun(iterations, [&]() {
+        for (size_t i = 0; i < queries.size(); i++) {
+          sorted[i] = sortedMedian(depth, queries[i].x, queries[i].y,
+                                   queries[i].radius);
+        }
+      });
+      const double kernelUs = usPerRun(iterations, [&]() {
+        sampleMedianDepths(depth, queries.data(), queries.size(),
+                           batched.data());
+      });
+      const bool same = sorted == batched;
+      exitCode |= same ? 0 : 1;
+
+      std::cout << std::left << std::setw(8) << people << std::setw(8)
+                << radius << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << sortUs << std::setw(12) << kernelUs
+                << std::setw(9) << sortUs / kernelUs << "x  "
+                << (same ? "same" : "MISMATCH") << "\n";
+    }
+  }
+  return exitCode;
+}
@@ -0,0 +1,159 @@
+// Frame hand-off benchmark: bytes copied and time per frameset
+//
+// Usage: RealsenseBodyPoseFrameCopyBenchmark [frames]
+//
+// Feeds synthetic color and depth frames through an rs2::software_device (no
+// camera needed) and hands each frameset to the pipeline with exportFrame(),
+// as RealSenseCamera::captureFrames() does: in copy mode (Config::zeroCopy
+// off, the old clone() path) and in zero-copy mode, for BGR8 and RGB8 color
+// at 640x480 and 1280x720.
+
+#include "FrameMat.h"
+#include <librealsense2/rs.hpp>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+struct Result {
+  size_t bytesPerFrame = 0;
+  double usPerFrame = 0.0;
+};
+
+// The pixel buffers outlive every frame, so frames need no deleter
+void keepBuffer(void *) {}
+
+Result run(int width, int height, rs2_format colorFormat, bool zeroCopy,
+           int frames) {
+  rs2::software_device device;
+  rs2::software_sensor colorSensor = device.add_sensor("Color");
+  rs2::software_sensor depthSensor = device.add_sensor("Depth");
+
+  rs2_intrinsics intrinsics = {};
+  intrinsics.width = width;
+  intrinsics.height = height;
+  intrinsics.ppx = width / 2.0f;
+  intrinsics.ppy = height / 2.0f;
+  intrinsics.fx = intrinsics.fy = 600.0f;
+  intrinsics.model = RS2_DISTORTION_NONE;
+
+  rs2_video_stream colorStream = {RS2_STREAM_COLOR, 0, 0, width, height,
+                                  30, 3, colorFormat, intrinsics};
+  rs2_video_stream depthStream = {RS2_STREAM_DEPTH, 0, 1, width, height,
+                                  30, 2, RS2_FORMAT_Z16, intrinsics};
+  rs2::stream_profile colorProfile = colorSensor.add_video_stream(colorStream);
+  rs2::stream_profile depthProfile = depthSensor.add_video_stream(depthStream);
+
+  rs2::frame_queue colorQueue(1);
+  rs2::frame_queue depthQueue(1);
+  colorSensor.open(colorProfile);
+  depthSensor.open(depthProfile);
+  colorSensor.start(colorQueue);
+  depthSensor.start(depthQueue);
+
+  std::vector<uint8_t> colorPixels(static_cast<size_t>(width) * height * 3);
+  std::vector<uint16_t> depthPixels(static_cast<size_t>(width) * height);
+  for (size_t i = 0; i < colorPixels.size(); i++) {
+    colorPixels[i] = static_cast<uint8_t>(i * 7);
+  }
+  for (size_t i = 0; i < depthPixels.size(); i++) {
+    depthPixels[i] = static_cast<uint16_t>(500 + i % 3000);
+  }
+
+  // Held across frames like a pipeline packet, so copy mode reuses buffers
+  cv::Mat color;
+  cv::Mat depth;
+  Result result;
+  size_t bytes = 0;
+  double seconds = 0.0;
+  for (int i = 0; i < frames; i++) {
+    rs2_software_video_frame colorFrame = {};
+    colorFrame.pixels = colorPixels.data();
+    colorFrame.deleter = keepBuffer;
+    colorFrame.stride = width * 3;
+    colorFrame.bpp = 3;
+    colorFrame.timestamp = i * 33.3;
+    colorFrame.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+    colorFrame.frame_number = i;
+    colorFrame.profile = colorProfile.get();
+    colorSensor.on_video_frame(colorFrame);
+
+    rs2_software_video_frame depthFrame = colorFrame;
+    depthFrame.pixels = depthPixels.data();
+    depthFrame.stride = width * 2;
+    depthFrame.bpp = 2;
+    depthFrame.profile = depthProfile.get();
+    depthSensor.on_video_frame(depthFrame);
+
+    const rs2::video_frame colorOut = colorQueue.wait_for_frame();
+    const rs2::video_frame depthOut = depthQueue.wait_for_frame();
+
+    const auto start = std::chrono::steady_clock::now();
+    bytes += exportFrame(colorOut, CV_8UC3, zeroCopy, color);
+    bytes += exportFrame(depthOut, CV_16UC1, zeroCopy, depth);
+    seconds += std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+    // A view must still show the device buffer, untouched
+    if (zeroCopy && colorFormat == RS2_FORMAT_BGR8 &&
+        color.data != colorOut.get_data()) {
+      std::cerr << "Zero-copy color is not a view" << std::endl;
+    }
+  }
+
+  // Release the frame views before the device goes away
+  color.release();
+  depth.release();
+  colorSensor.stop();
+  depthSensor.stop();
+  colorSensor.close();
+  depthSensor.close();
+
+  result.bytesPerFrame = bytes / std::max(frames, 1);
+  result.usPerFrame = seconds * 1e6 / std::max(frames, 1);
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int frames = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 300;
+
+  struct Case {
+    int width;
+    int height;
+    rs2_format format;
+    const char *formatName;
+  };
+  const Case cases[] = {{640, 480, RS2_FORMAT_BGR8, "BGR8"},
+                        {640, 480, RS2_FORMAT_RGB8, "RGB8"},
+                        {1280, 720, RS2_FORMAT_BGR8, "BGR8"},
+                        {1280, 720, RS2_FORMAT_RGB8, "RGB8"}};
+
+  std::cout << std::left << std::setw(12) << "resolution" << std::setw(7)
+            << "color" << std::setw(11) << "mode" << std::right
+            << std::setw(14) << "bytes/frame" << std::setw(12) << "us/frame"
+            << "\n";
+  for (const Case &c : cases) {
+    for (bool zeroCopy : {false, true}) {
+      const Result r = run(c.width, c.height, c.format, zeroCopy, frames);
+      const std::string resolution =
+          std::to_string(c.width) + "x" + std::to_string(c.height);
+      std::cout << std::left << std::setw(12) << resolution << std::setw(7)
+                << c.formatName << std::setw(11)
+                << (zeroCopy ? "zero-copy" : "copy") << std::right
+                << std::setw(14) << r.bytesPerFrame << std::setw(12)
+                << std::fixed << std::setprecision(1) << r.usPerFrame << "\n";
+    }
+  }
+  return 0;
+}
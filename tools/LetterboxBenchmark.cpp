@@ -0,0 +1,82 @@
+// Preprocessing benchmark: fused LetterboxKernel vs resize + pad + blob
+//
+// Usage: RealsenseBodyPoseLetterboxBenchmark [iterations]
+//
+// Times both paths on random camera-sized images into a 640x640 network
+// input, after a warm-up run, and prints the mean time per frame.
+
+#include "LetterboxKernel.h"
+#include <opencv2/dnn.hpp>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kInputSize = 640;
+
+// PoseEstimator::preprocess() without the bookkeeping
+cv::Mat reference(const cv::Mat &image) {
+  const float scale = std::min(static_cast<float>(kInputSize) / image.cols,
+                               static_cast<float>(kInputSize) / image.rows);
+  const int newW = static_cast<int>(image.cols * scale);
+  const int newH = static_cast<int>(image.rows * scale);
+  cv::Mat resized;
+  cv::resize(image, resized, cv::Size(newW, newH));
+  cv::Mat padded = cv::Mat::zeros(kInputSize, kInputSize, CV_8UC3);
+  resized.copyTo(padded(cv::Rect((kInputSize - newW) / 2,
+                                 (kInputSize - newH) / 2, newW, newH)));
+  return cv::dnn::blobFromImage(padded, 1.0 / 255.0,
+                                cv::Size(kInputSize, kInputSize),
+                                cv::Scalar(0, 0, 0), true, false);
+}
+
+template <typename Fn> double msPerRun(int iterations, Fn fn) {
+  fn();
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int iterations = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 200;
+  const cv::Size sizes[] = {{640, 480}, {848, 480}, {1280, 720}};
+
+  std::cout << "threads: " << cv::getNumThreads() << "\n"
+            << std::left << std::setw(12) << "source" << std::right
+            << std::setw(16) << "reference ms" << std::setw(12) << "fused ms"
+            << std::setw(10) << "speedup" << "\n";
+  for (const cv::Size &size : sizes) {
+    cv::Mat image(size, CV_8UC3);
+    cv::randu(image, 0, 256);
+
+    LetterboxKernel kernel(kInputSize, kInputSize);
+    cv::Mat tensor;
+    const double referenceMs =
+        msPerRun(iterations, [&]() { tensor = reference(image); });
+    tensor.release();
+    const double fusedMs =
+        msPerRun(iterations, [&]() { kernel.run(image, tensor); });
+
+    const std::string source =
+        std::to_string(size.width) + "x" + std::to_string(size.height);
+    std::cout << std::left << std::setw(12) << source << std::right
+              << std::fixed << std::setprecision(3) << std::setw(16)
+              << referenceMs << std::setw(12) << fusedMs
+              << std::setprecision(2) << std::setw(9)
+              << referenceMs / fusedMs << "x\n";
+  }
+  return 0;
+}
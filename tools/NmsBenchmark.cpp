@@ -0,0 +1,158 @@
+// NMS benchmark: NmsEngine vs the pairwise greedy loop it replaced
+//
+// Usage: RealsenseBodyPoseNmsBenchmark [iterations]
+//
+// Random boxes, 10 to 5000 per frame, with and without the detection cap.
+// Both implementations must keep the same boxes; a mismatch is reported and
+// makes the exit code non-zero. OKS mode is timed on its own.
+
+#include "NmsEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const float kThreshold = 0.45f;
+
+struct Frame {
+  std::vector<float> scores;
+  std::vector<float> boxes;     // [x, y, w, h] per box
+  std::vector<float> keypoints; // kNumKeypoints x (x, y, confidence) per box
+};
+
+Frame makeFrame(int count, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  Frame frame;
+  frame.scores.resize(count);
+  frame.boxes.resize(count * 4);
+  frame.keypoints.resize(count * NmsEngine::kNumKeypoints * 3);
+  for (int i = 0; i < count; i++) {
+    float *box = &frame.boxes[i * 4];
+    box[0] = unit(rng) * 1100.0f;
+    box[1] = unit(rng) * 500.0f;
+    box[2] = 20.0f + unit(rng) * 180.0f;
+    box[3] = 40.0f + unit(rng) * 180.0f;
+    frame.scores[i] = unit(rng);
+    float *k = &frame.keypoints[i * NmsEngine::kNumKeypoints * 3];
+    for (int j = 0; j < NmsEngine::kNumKeypoints; j++) {
+      k[j * 3] = box[0] + unit(rng) * box[2];
+      k[j * 3 + 1] = box[1] + unit(rng) * box[3];
+      k[j * 3 + 2] = unit(rng);
+    }
+  }
+  return frame;
+}
+
+float iou(const float *a, const float *b) {
+  const float x1 = std::max(a[0], b[0]);
+  const float y1 = std::max(a[1], b[1]);
+  const float x2 = std::min(a[0] + a[2], b[0] + b[2]);
+  const float y2 = std::min(a[1] + a[3], b[1] + b[3]);
+  const float intersection =
+      std::max(0.0f, x2 - x1) * std::max(0.0f, y2 - y1);
+  const float unionArea = a[2] * a[3] + b[2] * b[3] - intersection;
+  return unionArea > 0.0f ? intersection / unionArea : 0.0f;
+}
+
+// The pre-NmsEngine applyNMS(): sort, then suppress pairwise
+std::vector<int> pairwise(const Frame &frame, int maxDetections) {
+  const int count = static_cast<int>(frame.scores.size());
+  std::vector<int> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return frame.scores[a] > frame.scores[b];
+  });
+  std::vector<bool> suppressed(count, false);
+  std::vector<int> keep;
+  for (int i = 0; i < count; i++) {
+    if (suppressed[i]) {
+      continue;
+    }
+    keep.push_back(order[i]);
+    if (maxDetections > 0 && static_cast<int>(keep.size()) >= maxDetections) {
+      break;
+    }
+    for (int j = i + 1; j < count; j++) {
+      if (!suppressed[j] && iou(&frame.boxes[order[i] * 4],
+                                &frame.boxes[order[j] * 4]) > kThreshold) {
+        suppressed[j] = true;
+      }
+    }
+  }
+  return keep;
+}
+
+const std::vector<int> &runEngine(NmsEngine &engine, const Frame &frame,
+                                  bool withKeypoints) {
+  engine.clear();
+  const int stride = NmsEngine::kNumKeypoints * 3;
+  for (size_t i = 0; i < frame.scores.size(); i++) {
+    engine.add(frame.scores[i], &frame.boxes[i * 4],
+               withKeypoints ? &frame.keypoints[i * stride] : nullptr);
+  }
+  return engine.run();
+}
+
+template <typename Fn> double usPerRun(int iterations, Fn fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         iterations;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int iterations = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 200;
+  std::mt19937 rng(42);
+  bool allMatch = true;
+
+  std::cout << std::left << std::setw(8) << "boxes" << std::setw(6) << "cap"
+            << std::right << std::setw(14) << "pairwise us" << std::setw(12)
+            << "engine us" << std::setw(10) << "speedup" << std::setw(10)
+            << "oks us" << "  result\n";
+  for (int count : {10, 100, 500, 1000, 2000, 5000}) {
+    const Frame frame = makeFrame(count, rng);
+    for (int cap : {10, 0}) {
+      NmsEngine::Config config;
+      config.threshold = kThreshold;
+      config.maxDetections = cap;
+      NmsEngine engine(config);
+      config.mode = NmsEngine::Mode::OKS;
+      NmsEngine oksEngine(config);
+
+      const bool match =
+          runEngine(engine, frame, false) == pairwise(frame, cap);
+      allMatch = allMatch && match;
+
+      // Keep the O(n^2) reference from dominating the run at 5000 boxes
+      const int slow = std::max(1, iterations * 100 / count);
+      const int runs = std::min(iterations, slow);
+      const double pairwiseUs = usPerRun(runs, [&]() { pairwise(frame, cap); });
+      const double engineUs =
+          usPerRun(iterations, [&]() { runEngine(engine, frame, false); });
+      const double oksUs =
+          usPerRun(runs, [&]() { runEngine(oksEngine, frame, true); });
+
+      std::cout << std::left << std::setw(8) << count << std::setw(6)
+                << (cap > 0 ? std::to_string(cap) : "none") << std::right
+                << std::fixed << std::setprecision(1) << std::setw(14)
+                << pairwiseUs << std::setw(12) << engineUs << std::setw(9)
+                << pairwiseUs / engineUs << "x" << std::setw(10) << oksUs
+                << "  " << (match ? "same" : "MISMATCH") << "\n";
+    }
+  }
+  return allMatch ? 0 : 1;
+}
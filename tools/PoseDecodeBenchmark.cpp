@@ -0,0 +1,95 @@
+// Pose decoding benchmark: model output -> NMS -> SkeletonBatch
+//
+// Usage: RealsenseBodyPosePoseDecodeBenchmark [iterations]
+//
+// Builds synthetic YOLOv8-Pose outputs (8400 anchors) holding 0, 10 and 100
+// people, each seen by several overlapping anchors as a real model reports
+// them, and times PoseEstimator::decode() on them. No model is loaded.
+
+#include "PoseEstimator.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kAnchors = 8400;
+const int kAnchorsPerPerson = 8;
+const int kInputSize = 640;
+
+// Background scores well under the threshold; people on a 10x10 grid of
+// 64-pixel cells, each with jittered duplicate boxes for NMS to remove
+cv::Mat makeOutput(int people, cv::RNG &rng) {
+  const int channels = kPoseOutputChannels<ActiveTopology>;
+  const int sizes[3] = {1, channels, kAnchors};
+  cv::Mat output(3, sizes, CV_32F);
+  float *data = output.ptr<float>();
+  for (int c = 0; c < channels; c++) {
+    for (int a = 0; a < kAnchors; a++) {
+      data[c * kAnchors + a] =
+          c == 4 ? rng.uniform(0.0f, 0.2f) : rng.uniform(0.0f, 640.0f);
+    }
+  }
+
+  for (int p = 0; p < people; p++) {
+    const float cx = 32.0f + 64.0f * (p % 10);
+    const float cy = 32.0f + 64.0f * ((p / 10) % 10);
+    for (int k = 0; k < kAnchorsPerPerson; k++) {
+      const int a = (p * kAnchorsPerPerson + k) * 7 % kAnchors;
+      data[0 * kAnchors + a] = cx + rng.uniform(-2.0f, 2.0f);
+      data[1 * kAnchors + a] = cy + rng.uniform(-2.0f, 2.0f);
+      data[2 * kAnchors + a] = 40.0f;
+      data[3 * kAnchors + a] = 56.0f;
+      data[4 * kAnchors + a] = rng.uniform(0.6f, 0.95f);
+      for (int j = 0; j < kNumJoints; j++) {
+        data[(5 + 3 * j) * kAnchors + a] = cx + rng.uniform(-20.0f, 20.0f);
+        data[(6 + 3 * j) * kAnchors + a] = cy + rng.uniform(-28.0f, 28.0f);
+        data[(7 + 3 * j) * kAnchors + a] = rng.uniform(0.0f, 1.0f);
+      }
+    }
+  }
+  return output;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int iterations = argc > 1 ? std::max(std::stoi(argv[1]), 1) : 2000;
+  const cv::Size imageSize(1280, 720);
+
+  std::cout << std::left << std::setw(8) << "people" << std::setw(8) << "nms"
+            << std::right << std::setw(10) << "decoded" << std::setw(12)
+            << "us/frame" << "\n";
+  for (bool oksNms : {false, true}) {
+    PoseEstimator::Config config;
+    config.inputWidth = config.inputHeight = kInputSize;
+    config.maxDetections = 100; // The batch still stops at kMaxPeople
+    config.oksNms = oksNms;
+    PoseEstimator estimator(config);
+
+    for (int people : {0, 10, 100}) {
+      cv::RNG rng(people + 1);
+      const cv::Mat output = makeOutput(people, rng);
+      SkeletonBatch skeletons;
+      estimator.decode(output, imageSize, skeletons);
+
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++) {
+        estimator.decode(output, imageSize, skeletons);
+      }
+      const double us = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start)
+                            .count() /
+                        iterations;
+      std::cout << std::left << std::setw(8) << people << std::setw(8)
+                << (oksNms ? "oks" : "iou") << std::right << std::setw(10)
+                << skeletons.size() << std::setw(12) << std::fixed
+                << std::setprecision(1) << us << "\n";
+    }
+  }
+  return 0;
+}
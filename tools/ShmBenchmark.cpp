@@ -0,0 +1,211 @@
+// Shared-memory ring against loopback UDP: publish-to-reader latency
+//
+// Usage: RealsenseBodyPoseShmBenchmark [frames] [people]
+//
+// Publishes frames of moving people at 1 kHz, once into the --shm ring
+// (SkeletonShmWriter) and once as binary packets over 127.0.0.1
+// (encodeWirePacket + UdpSocket), to a reader thread that either spins
+// (yielding between checks) or waits (SkeletonShmReader::waitForFrame(),
+// UdpSocket::waitReadable()). The reader attaches to the ring by name, as a
+// separate process would. Prints the time from just before publish() /
+// encoding to the reader holding the frame (copied out with readLatest(), or
+// decoded), as p50 / p99 / max, and the frames the reader saw. On a single
+// core the reader and the publisher time-slice, which inflates the tails.
+
+#include "SkeletonShm.h"
+#include "SkeletonShmWriter.h"
+#include "UdpSocket.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kPort = 47110;
+const char *const kRingName = "rbp_shm_benchmark";
+const int64_t kPeriodNs = 1000000; // 1 kHz
+
+enum class Transport { SHM, UDP };
+
+struct Result {
+  double p50Us = 0.0;
+  double p99Us = 0.0;
+  double maxUs = 0.0;
+  size_t seen = 0;
+  double publishNs = 0.0; // Mean cost of publish() or encode + send
+};
+
+void makeFrame(int people, int frame, SkeletonBatch &batch) {
+  batch.clear();
+  for (int p = 0; p < people; p++) {
+    const float box[4] = {40.0f * p, 50.0f, 80.0f, 200.0f};
+    const int person = batch.addPerson(0.9f, box);
+    batch.trackId[person] = p;
+    const float sway = 0.03f * std::sin(0.1f * frame + p);
+    for (int j = 0; j < kNumJoints; j++) {
+      batch.setKeypoint3D(person, j, -1.0f + 0.3f * p + 0.02f * j + sway,
+                          -0.8f + 0.1f * j, 2.5f);
+      batch.conf[j][person] = 0.8f;
+    }
+  }
+}
+
+double percentileUs(std::vector<int64_t> &ns, double q) {
+  if (ns.empty()) {
+    return 0.0;
+  }
+  const size_t k = std::min(ns.size() - 1, static_cast<size_t>(q * ns.size()));
+  std::nth_element(ns.begin(), ns.begin() + k, ns.end());
+  return ns[k] / 1000.0;
+}
+
+Result run(Transport transport, bool spin, int frames, int people) {
+  Result result;
+  std::vector<int64_t> sentNs(frames, 0);
+  std::vector<int64_t> seenNs(frames, 0);
+
+  SkeletonShmWriter::Config writerConfig;
+  writerConfig.name = kRingName;
+  SkeletonShmWriter writer(writerConfig);
+  SkeletonShmReader reader(kRingName);
+  UdpSocket sender;
+  UdpSocket receiver;
+  UdpEndpoint to;
+  if (transport == Transport::SHM) {
+    if (!writer.initialize() || !reader.attach()) {
+      std::cerr << "Cannot create the shared-memory ring" << std::endl;
+      return result;
+    }
+  } else if (!receiver.open() || !receiver.bind(kPort) || !sender.open() ||
+             !UdpEndpoint::resolve("127.0.0.1", kPort, to)) {
+    std::cerr << "Cannot open the loopback sockets" << std::endl;
+    return result;
+  }
+
+  std::atomic<bool> stop(false);
+  std::thread thread([&] {
+    std::unique_ptr<SkeletonShmFrame> frame(new SkeletonShmFrame);
+    std::vector<uint8_t> buffer(65536);
+    UdpMessage message;
+    message.buffer = buffer.data();
+    message.capacity = buffer.size();
+    WirePacket packet;
+    uint64_t seen = 0;
+    while (!stop) {
+      if (transport == Transport::SHM) {
+        const bool ready = spin ? reader.published() > seen
+                                : reader.waitForFrame(seen, 10);
+        if (!ready || !reader.readLatest(*frame)) {
+          std::this_thread::yield();
+          continue;
+        }
+        seen = frame->index + 1;
+        if (frame->frameNumber < static_cast<uint64_t>(frames)) {
+          seenNs[frame->frameNumber] = monotonicNowNs();
+        }
+        continue;
+      }
+      if (!spin && !receiver.waitReadable(10)) {
+        continue;
+      }
+      if (receiver.receiveBatch(&message, 1) == 0) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (decodeWirePacket(buffer.data(), message.size, packet) &&
+          packet.frameNumber < static_cast<uint32_t>(frames)) {
+        seenNs[packet.frameNumber] = monotonicNowNs();
+      }
+    }
+  });
+
+  SkeletonBatch batch;
+  FrameInfo info;
+  std::vector<uint8_t> packet(65536);
+  int64_t publishNs = 0;
+  int64_t next = monotonicNowNs();
+  for (int f = 0; f < frames; f++) {
+    makeFrame(people, f, batch);
+    info.frameNumber = f;
+    next += kPeriodNs;
+    while (monotonicNowNs() < next) {
+      std::this_thread::yield();
+    }
+
+    const int64_t start = monotonicNowNs();
+    sentNs[f] = start;
+    info.captureNs = start;
+    if (transport == Transport::SHM) {
+      writer.publish(batch, &info);
+    } else {
+      const size_t size = encodeWirePacket(batch, f, &info, packet.data(),
+                                           packet.size());
+      sender.sendTo(packet.data(), size, to);
+    }
+    publishNs += monotonicNowNs() - start;
+  }
+
+  // Let the reader catch the last frames
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  stop = true;
+  thread.join();
+  if (transport == Transport::SHM) {
+    reader.detach();
+    SharedMemoryRegion::remove(kRingName);
+  }
+
+  std::vector<int64_t> latencies;
+  for (int f = 0; f < frames; f++) {
+    if (seenNs[f] != 0) {
+      latencies.push_back(seenNs[f] - sentNs[f]);
+    }
+  }
+  result.seen = latencies.size();
+  result.publishNs = static_cast<double>(publishNs) / frames;
+  result.p50Us = percentileUs(latencies, 0.50);
+  result.p99Us = percentileUs(latencies, 0.99);
+  result.maxUs = percentileUs(latencies, 1.0);
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int frames = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 5000;
+  const int people =
+      argc > 2 ? std::min(std::max(std::atoi(argv[2]), 0), kMaxPeople) : 2;
+
+  std::cout << frames << " frames at 1 kHz, " << people << " people, "
+            << kNumJoints << " joints" << std::endl;
+  std::cout << std::right << std::setw(6) << "path" << std::setw(8)
+            << "reader" << std::setw(12) << "publish ns" << std::setw(10)
+            << "p50 us" << std::setw(10) << "p99 us" << std::setw(10)
+            << "max us" << std::setw(14) << "seen/sent"
+            << "\n";
+  for (Transport transport : {Transport::SHM, Transport::UDP}) {
+    for (bool spin : {true, false}) {
+      const Result r = run(transport, spin, frames, people);
+      std::cout << std::setw(6)
+                << (transport == Transport::SHM ? "shm" : "udp")
+                << std::setw(8) << (spin ? "spin" : "wait") << std::setw(12)
+                << std::fixed << std::setprecision(0) << r.publishNs
+                << std::setw(10) << std::setprecision(1) << r.p50Us
+                << std::setw(10) << r.p99Us << std::setw(10) << r.maxUs
+                << std::setw(14)
+                << (std::to_string(r.seen) + "/" + std::to_string(frames))
+                << "\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,133 @@
+// UDP socket benchmark: syscalls per frame and throughput on loopback
+//
+// Usage: RealsenseBodyPoseSocketBenchmark [frames]
+//
+// Sends frames of 1, 4 and 16 datagrams (several subscribers, or the
+// fragments of one packet) to a receiver thread on 127.0.0.1, once with
+// UdpSocket::sendBatch() (one sendmmsg() per frame on Linux, the path
+// UdpSender takes) and once with one sendTo() per datagram, and prints the
+// send syscalls per frame, frames and bytes per second, and the datagrams
+// the receiver got. The sender waits when the receiver falls behind, so the
+// numbers are for traffic the receiver keeps up with.
+
+#include "UdpSocket.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+const int kPort = 47100;
+const size_t kPayloadBytes = 600; // A binary packet of a few people
+const size_t kMaxInFlight = 2000; // Datagrams sent but not yet received
+
+struct Result {
+  double syscallsPerFrame = 0.0;
+  double framesPerSecond = 0.0;
+  double bytesPerSecond = 0.0;
+  size_t sent = 0;
+  size_t received = 0;
+};
+
+Result run(int datagramsPerFrame, bool batched, int frames) {
+  Result result;
+  UdpSocket receiver;
+  UdpSocket::Config receiverConfig;
+  receiverConfig.receiveBufferBytes = 8 << 20;
+  UdpSocket sender;
+  UdpEndpoint to;
+  if (!receiver.open(receiverConfig) || !receiver.bind(kPort) ||
+      !sender.open() || !UdpEndpoint::resolve("127.0.0.1", kPort, to)) {
+    std::cerr << "Cannot open the loopback sockets" << std::endl;
+    return result;
+  }
+
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> received(0);
+  std::thread thread([&] {
+    std::vector<char> buffers(64 * 2048);
+    UdpMessage messages[64];
+    for (int i = 0; i < 64; i++) {
+      messages[i].buffer = &buffers[i * 2048];
+      messages[i].capacity = 2048;
+    }
+    while (!stop) {
+      if (receiver.waitReadable(10)) {
+        received += static_cast<size_t>(receiver.receiveBatch(messages, 64));
+      }
+    }
+  });
+
+  std::vector<char> payload(kPayloadBytes, 'x');
+  std::vector<UdpDatagram> datagrams(datagramsPerFrame);
+  for (UdpDatagram &datagram : datagrams) {
+    datagram.data = payload.data();
+    datagram.size = payload.size();
+    datagram.to = &to;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int f = 0; f < frames; f++) {
+    if (batched) {
+      sender.sendBatch(datagrams.data(), datagramsPerFrame);
+    } else {
+      for (const UdpDatagram &datagram : datagrams) {
+        sender.sendTo(datagram.data, datagram.size, to);
+      }
+    }
+    while (sender.stats().datagrams - received > kMaxInFlight) {
+      std::this_thread::yield();
+    }
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+
+  // Let the receiver drain what is still queued
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  stop = true;
+  thread.join();
+
+  const UdpSocket::Stats stats = sender.stats();
+  result.syscallsPerFrame = static_cast<double>(stats.syscalls) / frames;
+  result.framesPerSecond = frames / seconds;
+  result.bytesPerSecond = stats.bytes / seconds;
+  result.sent = stats.datagrams;
+  result.received = received;
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const int frames = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 100000;
+
+  std::cout << std::right << std::setw(10) << "datagrams" << std::setw(10)
+            << "send" << std::setw(16) << "syscalls/frame" << std::setw(12)
+            << "frames/s" << std::setw(10) << "MB/s" << std::setw(22)
+            << "received/sent"
+            << "\n";
+  for (int datagramsPerFrame : {1, 4, 16}) {
+    for (bool batched : {true, false}) {
+      const Result r = run(datagramsPerFrame, batched, frames);
+      std::cout << std::setw(10) << datagramsPerFrame << std::setw(10)
+                << (batched ? "batch" : "sendTo") << std::setw(16)
+                << std::fixed << std::setprecision(2) << r.syscallsPerFrame
+                << std::setw(12) << std::setprecision(0) << r.framesPerSecond
+                << std::setw(10) << std::setprecision(1)
+                << r.bytesPerSecond / 1e6 << std::setw(22)
+                << (std::to_string(r.received) + "/" +
+                    std::to_string(r.sent))
+                << "\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,239 @@
+// Wire codec benchmark: packet size, encode and decode cost per format
+//
+// Usage: RealsenseBodyPoseWireBenchmark [frames] [--dump directory]
+//
+// Encodes a synthetic stream of 1, 10 and kMaxPeople moving people as the
+// JSON packet, the binary packet and the delta stream, and decodes the
+// binary and delta packets with the reference decoders. With --dump, writes
+// each stream to <directory>/<format>_<people>.bin (every packet as a
+// little-endian uint32 length and the packet bytes) for the Python decoders
+// of the ROS2 bridge: python3 ros2_bridge/decoder_benchmark.py <directory>.
+
+#include "DeltaWireFormat.h"
+#include "JsonEncoder.h"
+#include "SkeletonBatch.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace RealsenseBodyPose;
+
+namespace {
+
+// Stream runs per format; the fastest is reported
+const int kTimingRuns = 5;
+
+typedef std::vector<uint8_t> Packet;
+
+struct Result {
+  size_t packets = 0;
+  size_t bytes = 0;
+  double encodeUs = 0.0; // Per frame
+  double decodeUs = 0.0; // Per packet, negative when there is no decoder
+};
+
+// People standing in a row, swaying a few centimetres from frame to frame
+void makeFrame(int people, int frame, SkeletonBatch &batch, FrameInfo &info) {
+  batch.clear();
+  info.frameNumber = frame;
+  info.sensorTimestampMs = frame * 33.3;
+  for (int p = 0; p < people; p++) {
+    const float box[4] = {20.0f * p, 50.0f, 80.0f, 200.0f};
+    const int person = batch.addPerson(0.9f, box);
+    batch.trackId[person] = p;
+    const float sway = 0.03f * std::sin(0.1f * frame + p);
+    for (int j = 0; j < kNumJoints; j++) {
+      batch.setKeypoint3D(person, j, -2.0f + 0.15f * p + 0.02f * j + sway,
+                          -0.8f + 0.1f * j, 2.5f + 0.05f * p);
+      batch.conf[j][person] = 0.5f + 0.01f * j;
+    }
+  }
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Encode the stream kTimingRuns times; encode(frame, sequence, packet)
+// fills the packet, left empty when nothing is sent
+template <typename Encode>
+Result timeEncode(int people, int frames, std::vector<Packet> &packets,
+                  Encode encode) {
+  Result result;
+  SkeletonBatch batch;
+  FrameInfo info;
+  double best = 1e30;
+  for (int run = 0; run < kTimingRuns; run++) {
+    packets.assign(frames, Packet());
+    double us = 0.0;
+    for (int i = 0; i < frames; i++) {
+      makeFrame(people, i, batch, info);
+      const auto start = std::chrono::steady_clock::now();
+      encode(batch, info, static_cast<uint32_t>(i), packets[i]);
+      us += elapsedUs(start);
+    }
+    best = std::min(best, us / frames);
+  }
+  packets.erase(std::remove_if(packets.begin(), packets.end(),
+                               [](const Packet &p) { return p.empty(); }),
+                packets.end());
+  for (const Packet &packet : packets) {
+    result.bytes += packet.size();
+  }
+  result.packets = packets.size();
+  result.encodeUs = best;
+  return result;
+}
+
+// Decode every packet kTimingRuns times; false if a packet does not decode
+template <typename Decode>
+bool timeDecode(const std::vector<Packet> &packets, Result &result,
+                Decode decode) {
+  WirePacket decoded;
+  double best = 1e30;
+  for (int run = 0; run < kTimingRuns; run++) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const Packet &packet : packets) {
+      if (!decode(packet, decoded)) {
+        return false;
+      }
+    }
+    best = std::min(best, elapsedUs(start) /
+                              std::max<size_t>(packets.size(), 1));
+  }
+  result.decodeUs = best;
+  return true;
+}
+
+bool dump(const std::string &directory, const std::string &name, int people,
+          const std::vector<Packet> &packets) {
+  const std::string path =
+      directory + "/" + name + "_" + std::to_string(people) + ".bin";
+  std::ofstream file(path, std::ios::binary);
+  for (const Packet &packet : packets) {
+    const uint32_t size = static_cast<uint32_t>(packet.size());
+    const uint8_t length[4] = {
+        static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+        static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 24)};
+    file.write(reinterpret_cast<const char *>(length), 4);
+    file.write(reinterpret_cast<const char *>(packet.data()), size);
+  }
+  if (!file) {
+    std::cerr << "Cannot write " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void printRow(int people, const char *format, const Result &r) {
+  std::cout << std::right << std::setw(7) << people << "  " << std::left
+            << std::setw(8) << format << std::right << std::setw(9)
+            << r.packets << std::setw(14) << std::fixed
+            << std::setprecision(0)
+            << static_cast<double>(r.bytes) / std::max<size_t>(r.packets, 1)
+            << std::setw(12) << std::setprecision(2) << r.encodeUs;
+  if (r.decodeUs >= 0.0) {
+    std::cout << std::setw(12) << r.decodeUs;
+  } else {
+    std::cout << std::setw(12) << "-";
+  }
+  std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int frames = 300;
+  std::string directory;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--dump" && i + 1 < argc) {
+      directory = argv[++i];
+    } else {
+      frames = std::max(std::atoi(argv[i]), 1);
+    }
+  }
+
+  std::cout << std::right << std::setw(7) << "people" << "  " << std::left
+            << std::setw(8) << "format" << std::right << std::setw(9)
+            << "packets" << std::setw(14) << "bytes/packet" << std::setw(12)
+            << "encode us" << std::setw(12) << "decode us"
+            << "\n";
+
+  bool ok = true;
+  for (int people : {1, 10, kMaxPeople}) {
+    std::vector<Packet> packets;
+
+    JsonSkeletonEncoder json;
+    Result r = timeEncode(
+        people, frames, packets,
+        [&](const SkeletonBatch &batch, const FrameInfo &info, uint32_t,
+            Packet &out) {
+          const size_t size = json.encode(batch, &info);
+          out.assign(json.data(), json.data() + size);
+        });
+    r.decodeUs = -1.0; // Receivers parse it with their JSON library
+    printRow(people, "json", r);
+    ok = (directory.empty() || dump(directory, "json", people, packets)) && ok;
+
+    Packet buffer(std::max(kWireMaxPacketBytes, kDeltaMaxPacketBytes));
+    r = timeEncode(people, frames, packets,
+                   [&](const SkeletonBatch &batch, const FrameInfo &info,
+                       uint32_t sequence, Packet &out) {
+                     const size_t size =
+                         encodeWirePacket(batch, sequence, &info,
+                                          buffer.data(), buffer.size());
+                     out.assign(buffer.begin(), buffer.begin() + size);
+                   });
+    ok = timeDecode(packets, r,
+                    [](const Packet &packet, WirePacket &decoded) {
+                      return decodeWirePacket(packet.data(), packet.size(),
+                                              decoded);
+                    }) &&
+         ok;
+    printRow(people, "binary", r);
+    ok = (directory.empty() || dump(directory, "binary", people, packets)) &&
+         ok;
+
+    // The stream state starts over with every run, as a new subscriber
+    DeltaWireEncoder delta;
+    r = timeEncode(people, frames, packets,
+                   [&](const SkeletonBatch &batch, const FrameInfo &info,
+                       uint32_t sequence, Packet &out) {
+                     if (sequence == 0) {
+                       delta.reset();
+                     }
+                     const int64_t nowNs =
+                         static_cast<int64_t>(info.sensorTimestampMs * 1e6);
+                     const size_t size =
+                         delta.encode(batch, sequence, &info, nowNs,
+                                      buffer.data(), buffer.size());
+                     out.assign(buffer.begin(), buffer.begin() + size);
+                   });
+    DeltaWireDecoder receiver;
+    ok = timeDecode(packets, r,
+                    [&](const Packet &packet, WirePacket &decoded) {
+                      return receiver.decode(packet.data(), packet.size(),
+                                             decoded);
+                    }) &&
+         ok;
+    printRow(people, "delta", r);
+    ok = (directory.empty() || dump(directory, "delta", people, packets)) &&
+         ok;
+  }
+
+  if (!ok) {
+    std::cerr << "A packet failed to decode or to be written" << std::endl;
+  }
+  return ok ? 0 : 1;
+}